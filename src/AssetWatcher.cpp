@@ -0,0 +1,292 @@
+// File: AssetWatcher.cpp
+// Author: Duilio Pérez
+// Implementation of the asset watcher.
+#include "AssetWatcher.hpp"
+#include "AudioManager.hpp"
+#include "TextureManager.hpp"
+#include <set>
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+using namespace DPGE;
+using namespace std;
+
+// Define the instance of the asset watcher.
+AssetWatcher &DPGE::theAssetWatcher =
+  AssetWatcher::getInstance();
+
+// Split a path in its directory and its file.
+static string splitPath(
+  const string &path, string &directory)
+{
+  // The position of the last separator.
+  size_t separator = path.find_last_of('/');
+  if (separator == string::npos)
+  {
+    directory = ".";
+    return path;
+  }
+  directory = separator ? path.substr(0, separator) : "/";
+  return path.substr(separator + 1);
+}
+
+// Register the file of an asset.
+void AssetWatcher::watch(const string &path,
+  const AssetType &type, const string &name)
+{
+  // The directory of the file.
+  string directory;
+  // The file.
+  string file = splitPath(path, directory);
+  this->unwatch(type, name);
+  this->assets[directory + '/' + file].push_back(
+    {type, name});
+  if (this->descriptor >= 0)
+    this->addDirectory(directory);
+}
+
+// Forget the file of an asset.
+void AssetWatcher::unwatch(
+  const AssetType &type, const string &name)
+{
+  for (auto file = this->assets.begin();
+       file != this->assets.end();)
+  {
+    for (auto asset = file->second.begin();
+         asset != file->second.end();)
+      if (asset->type == type && asset->name == name)
+        asset = file->second.erase(asset);
+      else
+        asset++;
+    if (file->second.empty())
+      file = this->assets.erase(file);
+    else
+      file++;
+  }
+}
+
+// Forget the files of the assets of a kind.
+void AssetWatcher::unwatchAll(const AssetType &type)
+{
+  for (auto file = this->assets.begin();
+       file != this->assets.end();)
+  {
+    for (auto asset = file->second.begin();
+         asset != file->second.end();)
+      if (asset->type == type)
+        asset = file->second.erase(asset);
+      else
+        asset++;
+    if (file->second.empty())
+      file = this->assets.erase(file);
+    else
+      file++;
+  }
+}
+
+// Start watching the files.
+bool AssetWatcher::start()
+{
+  // The directory of a file.
+  string directory;
+  if (this->descriptor >= 0)
+    return true;
+#ifdef __linux__
+  this->descriptor =
+    inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+  if (this->descriptor < 0)
+  {
+    SDL_LogError(SDL_LOG_CATEGORY_ERROR,
+      "Can't watch the assets: inotify failed.\n");
+    return false;
+  }
+  for (auto &file : this->assets)
+  {
+    splitPath(file.first, directory);
+    this->addDirectory(directory);
+  }
+  return true;
+#else
+  SDL_LogError(SDL_LOG_CATEGORY_ERROR,
+    "Can't watch the assets: It needs inotify, only "
+    "available on Linux.\n");
+  return false;
+#endif
+}
+
+// Stop watching the files.
+void AssetWatcher::stop()
+{
+#ifdef __linux__
+  if (this->descriptor >= 0)
+    close(this->descriptor);
+#endif
+  this->descriptor = -1;
+  this->directories.clear();
+  this->watches.clear();
+  this->lostDirectories.clear();
+}
+
+// Query if the watcher is started.
+bool AssetWatcher::isStarted()
+{
+  return this->descriptor >= 0;
+}
+
+// Reload the assets whose files changed.
+void AssetWatcher::poll()
+{
+#ifdef __linux__
+  // The read events.
+  alignas(inotify_event) char buffer[4096];
+  // The number of read bytes.
+  ssize_t length = 0;
+  // An event.
+  const inotify_event *event = nullptr;
+  // The changed files, reloaded once.
+  set<string> changed;
+  // The watch of an event.
+  map<int, vector<string>>::iterator watch;
+  // The directory of a file.
+  string directory;
+  // The files of a lost directory.
+  vector<string> files;
+  if (this->descriptor < 0)
+    return;
+  while ((length = read(this->descriptor, buffer,
+            sizeof(buffer))) > 0)
+    for (char *position = buffer;
+         position < buffer + length;
+         position += sizeof(inotify_event) + event->len)
+    {
+      event =
+        reinterpret_cast<const inotify_event *>(position);
+      // Lost events, reload everything.
+      if (event->mask & IN_Q_OVERFLOW)
+        for (auto &file : this->assets)
+          changed.insert(file.first);
+      else if ((watch = this->watches.find(event->wd)) ==
+               this->watches.end())
+        continue;
+      // The directory was deleted, it's watched again
+      // when it's created.
+      else if (event->mask & IN_IGNORED)
+      {
+        for (const string &spelling : watch->second)
+        {
+          this->directories.erase(spelling);
+          this->lostDirectories.insert(spelling);
+        }
+        this->watches.erase(watch);
+      }
+      // A directory can have several spellings, like
+      // "assets" and "./assets", with the same watch.
+      else if (event->len)
+        for (const string &spelling : watch->second)
+          changed.insert(spelling + '/' + event->name);
+    }
+  // The lost directories are looked for once per second.
+  if (!this->lostDirectories.empty() &&
+      SDL_GetTicks64() - this->lastSearch >= 1000)
+  {
+    this->lastSearch = SDL_GetTicks64();
+    for (const string &lost :
+         set<string>(this->lostDirectories))
+    {
+      files.clear();
+      for (auto &file : this->assets)
+      {
+        splitPath(file.first, directory);
+        if (directory == lost)
+          files.push_back(file.first);
+      }
+      // The directories without assets are forgotten, and
+      // the files of the found ones are new.
+      if (files.empty())
+        this->lostDirectories.erase(lost);
+      else if (this->addDirectory(lost))
+        changed.insert(files.begin(), files.end());
+    }
+  }
+  for (const string &path : changed)
+  {
+    // The assets are copied, a reload can change them.
+    auto file = this->assets.find(path);
+    if (file == this->assets.end())
+      continue;
+    for (const Asset &asset : vector<Asset>(file->second))
+      this->reload(path, asset);
+  }
+#endif
+}
+
+// Get the instance of the class.
+AssetWatcher &AssetWatcher::getInstance()
+{
+  static AssetWatcher theInstance;
+  return theInstance;
+}
+
+// Destructor.
+AssetWatcher::~AssetWatcher()
+{
+  this->stop();
+}
+
+// Watch the changes in a directory.
+bool AssetWatcher::addDirectory(const string &directory)
+{
+#ifdef __linux__
+  // The watch of the directory.
+  int watch = 0;
+  if (this->directories.count(directory))
+    return true;
+  // Editors usually write a new file and move it over the
+  // old one, so the directory is watched.
+  watch = inotify_add_watch(this->descriptor,
+    directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO);
+  // A missing directory is watched when it's created.
+  if (watch < 0)
+  {
+    if (!this->lostDirectories.count(directory))
+      SDL_LogWarn(SDL_LOG_CATEGORY_ERROR,
+        "Can't watch the directory %s.\n",
+        directory.c_str());
+    this->lostDirectories.insert(directory);
+    return false;
+  }
+  this->lostDirectories.erase(directory);
+  this->directories[directory] = watch;
+  this->watches[watch].push_back(directory);
+  return true;
+#else
+  (void)directory;
+  return false;
+#endif
+}
+
+// Reload an asset.
+void AssetWatcher::reload(
+  const string &path, const Asset &asset)
+{
+  // Indicator to know if the asset was reloaded.
+  bool reloaded = false;
+  switch (asset.type)
+  {
+  case AssetType::TEXTURE:
+    reloaded = theTextureManager.reload(asset.name);
+    break;
+  case AssetType::FONT:
+    reloaded = theTextureManager.reloadFont();
+    break;
+  case AssetType::MUSIC:
+    reloaded = theAudioManager.reloadMusic(asset.name);
+    break;
+  case AssetType::SOUND:
+    reloaded = theAudioManager.reloadSound(asset.name);
+    break;
+  }
+  if (reloaded)
+    SDL_Log("Reloaded %s.", path.c_str());
+}
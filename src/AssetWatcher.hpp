@@ -0,0 +1,119 @@
+/// @file AssetWatcher.hpp
+/// @author Duilio Pérez
+/// @brief A watcher that reloads the changed assets.
+#ifndef ASSETWATCHER_HPP
+#define ASSETWATCHER_HPP true
+#include <SDL2/SDL.h>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace DPGE
+{
+
+  /// @brief The kinds of assets that can be reloaded.
+  enum struct AssetType : unsigned
+  {
+    /// @brief A texture of the texture manager.
+    TEXTURE,
+    /// @brief The font of the texture manager.
+    FONT,
+    /// @brief A music of the audio manager.
+    MUSIC,
+    /// @brief A sound of the audio manager.
+    SOUND
+  };
+
+  /// @brief A watcher of the files of the loaded assets.
+  ///
+  /// The managers register the files they load. When the
+  /// watcher is started, a changed file is decoded again
+  /// and replaced in its manager with the same name, so
+  /// the rest of the session is kept. It uses inotify, so
+  /// it only works on Linux.
+  class AssetWatcher final
+  {
+  public:
+    /// @brief Copy constructor deleted.
+    AssetWatcher(const AssetWatcher &) = delete;
+    /// @brief Register the file of an asset.
+    /// @param path The path of the file.
+    /// @param type The kind of asset.
+    /// @param name The name of the asset in its manager.
+    void watch(const std::string &path,
+      const AssetType &type, const std::string &name);
+    /// @brief Forget the file of an asset.
+    /// @param type The kind of asset.
+    /// @param name The name of the asset in its manager.
+    void unwatch(
+      const AssetType &type, const std::string &name);
+    /// @brief Forget the files of all the assets of a
+    /// kind.
+    /// @param type The kind of asset.
+    void unwatchAll(const AssetType &type);
+    /// @brief Start watching the registered files.
+    /// @return true in success, false otherwise.
+    bool start();
+    /// @brief Stop watching the files.
+    void stop();
+    /// @brief Query if the watcher is started.
+    /// @return true if it's started.
+    bool isStarted();
+    /// @brief Reload the assets whose files changed.
+    ///
+    /// The game calls it before handling the events of
+    /// every frame, when no draws are pending.
+    void poll();
+    /// @brief Get the instance of the class.
+    static AssetWatcher &getInstance();
+    /// @brief Copy operator deleted.
+    const AssetWatcher &operator=(
+      const AssetWatcher &) = delete;
+
+  private:
+    /// @brief An asset loaded from a file.
+    struct Asset
+    {
+      /// @brief The kind of asset.
+      AssetType type;
+      /// @brief The name of the asset in its manager.
+      std::string name;
+    };
+    /// @brief Default constructor.
+    AssetWatcher() = default;
+    /// @brief Destructor, it stops watching.
+    ~AssetWatcher();
+    /// @brief Watch the changes in a directory.
+    /// @param directory The directory.
+    /// @return true if it's watched, false if it's lost.
+    bool addDirectory(const std::string &directory);
+    /// @brief Reload an asset.
+    /// @param path The path of the file of the asset.
+    /// @param asset The asset.
+    void reload(
+      const std::string &path, const Asset &asset);
+    /// @brief The assets of every file, with the file path
+    /// as directory/file.
+    std::map<std::string, std::vector<Asset>> assets;
+    /// @brief The watched directories and their watches.
+    std::map<std::string, int> directories;
+    /// @brief The directories of every watch, with all
+    /// the spellings of the paths of the assets.
+    std::map<int, std::vector<std::string>> watches;
+    /// @brief The directories that can't be watched, like
+    /// the deleted ones.
+    std::set<std::string> lostDirectories;
+    /// @brief The time of the last search of the lost
+    /// directories.
+    Uint64 lastSearch = 0;
+    /// @brief The inotify descriptor, -1 when stopped.
+    int descriptor = -1;
+  };
+
+  /// @brief The asset watcher instance.
+  extern AssetWatcher &theAssetWatcher;
+
+} // namespace DPGE
+
+#endif
@@ -2,6 +2,7 @@
 // Author: Duilio Pérez
 // Implementation of the audio manager.
 #include "AudioManager.hpp"
+#include "AssetWatcher.hpp"
 #include <SDL2/SDL.h>
 #include <SDL2/SDL_mixer.h>
 #include <algorithm>
@@ -29,6 +30,9 @@ bool AudioManager::loadMusic(
   }
   // Add the name to the class' vector.
   this->musicNames.push_back(name);
+  // Remember the file to reload it when it changes.
+  this->musicFiles[name] = file;
+  theAssetWatcher.watch(file, AssetType::MUSIC, name);
   // Set the number distribution.
   if (!this->music.empty())
     this->distribution = uniform_int_distribution<size_t>(
@@ -52,6 +56,9 @@ bool AudioManager::loadSound(
     this->soundEffects.erase(name);
     return false;
   }
+  // Remember the file to reload it when it changes.
+  this->soundFiles[name] = file;
+  theAssetWatcher.watch(file, AssetType::SOUND, name);
   return true;
 }
 
@@ -63,9 +70,13 @@ void AudioManager::playMusic(const string &name)
     if (!this->music.empty())
       // Play the music if is in its map.
       if (this->music.find(name) != this->music.cend())
+      {
         if (Mix_PlayMusic(this->music[name], 0) < 0)
           SDL_LogError(SDL_LOG_CATEGORY_ERROR,
             "Error playing a music: %s.\n", Mix_GetError());
+        else
+          this->playedMusic = name;
+      }
 }
 
 // Play a random music.
@@ -80,11 +91,15 @@ void AudioManager::playMusic()
   // Play a random music if is not playing.
   if (!Mix_PlayingMusic())
     if (!this->music.empty())
+    {
       if (Mix_PlayMusic(
             this->music[this->musicNames[musicIndex]], 0) <
           0)
         SDL_LogError(SDL_LOG_CATEGORY_ERROR,
           "Error playing a music: %s.\n", Mix_GetError());
+      else
+        this->playedMusic = this->musicNames[musicIndex];
+    }
 }
 
 // Play a sound.
@@ -101,6 +116,56 @@ void AudioManager::playSound(const string &name)
           Mix_GetError());
 }
 
+// Reload a music from its file.
+bool AudioManager::reloadMusic(const string &name)
+{
+  // The file of the music.
+  auto file = this->musicFiles.find(name);
+  // The reloaded music.
+  Mix_Music *reloaded = nullptr;
+  // Indicator to know if the music was playing.
+  bool playing = false;
+  if (file == this->musicFiles.end())
+    return false;
+  reloaded = Mix_LoadMUS(file->second.c_str());
+  if (!reloaded)
+  {
+    SDL_LogError(SDL_LOG_CATEGORY_ERROR,
+      "Error reloading a music: %s.\n", Mix_GetError());
+    return false;
+  }
+  playing = Mix_PlayingMusic() && this->playedMusic == name;
+  // Freeing a playing music stops it.
+  Mix_FreeMusic(this->music[name]);
+  this->music[name] = reloaded;
+  if (playing && Mix_PlayMusic(reloaded, 0) < 0)
+    SDL_LogError(SDL_LOG_CATEGORY_ERROR,
+      "Error playing a music: %s.\n", Mix_GetError());
+  return true;
+}
+
+// Reload a sound effect from its file.
+bool AudioManager::reloadSound(const string &name)
+{
+  // The file of the sound.
+  auto file = this->soundFiles.find(name);
+  // The reloaded sound.
+  Mix_Chunk *reloaded = nullptr;
+  if (file == this->soundFiles.end())
+    return false;
+  reloaded = Mix_LoadWAV(file->second.c_str());
+  if (!reloaded)
+  {
+    SDL_LogError(SDL_LOG_CATEGORY_ERROR,
+      "Error reloading a sound: %s.\n", Mix_GetError());
+    return false;
+  }
+  // Freeing a playing sound stops its channels.
+  Mix_FreeChunk(this->soundEffects[name]);
+  this->soundEffects[name] = reloaded;
+  return true;
+}
+
 // Erase a music.
 void AudioManager::eraseMusic(const std::string &name)
 {
@@ -111,6 +176,8 @@ void AudioManager::eraseMusic(const std::string &name)
     Mix_FreeMusic(it->second);
     // Erase it from the map.
     this->music.erase(it);
+    this->musicFiles.erase(name);
+    theAssetWatcher.unwatch(AssetType::MUSIC, name);
     auto element = std::find(this->musicNames.begin(),
       this->musicNames.end(), name);
     if (element != this->musicNames.end())
@@ -135,6 +202,8 @@ void AudioManager::eraseSound(const string &name)
     Mix_FreeChunk(this->soundEffects[name]);
   // Delete its reference.
   this->soundEffects.erase(name);
+  this->soundFiles.erase(name);
+  theAssetWatcher.unwatch(AssetType::SOUND, name);
 }
 
 // Clear all the music and sounds.
@@ -151,6 +220,11 @@ void AudioManager::clear()
   // Clear the music's map and vector.
   this->music.clear();
   this->musicNames.clear();
+  // Stop watching their files.
+  this->musicFiles.clear();
+  this->soundFiles.clear();
+  theAssetWatcher.unwatchAll(AssetType::MUSIC);
+  theAssetWatcher.unwatchAll(AssetType::SOUND);
 }
 
 // Get the class' instance.
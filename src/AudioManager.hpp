@@ -48,6 +48,20 @@ namespace DPGE
     /// @brief Play a sound stored in RAM.
     /// @param name The sound's name.
     void playSound(const std::string &name);
+    /// @brief Load again a music from its file, keeping its
+    /// name.
+    /// @param name The name of the music.
+    /// @return true in success, false otherwise.
+    ///
+    /// If the music was playing, it starts again.
+    bool reloadMusic(const std::string &name);
+    /// @brief Load again a sound from its file, keeping its
+    /// name.
+    /// @param name The name of the sound.
+    /// @return true in success, false otherwise.
+    ///
+    /// The channels playing the old sound are stopped.
+    bool reloadSound(const std::string &name);
     /// @brief Erase an audio stream.
     /// @param name The audio's name.
     void eraseMusic(const std::string &name);
@@ -71,6 +85,12 @@ namespace DPGE
     std::map<std::string, Mix_Music *> music;
     /// @brief The game's sound effects.
     std::map<std::string, Mix_Chunk *> soundEffects;
+    /// @brief The files of the musics.
+    std::map<std::string, std::string> musicFiles;
+    /// @brief The files of the sound effects.
+    std::map<std::string, std::string> soundFiles;
+    /// @brief The name of the last played music.
+    std::string playedMusic;
     /// @brief Random numbers engine.
     std::default_random_engine engine{
       static_cast<unsigned>(time(nullptr))};
@@ -0,0 +1,452 @@
+// File: BitmapFont.cpp
+// Author: Duilio Pérez
+// Implementation of the bitmap font.
+#include "BitmapFont.hpp"
+#include "TextLayout.hpp"
+#include "TextureManager.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+using namespace DPGE;
+using namespace std;
+
+// Read a little endian 16 bits integer.
+static Uint16 read16(const Uint8 *data)
+{
+  return static_cast<Uint16>(data[0] | data[1] << 8);
+}
+
+// Read a little endian 32 bits integer.
+static Uint32 read32(const Uint8 *data)
+{
+  return static_cast<Uint32>(data[0]) |
+         static_cast<Uint32>(data[1]) << 8 |
+         static_cast<Uint32>(data[2]) << 16 |
+         static_cast<Uint32>(data[3]) << 24;
+}
+
+// Join two code points in the key of a kerning pair.
+static Uint64 joinPair(Uint32 first, Uint32 second)
+{
+  return static_cast<Uint64>(first) << 32 | second;
+}
+
+// Split a line of a text descriptor in its tag and its
+// values.
+static void parseLine(const char *line, const char *end,
+  string &tag, unordered_map<string, string> &values)
+{
+  // The start of a key or a value.
+  const char *start = nullptr;
+  // The key of a value.
+  string key;
+  values.clear();
+  while (line < end && *line == ' ')
+    line++;
+  start = line;
+  while (line < end && *line != ' ')
+    line++;
+  tag.assign(start, line);
+  while (line < end)
+  {
+    while (line < end && *line == ' ')
+      line++;
+    start = line;
+    while (line < end && *line != '=' && *line != ' ')
+      line++;
+    key.assign(start, line);
+    if (line >= end || *line != '=')
+      continue;
+    line++;
+    // The values with spaces are quoted.
+    if (line < end && *line == '"')
+    {
+      start = ++line;
+      while (line < end && *line != '"')
+        line++;
+      values[key].assign(start, line);
+      if (line < end)
+        line++;
+    }
+    else
+    {
+      start = line;
+      while (line < end && *line != ' ')
+        line++;
+      values[key].assign(start, line);
+    }
+  }
+}
+
+// Get an integer value of a line of a text descriptor.
+static int getInteger(
+  const unordered_map<string, string> &values,
+  const char *key)
+{
+  // The value.
+  auto value = values.find(key);
+  if (value == values.end())
+    return 0;
+  return static_cast<int>(
+    strtol(value->second.c_str(), nullptr, 10));
+}
+
+// Default constructor.
+BitmapFont::BitmapFont() = default;
+
+// Constructor.
+BitmapFont::BitmapFont(const string &path)
+{
+  this->load(path);
+}
+
+// Destructor.
+BitmapFont::~BitmapFont()
+{
+  this->unload();
+}
+
+// Load a font.
+bool BitmapFont::load(const string &path)
+{
+  // The size of the descriptor.
+  size_t size = 0;
+  // The contents of the descriptor.
+  char *data =
+    static_cast<char *>(SDL_LoadFile(path.c_str(), &size));
+  // The files of the pages.
+  vector<string> pages;
+  // The directory of the descriptor.
+  string directory =
+    path.substr(0, path.find_last_of("/\\") + 1);
+  // The name of the texture of a page.
+  char name[96];
+  // Indicator to know if the descriptor is valid.
+  bool valid = false;
+  if (!data)
+  {
+    SDL_LogError(SDL_LOG_CATEGORY_ERROR,
+      "Can't load a bitmap font: %s.\n", SDL_GetError());
+    return false;
+  }
+  this->unload();
+  if (size >= 4 && memcmp(data, "BMF", 3) == 0)
+    valid = this->parseBinary(
+      reinterpret_cast<const Uint8 *>(data), size, pages);
+  else
+    valid = this->parseText(data, size, pages);
+  SDL_free(data);
+  if (!valid)
+  {
+    SDL_LogError(SDL_LOG_CATEGORY_ERROR,
+      "Invalid bitmap font %s.\n", path.c_str());
+    this->unload();
+    return false;
+  }
+  for (size_t i = 0; i < pages.size(); i++)
+  {
+    snprintf(name, sizeof(name), "DPGE::BitmapFont:%p:%zu",
+      static_cast<void *>(this), i);
+    if (!theTextureManager.loadFromFile(
+          name, directory + pages[i]))
+    {
+      this->unload();
+      return false;
+    }
+    this->pageNames.push_back(name);
+  }
+  this->batches.resize(this->pageNames.size());
+  this->setColor(this->color);
+  return true;
+}
+
+// Query if a font is loaded.
+bool BitmapFont::isLoaded() const
+{
+  return !this->pageNames.empty();
+}
+
+// Get the distance between lines.
+int BitmapFont::getLineHeight() const
+{
+  return this->lineHeight;
+}
+
+// Get the distance to the base of the glyphs.
+int BitmapFont::getBase() const
+{
+  return this->base;
+}
+
+// Set the color of the text.
+void BitmapFont::setColor(const SDL_Color &textColor)
+{
+  this->color = textColor;
+  for (const string &page : this->pageNames)
+  {
+    theTextureManager.setColorMod(
+      page, textColor.r, textColor.g, textColor.b);
+    theTextureManager.setAlphaMod(page, textColor.a);
+  }
+}
+
+// Get the color of the text.
+const SDL_Color &BitmapFont::getColor() const
+{
+  return this->color;
+}
+
+// Measure a text.
+SDL_Point BitmapFont::measure(
+  const string &text, float scale) const
+{
+  // The size of the text.
+  SDL_Point size = {0, 0};
+  // The position of the next code point.
+  size_t next = 0;
+  // The code point being measured.
+  Uint32 codepoint = 0;
+  // The previous code point of the line.
+  Uint32 previous = 0;
+  // The width of the line.
+  int width = 0;
+  // The number of lines.
+  int lines = 1;
+  // The glyph of the code point.
+  unordered_map<Uint32, Glyph>::const_iterator glyph;
+  for (size_t offset = 0; offset < text.size();
+       offset = next)
+  {
+    codepoint = decodeUTF8(text, offset, next);
+    if (codepoint == '\n')
+    {
+      size.x   = max(size.x, width);
+      width    = 0;
+      previous = 0;
+      lines++;
+      continue;
+    }
+    glyph = this->glyphs.find(codepoint);
+    if (glyph == this->glyphs.end())
+      continue;
+    width += this->getKerning(previous, codepoint) +
+             glyph->second.xAdvance;
+    previous = codepoint;
+  }
+  size.x = static_cast<int>(max(size.x, width) * scale);
+  size.y =
+    static_cast<int>(lines * this->lineHeight * scale);
+  return size;
+}
+
+// Render a text.
+bool BitmapFont::render(
+  const string &text, float x, float y, float scale)
+{
+  // The position of the next code point.
+  size_t next = 0;
+  // The code point being drawn.
+  Uint32 codepoint = 0;
+  // The previous code point of the line.
+  Uint32 previous = 0;
+  // The position of the pen.
+  float penX = x, penY = y;
+  // Indicator to know if all the pages were drawn.
+  bool drawn = true;
+  // The glyph of the code point.
+  const Glyph *glyph = nullptr;
+  // The glyphs by code point.
+  unordered_map<Uint32, Glyph>::const_iterator found;
+  for (SpriteBatch &batch : this->batches)
+    batch.clear();
+  for (size_t offset = 0; offset < text.size();
+       offset = next)
+  {
+    codepoint = decodeUTF8(text, offset, next);
+    if (codepoint == '\n')
+    {
+      penX = x;
+      penY += this->lineHeight * scale;
+      previous = 0;
+      continue;
+    }
+    found = this->glyphs.find(codepoint);
+    if (found == this->glyphs.end())
+      continue;
+    glyph = &found->second;
+    penX += this->getKerning(previous, codepoint) * scale;
+    if (glyph->src.w > 0 && glyph->src.h > 0 &&
+        static_cast<size_t>(glyph->page) <
+          this->batches.size())
+      this->batches[glyph->page].add(&glyph->src,
+        {penX + glyph->xOffset * scale,
+          penY + glyph->yOffset * scale,
+          glyph->src.w * scale, glyph->src.h * scale});
+    penX += glyph->xAdvance * scale;
+    previous = codepoint;
+  }
+  for (size_t i = 0; i < this->batches.size(); i++)
+    if (this->batches[i].getSize() &&
+        !this->batches[i].draw(this->pageNames[i]))
+      drawn = false;
+  return drawn;
+}
+
+// Read a descriptor in the text format.
+bool BitmapFont::parseText(
+  const char *data, size_t size, vector<string> &pages)
+{
+  // The end of the descriptor.
+  const char *end = data + size;
+  // The end of a line.
+  const char *lineEnd = nullptr;
+  // The tag of a line.
+  string tag;
+  // The values of a line.
+  unordered_map<string, string> values;
+  // The number of a page.
+  int page = 0;
+  while (data < end)
+  {
+    lineEnd = find(data, end, '\n');
+    // The carriage return isn't part of the values.
+    parseLine(data,
+      lineEnd > data && lineEnd[-1] == '\r' ? lineEnd - 1
+                                            : lineEnd,
+      tag, values);
+    data = lineEnd < end ? lineEnd + 1 : end;
+    if (tag == "common")
+    {
+      this->lineHeight = getInteger(values, "lineHeight");
+      this->base       = getInteger(values, "base");
+    }
+    else if (tag == "page")
+    {
+      page = getInteger(values, "id");
+      if (page < 0 || page > 255)
+        return false;
+      if (pages.size() <= static_cast<size_t>(page))
+        pages.resize(page + 1);
+      pages[page] = values["file"];
+    }
+    else if (tag == "char")
+      this->glyphs[static_cast<Uint32>(
+        getInteger(values, "id"))] = {
+        {getInteger(values, "x"), getInteger(values, "y"),
+          getInteger(values, "width"),
+          getInteger(values, "height")},
+        getInteger(values, "xoffset"),
+        getInteger(values, "yoffset"),
+        getInteger(values, "xadvance"),
+        getInteger(values, "page")};
+    else if (tag == "kerning")
+      this->kernings[joinPair(
+        static_cast<Uint32>(getInteger(values, "first")),
+        static_cast<Uint32>(
+          getInteger(values, "second")))] =
+        getInteger(values, "amount");
+  }
+  return this->lineHeight > 0 && !pages.empty();
+}
+
+// Read a descriptor in the binary format.
+bool BitmapFont::parseBinary(
+  const Uint8 *data, size_t size, vector<string> &pages)
+{
+  // The position of the next block.
+  size_t offset = 4;
+  // The type of a block.
+  Uint8 type = 0;
+  // The size of a block.
+  size_t blockSize = 0;
+  // The contents of a block.
+  const Uint8 *block = nullptr;
+  // A record of a block.
+  const Uint8 *record = nullptr;
+  // The length of the name of a page.
+  size_t length = 0;
+  // Only the version 3 is supported.
+  if (data[3] != 3)
+    return false;
+  while (offset + 5 <= size)
+  {
+    type      = data[offset];
+    blockSize = read32(data + offset + 1);
+    offset += 5;
+    if (blockSize > size - offset)
+      return false;
+    block = data + offset;
+    switch (type)
+    {
+    case 2:
+      if (blockSize < 4)
+        return false;
+      this->lineHeight = read16(block);
+      this->base       = read16(block + 2);
+      break;
+    case 3:
+      for (size_t i = 0; i < blockSize; i += length + 1)
+      {
+        length = strnlen(
+          reinterpret_cast<const char *>(block + i),
+          blockSize - i);
+        pages.emplace_back(
+          reinterpret_cast<const char *>(block + i),
+          length);
+      }
+      break;
+    case 4:
+      for (size_t i = 0; i + 20 <= blockSize; i += 20)
+      {
+        record                      = block + i;
+        this->glyphs[read32(record)] = {
+          {read16(record + 4), read16(record + 6),
+            read16(record + 8), read16(record + 10)},
+          static_cast<Sint16>(read16(record + 12)),
+          static_cast<Sint16>(read16(record + 14)),
+          static_cast<Sint16>(read16(record + 16)),
+          record[18]};
+      }
+      break;
+    case 5:
+      for (size_t i = 0; i + 10 <= blockSize; i += 10)
+      {
+        record = block + i;
+        this->kernings[joinPair(
+          read32(record), read32(record + 4))] =
+          static_cast<Sint16>(read16(record + 8));
+      }
+      break;
+    }
+    offset += blockSize;
+  }
+  return this->lineHeight > 0 && !pages.empty();
+}
+
+// Get the kerning between two glyphs.
+int BitmapFont::getKerning(
+  Uint32 first, Uint32 second) const
+{
+  // The kerning pair.
+  unordered_map<Uint64, int>::const_iterator pair;
+  if (!first)
+    return 0;
+  pair = this->kernings.find(joinPair(first, second));
+  if (pair == this->kernings.end())
+    return 0;
+  return pair->second;
+}
+
+// Erase the pages and the glyphs.
+void BitmapFont::unload()
+{
+  for (const string &page : this->pageNames)
+    theTextureManager.erase(page);
+  this->pageNames.clear();
+  this->batches.clear();
+  this->glyphs.clear();
+  this->kernings.clear();
+  this->lineHeight = 0;
+  this->base       = 0;
+}
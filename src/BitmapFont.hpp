@@ -0,0 +1,129 @@
+/// @file BitmapFont.hpp
+/// @author Duilio Pérez
+/// @brief Fonts with prerendered glyphs.
+#ifndef BITMAPFONT_HPP
+#define BITMAPFONT_HPP true
+#include "SpriteBatch.hpp"
+#include <SDL2/SDL.h>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace DPGE
+{
+
+  /// @brief A font with its glyphs prerendered in images,
+  /// in the AngelCode BMFont format.
+  ///
+  /// The descriptor can be in the text or the binary
+  /// format, and its pages are loaded as textures by the
+  /// texture manager, so the text is drawn without
+  /// rasterizing glyphs. The glyphs of a text are drawn
+  /// with a sprite batch for every page, with the kerning
+  /// pairs of the font.
+  class BitmapFont final
+  {
+  public:
+    /// @brief Default constructor.
+    BitmapFont();
+    /// @brief Constructor.
+    /// @param path The path of the descriptor.
+    explicit BitmapFont(const std::string &path);
+    /// @brief Copy constructor deleted.
+    BitmapFont(const BitmapFont &) = delete;
+    /// @brief Destructor, it erases the pages.
+    ~BitmapFont();
+    /// @brief Load a font.
+    /// @param path The path of the descriptor, the images
+    /// of the pages are searched in its directory.
+    /// @return true in success, false otherwise.
+    bool load(const std::string &path);
+    /// @brief Query if a font is loaded.
+    /// @return true if it's loaded.
+    bool isLoaded() const;
+    /// @brief Get the distance between lines.
+    /// @return The distance in pixels.
+    int getLineHeight() const;
+    /// @brief Get the distance from the top of a line to
+    /// the base of the glyphs.
+    /// @return The distance in pixels.
+    int getBase() const;
+    /// @brief Set the color of the text.
+    /// @param textColor The color, it modulates the pages.
+    void setColor(const SDL_Color &textColor);
+    /// @brief Get the color of the text.
+    /// @return The color of the text.
+    const SDL_Color &getColor() const;
+    /// @brief Measure a text.
+    /// @param text The utf-8 text.
+    /// @param scale The scale of the glyphs.
+    /// @return The width of the widest line and the height
+    /// of the lines.
+    SDL_Point measure(
+      const std::string &text, float scale = 1) const;
+    /// @brief Render a text.
+    /// @param text The utf-8 text, the lines are broken at
+    /// newlines.
+    /// @param x The x coordinate.
+    /// @param y The y coordinate.
+    /// @param scale The scale of the glyphs.
+    /// @return true in success, false otherwise.
+    bool render(const std::string &text, float x, float y,
+      float scale = 1);
+    /// @brief Copy operator deleted.
+    const BitmapFont &operator=(
+      const BitmapFont &) = delete;
+
+  private:
+    /// @brief A glyph of the font.
+    struct Glyph
+    {
+      /// @brief The area of the glyph in its page.
+      SDL_Rect src;
+      /// @brief The offset from the pen to draw it.
+      int xOffset, yOffset;
+      /// @brief The advance of the pen.
+      int xAdvance;
+      /// @brief The page of the glyph.
+      int page;
+    };
+    /// @brief Read a descriptor in the text format.
+    /// @param data The contents of the file.
+    /// @param size The size of the contents.
+    /// @param pages Where the files of the pages are saved.
+    /// @return true in success, false otherwise.
+    bool parseText(const char *data, size_t size,
+      std::vector<std::string> &pages);
+    /// @brief Read a descriptor in the binary format.
+    /// @param data The contents of the file.
+    /// @param size The size of the contents.
+    /// @param pages Where the files of the pages are saved.
+    /// @return true in success, false otherwise.
+    bool parseBinary(const Uint8 *data, size_t size,
+      std::vector<std::string> &pages);
+    /// @brief Get the kerning between two glyphs.
+    /// @param first The code point of the first glyph.
+    /// @param second The code point of the second glyph.
+    /// @return The kerning in pixels.
+    int getKerning(Uint32 first, Uint32 second) const;
+    /// @brief Erase the pages and the glyphs.
+    void unload();
+    /// @brief The glyphs by code point.
+    std::unordered_map<Uint32, Glyph> glyphs;
+    /// @brief The kerning by pair of code points.
+    std::unordered_map<Uint64, int> kernings;
+    /// @brief The names of the textures of the pages.
+    std::vector<std::string> pageNames;
+    /// @brief The glyphs of every page being drawn.
+    std::vector<SpriteBatch> batches;
+    /// @brief The distance between lines.
+    int lineHeight = 0;
+    /// @brief The distance to the base of the glyphs.
+    int base = 0;
+    /// @brief The color of the text.
+    SDL_Color color = {255, 255, 255, 255};
+  };
+
+} // namespace DPGE
+
+#endif
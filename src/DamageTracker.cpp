@@ -0,0 +1,494 @@
+// File: DamageTracker.cpp
+// Author: Duilio Pérez
+// Implementation of the damage tracker.
+#include "DamageTracker.hpp"
+#include "Game.hpp"
+#include <SDL2/SDL.h>
+#include <algorithm>
+#include <cmath>
+using namespace DPGE;
+using namespace std;
+
+// The area of the draws that cover all the window.
+static const SDL_Rect everywhere = {0, 0, 1 << 24, 1 << 24};
+
+// Get the number of pixels of an area.
+static Sint64 getSize(const SDL_Rect &area)
+{
+  return static_cast<Sint64>(area.w) * area.h;
+}
+
+// Hash bytes with FNV-1a.
+static Uint64 hashBytes(
+  Uint64 hash, const void *data, size_t size)
+{
+  // The bytes to hash.
+  const Uint8 *bytes = static_cast<const Uint8 *>(data);
+  for (size_t i = 0; i < size; i++)
+    hash = (hash ^ bytes[i]) * 1099511628211ULL;
+  return hash;
+}
+
+// Get the pixels covered by some limits, with a pixel
+// more for the rounding of the renderer.
+static SDL_Rect getBounds(
+  float minX, float minY, float maxX, float maxY)
+{
+  return {static_cast<int>(floorf(minX)) - 1,
+    static_cast<int>(floorf(minY)) - 1,
+    static_cast<int>(ceilf(maxX) - floorf(minX)) + 2,
+    static_cast<int>(ceilf(maxY) - floorf(minY)) + 2};
+}
+
+// Default constructor.
+DamageTracker::DamageTracker()
+{
+  // The mode of the display of the window.
+  SDL_DisplayMode mode;
+  mode.refresh_rate = 0;
+  SDL_GetWindowDisplayMode(theGame.getWindow(), &mode);
+  if (mode.refresh_rate > 0)
+    this->frameDelay = 1000 / mode.refresh_rate;
+  SDL_AddEventWatch(watchEvent, this);
+}
+
+// Destructor.
+DamageTracker::~DamageTracker()
+{
+  SDL_DelEventWatch(watchEvent, this);
+  for (SDL_Texture *texture : this->keptTextures)
+    SDL_DestroyTexture(texture);
+  if (this->canvas)
+    SDL_DestroyTexture(this->canvas);
+}
+
+// Set the color of the background.
+void DamageTracker::setBackground(const SDL_Color &color)
+{
+  this->background = color;
+  this->fullDamage = true;
+}
+
+// Record the copy of a texture.
+void DamageTracker::copy(SDL_Texture *texture,
+  const SDL_Rect *src, const SDL_FRect *dest, double angle,
+  const SDL_FPoint *center, SDL_RendererFlip flip)
+{
+  // The recorded draw.
+  Draw draw = {};
+  // The rotation in radians.
+  float radians = static_cast<float>(angle * M_PI / 180);
+  // The corners of the destination, relative to the
+  // rotation center.
+  float cornersX[4], cornersY[4];
+  // A rotated corner.
+  float x = 0, y = 0;
+  // The limits of the rotated destination.
+  float minX = INFINITY, minY = INFINITY;
+  float maxX = -INFINITY, maxY = -INFINITY;
+  draw.texture   = texture;
+  draw.version   = this->getVersion(texture);
+  draw.hasSrc    = src != nullptr;
+  draw.hasDest   = dest != nullptr;
+  draw.hasCenter = center != nullptr;
+  draw.src       = src ? *src : SDL_Rect{0, 0, 0, 0};
+  draw.dest      = dest ? *dest : SDL_FRect{0, 0, 0, 0};
+  draw.center    = center ? *center : SDL_FPoint{0, 0};
+  draw.angle     = angle;
+  draw.flip      = flip;
+  this->takeState(draw);
+  if (!dest)
+    draw.bounds = everywhere;
+  else
+  {
+    if (!center)
+      draw.center = {dest->w / 2, dest->h / 2};
+    cornersX[0] = cornersX[3] = -draw.center.x;
+    cornersX[1] = cornersX[2] = dest->w - draw.center.x;
+    cornersY[0] = cornersY[1] = -draw.center.y;
+    cornersY[2] = cornersY[3] = dest->h - draw.center.y;
+    for (int i = 0; i < 4; i++)
+    {
+      x    = cornersX[i] * cosf(radians) -
+             cornersY[i] * sinf(radians);
+      y    = cornersX[i] * sinf(radians) +
+             cornersY[i] * cosf(radians);
+      minX = min(minX, x);
+      maxX = max(maxX, x);
+      minY = min(minY, y);
+      maxY = max(maxY, y);
+    }
+    x           = dest->x + draw.center.x;
+    y           = dest->y + draw.center.y;
+    draw.bounds = getBounds(minX + x, minY + y, maxX + x,
+      maxY + y);
+    if (!center)
+      draw.center = {0, 0};
+  }
+  if (draw.clipped && !SDL_IntersectRect(&draw.bounds,
+                        &draw.clip, &draw.bounds))
+    draw.bounds = {0, 0, 0, 0};
+  this->draws.push_back(draw);
+}
+
+// Record triangles.
+void DamageTracker::geometry(SDL_Texture *texture,
+  const SDL_Vertex *vertices, int vertexCount,
+  const int *indices, int indexCount)
+{
+  // The recorded draw.
+  Draw draw = {};
+  // The limits of the vertices.
+  float minX = INFINITY, minY = INFINITY;
+  float maxX = -INFINITY, maxY = -INFINITY;
+  if (!vertices || vertexCount <= 0)
+    return;
+  draw.texture     = texture;
+  draw.version     = 0;
+  draw.firstVertex = this->vertices.size();
+  draw.firstIndex  = this->indices.size();
+  draw.vertexCount = vertexCount;
+  draw.indexCount  = indices ? indexCount : 0;
+  if (texture)
+    draw.version = this->getVersion(texture);
+  this->takeState(draw);
+  this->vertices.insert(
+    this->vertices.end(), vertices, vertices + vertexCount);
+  if (indices)
+    this->indices.insert(
+      this->indices.end(), indices, indices + indexCount);
+  draw.hash = hashBytes(14695981039346656037ULL, vertices,
+    sizeof(SDL_Vertex) * vertexCount);
+  if (indices)
+    draw.hash = hashBytes(
+      draw.hash, indices, sizeof(int) * indexCount);
+  for (int i = 0; i < vertexCount; i++)
+  {
+    minX = min(minX, vertices[i].position.x);
+    maxX = max(maxX, vertices[i].position.x);
+    minY = min(minY, vertices[i].position.y);
+    maxY = max(maxY, vertices[i].position.y);
+  }
+  draw.bounds = getBounds(minX, minY, maxX, maxY);
+  if (draw.clipped && !SDL_IntersectRect(&draw.bounds,
+                        &draw.clip, &draw.bounds))
+    draw.bounds = {0, 0, 0, 0};
+  this->draws.push_back(draw);
+}
+
+// Mark an area to be drawn again.
+void DamageTracker::addDamage(const SDL_Rect &area)
+{
+  // The area that grows less joining the new one.
+  size_t closest = 0;
+  Sint64 growth  = -1;
+  // Two areas joined.
+  SDL_Rect joined;
+  if (area.w <= 0 || area.h <= 0)
+    return;
+  for (size_t i = 0; i < this->damage.size(); i++)
+  {
+    SDL_UnionRect(&this->damage[i], &area, &joined);
+    if (SDL_HasIntersection(&this->damage[i], &area))
+    {
+      this->damage[i] = joined;
+      return;
+    }
+    if (growth < 0 ||
+        getSize(joined) - getSize(this->damage[i]) < growth)
+    {
+      closest = i;
+      growth  = getSize(joined) - getSize(this->damage[i]);
+    }
+  }
+  if (this->damage.size() < maxAreas)
+    this->damage.push_back(area);
+  else
+    SDL_UnionRect(&this->damage[closest], &area,
+      &this->damage[closest]);
+}
+
+// Mark all the window to be drawn again.
+void DamageTracker::addFullDamage()
+{
+  this->fullDamage = true;
+}
+
+// Tell that the pixels of a texture changed.
+void DamageTracker::changeTexture(
+  const SDL_Texture *texture)
+{
+  this->versions[texture] = this->nextVersion++;
+}
+
+// Keep a destroyed texture if it's drawn.
+bool DamageTracker::keepTexture(SDL_Texture *texture)
+{
+  this->versions.erase(texture);
+  for (const Draw &draw : this->draws)
+    if (draw.texture == texture)
+    {
+      this->keptTextures.push_back(texture);
+      return true;
+    }
+  return false;
+}
+
+// Draw the areas that changed.
+bool DamageTracker::present()
+{
+  // The renderer.
+  SDL_Renderer *renderer = theGame.getRenderer();
+  // The scene.
+  SDL_Rect screen;
+  // The state of the textures at the end of the frame.
+  unordered_map<SDL_Texture *, Draw> states;
+  // The draw color and blend mode of the renderer.
+  SDL_Color     color = {0, 0, 0, 0};
+  SDL_BlendMode blend = SDL_BLENDMODE_NONE;
+  // The area drawn again.
+  SDL_Rect area;
+  // Indicator to know if the frame must be presented.
+  bool changed = true;
+  SDL_GetRenderDrawColor(
+    renderer, &color.r, &color.g, &color.b, &color.a);
+  SDL_GetRenderDrawBlendMode(renderer, &blend);
+  for (const Draw &draw : this->draws)
+    if (draw.texture && !states.count(draw.texture))
+      this->takeState(states[draw.texture] = draw);
+  if (!this->createCanvas(renderer))
+  {
+    // Without the scene, all is drawn every frame.
+    for (const Draw &draw : this->draws)
+      this->replay(renderer, draw, everywhere);
+  }
+  else
+  {
+    screen = {0, 0, this->width, this->height};
+    for (size_t i = 0; i < max(this->draws.size(),
+                             this->previousDraws.size());
+         i++)
+    {
+      if (i < this->draws.size() &&
+          i < this->previousDraws.size() &&
+          isSame(this->draws[i], this->previousDraws[i]))
+        continue;
+      if (i < this->draws.size())
+        this->addDamage(this->draws[i].bounds);
+      if (i < this->previousDraws.size())
+        this->addDamage(this->previousDraws[i].bounds);
+    }
+    if (this->fullDamage)
+      this->damage.assign(1, screen);
+    changed = false;
+    SDL_SetRenderTarget(renderer, this->canvas);
+    for (const SDL_Rect &damaged : this->damage)
+    {
+      if (!SDL_IntersectRect(&damaged, &screen, &area))
+        continue;
+      changed = true;
+      SDL_RenderSetClipRect(renderer, &area);
+      SDL_SetRenderDrawBlendMode(
+        renderer, SDL_BLENDMODE_NONE);
+      SDL_SetRenderDrawColor(renderer, this->background.r,
+        this->background.g, this->background.b,
+        this->background.a);
+      SDL_RenderFillRect(renderer, &area);
+      for (const Draw &draw : this->draws)
+        if (SDL_HasIntersection(&draw.bounds, &area))
+          this->replay(renderer, draw, area);
+    }
+    SDL_SetRenderTarget(renderer, nullptr);
+    SDL_RenderSetClipRect(renderer, nullptr);
+    if (changed)
+      SDL_RenderCopy(
+        renderer, this->canvas, nullptr, nullptr);
+  }
+  // Restore the state of the textures and the renderer.
+  for (const auto &state : states)
+  {
+    SDL_SetTextureColorMod(state.first,
+      state.second.modulation.r, state.second.modulation.g,
+      state.second.modulation.b);
+    SDL_SetTextureAlphaMod(
+      state.first, state.second.modulation.a);
+    SDL_SetTextureBlendMode(
+      state.first, state.second.blend);
+  }
+  SDL_SetRenderDrawColor(
+    renderer, color.r, color.g, color.b, color.a);
+  SDL_SetRenderDrawBlendMode(renderer, blend);
+  // The next frame is compared with this one.
+  for (SDL_Texture *texture : this->keptTextures)
+    SDL_DestroyTexture(texture);
+  this->keptTextures.clear();
+  this->previousDraws.swap(this->draws);
+  this->draws.clear();
+  this->vertices.clear();
+  this->indices.clear();
+  this->damage.clear();
+  this->fullDamage = false;
+  return changed;
+}
+
+// Draw the kept scene again.
+bool DamageTracker::drawScene()
+{
+  if (!this->canvas)
+    return false;
+  return SDL_RenderCopy(theGame.getRenderer(),
+           this->canvas, nullptr, nullptr) == 0;
+}
+
+// Wait until the next frame or an event.
+void DamageTracker::wait()
+{
+  SDL_WaitEventTimeout(nullptr, this->frameDelay);
+}
+
+// Get the version of a texture.
+Uint64 DamageTracker::getVersion(const SDL_Texture *texture)
+{
+  // The version of the texture.
+  Uint64 &version = this->versions[texture];
+  if (!version)
+    version = this->nextVersion++;
+  return version;
+}
+
+// Take the state of a draw.
+void DamageTracker::takeState(Draw &draw)
+{
+  // The renderer.
+  SDL_Renderer *renderer = theGame.getRenderer();
+  draw.modulation = {255, 255, 255, 255};
+  if (draw.texture)
+  {
+    SDL_GetTextureColorMod(draw.texture,
+      &draw.modulation.r, &draw.modulation.g,
+      &draw.modulation.b);
+    SDL_GetTextureAlphaMod(
+      draw.texture, &draw.modulation.a);
+    SDL_GetTextureBlendMode(draw.texture, &draw.blend);
+  }
+  else
+    SDL_GetRenderDrawBlendMode(renderer, &draw.blend);
+  draw.clipped = SDL_RenderIsClipEnabled(renderer);
+  if (draw.clipped)
+    SDL_RenderGetClipRect(renderer, &draw.clip);
+}
+
+// Compare two draws.
+bool DamageTracker::isSame(
+  const Draw &first, const Draw &second)
+{
+  return first.texture == second.texture &&
+         first.version == second.version &&
+         first.vertexCount == second.vertexCount &&
+         first.indexCount == second.indexCount &&
+         first.hash == second.hash &&
+         first.hasSrc == second.hasSrc &&
+         first.hasDest == second.hasDest &&
+         first.hasCenter == second.hasCenter &&
+         first.clipped == second.clipped &&
+         SDL_RectEquals(&first.src, &second.src) &&
+         first.dest.x == second.dest.x &&
+         first.dest.y == second.dest.y &&
+         first.dest.w == second.dest.w &&
+         first.dest.h == second.dest.h &&
+         first.center.x == second.center.x &&
+         first.center.y == second.center.y &&
+         first.angle == second.angle &&
+         first.flip == second.flip &&
+         first.modulation.r == second.modulation.r &&
+         first.modulation.g == second.modulation.g &&
+         first.modulation.b == second.modulation.b &&
+         first.modulation.a == second.modulation.a &&
+         first.blend == second.blend &&
+         (!first.clipped ||
+           SDL_RectEquals(&first.clip, &second.clip));
+}
+
+// Draw again a recorded draw.
+void DamageTracker::replay(SDL_Renderer *renderer,
+  const Draw &draw, const SDL_Rect &area)
+{
+  // The clip area of the draw.
+  SDL_Rect clip = area;
+  if (draw.clipped &&
+      !SDL_IntersectRect(&draw.clip, &area, &clip))
+    return;
+  SDL_RenderSetClipRect(renderer,
+    SDL_RectEquals(&clip, &everywhere) ? nullptr : &clip);
+  if (draw.texture)
+  {
+    SDL_SetTextureColorMod(draw.texture, draw.modulation.r,
+      draw.modulation.g, draw.modulation.b);
+    SDL_SetTextureAlphaMod(draw.texture, draw.modulation.a);
+    SDL_SetTextureBlendMode(draw.texture, draw.blend);
+  }
+  else
+    SDL_SetRenderDrawBlendMode(renderer, draw.blend);
+  if (draw.vertexCount)
+    SDL_RenderGeometry(renderer, draw.texture,
+      &this->vertices[draw.firstVertex], draw.vertexCount,
+      draw.indexCount ? &this->indices[draw.firstIndex]
+                      : nullptr,
+      draw.indexCount);
+  else
+    SDL_RenderCopyExF(renderer, draw.texture,
+      draw.hasSrc ? &draw.src : nullptr,
+      draw.hasDest ? &draw.dest : nullptr, draw.angle,
+      draw.hasCenter ? &draw.center : nullptr, draw.flip);
+}
+
+// Create the texture of the scene.
+bool DamageTracker::createCanvas(SDL_Renderer *renderer)
+{
+  // The size of the window.
+  int outputWidth = 0, outputHeight = 0;
+  SDL_GetRendererOutputSize(
+    renderer, &outputWidth, &outputHeight);
+  if (this->canvas && outputWidth == this->width &&
+      outputHeight == this->height)
+    return true;
+  if (this->canvas)
+    SDL_DestroyTexture(this->canvas);
+  this->canvas     = nullptr;
+  this->width      = outputWidth;
+  this->height     = outputHeight;
+  this->fullDamage = true;
+  if (outputWidth <= 0 || outputHeight <= 0 ||
+      !SDL_RenderTargetSupported(renderer))
+    return false;
+  this->canvas = SDL_CreateTexture(renderer,
+    SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_TARGET,
+    outputWidth, outputHeight);
+  if (!this->canvas)
+  {
+    SDL_LogError(SDL_LOG_CATEGORY_ERROR,
+      "Error creating the scene of the damage mode: "
+      "%s.\n",
+      SDL_GetError());
+    return false;
+  }
+  SDL_SetTextureBlendMode(this->canvas, SDL_BLENDMODE_NONE);
+  return true;
+}
+
+// Watch the window events that lose the scene.
+int DamageTracker::watchEvent(void *data, SDL_Event *event)
+{
+  // The kind of window event.
+  Uint8 kind = event->window.event;
+  if (event->type == SDL_WINDOWEVENT &&
+      (kind == SDL_WINDOWEVENT_EXPOSED ||
+        kind == SDL_WINDOWEVENT_SIZE_CHANGED ||
+        kind == SDL_WINDOWEVENT_RESTORED))
+    static_cast<DamageTracker *>(data)->fullDamage = true;
+  // The content of the scene is lost with the targets.
+  if (event->type == SDL_RENDER_TARGETS_RESET ||
+      event->type == SDL_RENDER_DEVICE_RESET)
+    static_cast<DamageTracker *>(data)->fullDamage = true;
+  return 1;
+}
@@ -0,0 +1,198 @@
+/// @file DamageTracker.hpp
+/// @author Duilio Pérez
+/// @brief A renderer backend that redraws only what
+/// changed.
+#ifndef DAMAGETRACKER_HPP
+#define DAMAGETRACKER_HPP true
+#include <SDL2/SDL.h>
+#include <unordered_map>
+#include <vector>
+
+namespace DPGE
+{
+
+  /// @brief A backend that records the draws of a frame
+  /// and redraws only the areas that changed since the
+  /// previous one.
+  ///
+  /// It's used by the texture manager in the damage mode.
+  /// The scene is kept in a texture of the size of the
+  /// window. When the frame is presented, the draws are
+  /// compared with the ones of the previous frame, and
+  /// the areas of the different draws are cleared and
+  /// drawn again in that texture. When nothing changed,
+  /// the frame isn't presented and the thread waits for
+  /// an event until the next frame, except in the browser,
+  /// where the loop can't block.
+  class DamageTracker final
+  {
+  public:
+    /// @brief Default constructor.
+    DamageTracker();
+    /// @brief Copy constructor deleted.
+    DamageTracker(const DamageTracker &) = delete;
+    /// @brief Destructor.
+    ~DamageTracker();
+    /// @brief Set the color of the background.
+    /// @param color The color of the background.
+    void setBackground(const SDL_Color &color);
+    /// @brief Record the copy of a texture.
+    /// @param texture The texture to copy.
+    /// @param src The source area, nullptr for all the
+    /// texture.
+    /// @param dest The destination area, nullptr for all
+    /// the window.
+    /// @param angle The rotation angle in degrees.
+    /// @param center The rotation center, nullptr for the
+    /// center of the destination.
+    /// @param flip The flip direction.
+    ///
+    /// The color and alpha modulation and the blend mode of
+    /// the texture, and the clip area of the renderer are
+    /// taken at this point.
+    void copy(SDL_Texture *texture, const SDL_Rect *src,
+      const SDL_FRect *dest, double angle,
+      const SDL_FPoint *center, SDL_RendererFlip flip);
+    /// @brief Record triangles.
+    /// @param texture The texture of the triangles, or
+    /// nullptr.
+    /// @param vertices The vertices of the triangles.
+    /// @param vertexCount The number of vertices.
+    /// @param indices The vertices of every triangle, or
+    /// nullptr.
+    /// @param indexCount The number of indices.
+    void geometry(SDL_Texture *texture,
+      const SDL_Vertex *vertices, int vertexCount,
+      const int *indices, int indexCount);
+    /// @brief Mark an area to be drawn again.
+    /// @param area The area in pixels of the window.
+    void addDamage(const SDL_Rect &area);
+    /// @brief Mark all the window to be drawn again.
+    void addFullDamage();
+    /// @brief Tell that the pixels of a texture changed.
+    /// @param texture The texture.
+    void changeTexture(const SDL_Texture *texture);
+    /// @brief Keep a destroyed texture until the frame is
+    /// presented, if it's drawn in the frame.
+    /// @param texture The texture.
+    /// @return true if the texture is kept, false if it can
+    /// be destroyed now.
+    bool keepTexture(SDL_Texture *texture);
+    /// @brief Draw the areas that changed.
+    /// @return true if the frame must be presented, false
+    /// if nothing changed.
+    bool present();
+    /// @brief Draw again the scene kept from the last
+    /// frame, to read it when nothing changed.
+    /// @return true in success, false if there's no scene.
+    bool drawScene();
+    /// @brief Wait until the next frame or an event.
+    void wait();
+    /// @brief Copy operator deleted.
+    const DamageTracker &operator=(
+      const DamageTracker &) = delete;
+
+  private:
+    /// @brief A recorded draw.
+    struct Draw
+    {
+      /// @brief The texture, or nullptr for triangles
+      /// without texture.
+      SDL_Texture *texture;
+      /// @brief The version of the pixels of the texture.
+      Uint64 version;
+      /// @brief The source area.
+      SDL_Rect src;
+      /// @brief The destination area.
+      SDL_FRect dest;
+      /// @brief The rotation center.
+      SDL_FPoint center;
+      /// @brief The rotation angle.
+      double angle;
+      /// @brief The flip direction.
+      SDL_RendererFlip flip;
+      /// @brief The color and alpha modulation.
+      SDL_Color modulation;
+      /// @brief The blend mode.
+      SDL_BlendMode blend;
+      /// @brief The clip area.
+      SDL_Rect clip;
+      /// @brief The area covered by the draw.
+      SDL_Rect bounds;
+      /// @brief The first vertex and index of triangles.
+      size_t firstVertex, firstIndex;
+      /// @brief The number of vertices and indices of
+      /// triangles, 0 for a copy.
+      int vertexCount, indexCount;
+      /// @brief The hash of the triangles.
+      Uint64 hash;
+      /// @brief Indicators to know which areas are used.
+      bool hasSrc, hasDest, hasCenter, clipped;
+    };
+    /// @brief The maximum number of areas drawn again, the
+    /// closest are joined.
+    static constexpr size_t maxAreas = 8;
+    /// @brief Get the version of a texture.
+    /// @param texture The texture.
+    /// @return The version of its pixels.
+    Uint64 getVersion(const SDL_Texture *texture);
+    /// @brief Take the state of the renderer and the
+    /// texture of a draw.
+    /// @param draw The draw.
+    void takeState(Draw &draw);
+    /// @brief Compare two draws.
+    /// @param first The first draw.
+    /// @param second The second draw.
+    /// @return true if they draw the same.
+    static bool isSame(
+      const Draw &first, const Draw &second);
+    /// @brief Draw again a recorded draw.
+    /// @param renderer The renderer.
+    /// @param draw The draw.
+    /// @param area The area being drawn.
+    void replay(SDL_Renderer *renderer, const Draw &draw,
+      const SDL_Rect &area);
+    /// @brief Create the texture of the scene if it
+    /// doesn't exist or the window changed its size.
+    /// @param renderer The renderer.
+    /// @return true in success, false otherwise.
+    bool createCanvas(SDL_Renderer *renderer);
+    /// @brief Watch the window and render events that lose
+    /// the scene.
+    /// @param data The damage tracker.
+    /// @param event The event.
+    /// @return 1 to keep the event.
+    static int watchEvent(void *data, SDL_Event *event);
+    /// @brief The texture with the scene.
+    SDL_Texture *canvas = nullptr;
+    /// @brief The size of the scene.
+    int width = 0, height = 0;
+    /// @brief The color of the background.
+    SDL_Color background = {0, 0, 0, 255};
+    /// @brief The draws of the current frame.
+    std::vector<Draw> draws;
+    /// @brief The draws of the previous frame.
+    std::vector<Draw> previousDraws;
+    /// @brief The vertices of the triangles.
+    std::vector<SDL_Vertex> vertices;
+    /// @brief The indices of the triangles.
+    std::vector<int> indices;
+    /// @brief The areas to draw again.
+    std::vector<SDL_Rect> damage;
+    /// @brief Indicator to know if all the scene must be
+    /// drawn again.
+    bool fullDamage = true;
+    /// @brief The versions of the pixels of the textures.
+    std::unordered_map<const SDL_Texture *, Uint64>
+      versions;
+    /// @brief The next version of the pixels.
+    Uint64 nextVersion = 1;
+    /// @brief The textures destroyed during the frame.
+    std::vector<SDL_Texture *> keptTextures;
+    /// @brief The milliseconds between frames.
+    int frameDelay = 16;
+  };
+
+} // namespace DPGE
+
+#endif
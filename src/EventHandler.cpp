@@ -128,6 +128,13 @@ void BasicEventListener::handleEvents(
   }
 }
 
+// Handle an event as a given type.
+void BasicEventListener::handleEvents(
+  const EventType &type, const SDL_Event &event)
+{
+  this->callFunction(type, event);
+}
+
 // Call a function based on the event.
 void BasicEventListener::callFunction(
   const EventType &event, const SDL_Event &topEvent)
@@ -45,6 +45,12 @@ namespace DPGE
     MOUSEBUTTON,
     /// @brief Mouse wheel event.
     MOUSEWHEEL,
+    /// @brief The mouse entered a widget, sent by the
+    /// input router.
+    MOUSEENTER,
+    /// @brief The mouse left a widget, sent by the input
+    /// router.
+    MOUSELEAVE,
     /// @brief Multigesture event.
     MULTIGESTURE,
     /// @brief Quit event.
@@ -190,6 +196,14 @@ namespace DPGE
         break;
       }
     }
+    /// @brief Handle an event as a given type.
+    /// @param type The type of the listener to call.
+    /// @param event The event to handle.
+    void handleEvents(
+      const EventType &type, const SDL_Event &event)
+    {
+      this->callFunction(type, event);
+    }
     /// @brief Set the data structure.
     /// @param dataStruct The data struct to use.
     void setData(T *dataStruct)
@@ -231,6 +245,11 @@ namespace DPGE
     /// @brief Handle the events.
     /// @param event The even to handle.
     void handleEvents(const SDL_Event &event);
+    /// @brief Handle an event as a given type.
+    /// @param type The type of the listener to call.
+    /// @param event The event to handle.
+    void handleEvents(
+      const EventType &type, const SDL_Event &event);
 
   private:
     /// @brief Call a function defined to handle the event.
@@ -0,0 +1,326 @@
+// File: Flipbook.cpp
+// Author: Duilio Pérez
+// Implementation of the flipbook player.
+#include "Flipbook.hpp"
+#include "Game.hpp"
+#include "ImageProcessing.hpp"
+#include "PathPattern.hpp"
+#include "TextureManager.hpp"
+#include <SDL2/SDL_image.h>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+using namespace DPGE;
+using namespace std;
+
+// Load a frame in the format of the streaming textures.
+static SDL_Surface *loadFrame(const string &path)
+{
+  // The loaded image.
+  SDL_Surface *image = IMG_Load(path.c_str());
+  // The converted image.
+  SDL_Surface *converted = nullptr;
+  if (!image)
+    return nullptr;
+  converted =
+    convertSurface(image, SDL_PIXELFORMAT_ARGB8888);
+  SDL_FreeSurface(image);
+  return converted;
+}
+
+// Default constructor.
+Flipbook::Flipbook()
+{
+  // The name must be unique for every player.
+  char name[64];
+  snprintf(name, sizeof(name), "DPGE::Flipbook:%p",
+    static_cast<void *>(this));
+  this->textureName = name;
+}
+
+// Constructor.
+Flipbook::Flipbook(const SDL_Rect &playerArea)
+: Flipbook()
+{
+  this->area = playerArea;
+}
+
+// Destructor.
+Flipbook::~Flipbook()
+{
+  this->close();
+}
+
+// Open a sequence.
+bool Flipbook::open(const vector<string> &framePaths,
+  double framesPerSecond, bool loop, size_t bufferedFrames)
+{
+  // The first frame.
+  SDL_Surface *first = nullptr;
+  this->close();
+  if (framePaths.empty() || framesPerSecond <= 0)
+  {
+    SDL_LogError(SDL_LOG_CATEGORY_ERROR,
+      "Can't open a flipbook: There are no frames or the "
+      "rate isn't positive.\n");
+    return false;
+  }
+  first = loadFrame(framePaths[0]);
+  if (!first)
+  {
+    SDL_ShowSimpleMessageBox(SDL_MESSAGEBOX_ERROR,
+      "Error loading a flipbook", IMG_GetError(),
+      theGame.getWindow());
+    SDL_LogError(SDL_LOG_CATEGORY_ERROR,
+      "Error loading a flipbook: %s.\n", IMG_GetError());
+    return false;
+  }
+  if (!theTextureManager.createStreamingTexture(
+        this->textureName, first->w, first->h))
+  {
+    SDL_FreeSurface(first);
+    return false;
+  }
+  this->show(first);
+  SDL_FreeSurface(first);
+  this->paths         = framePaths;
+  this->rate          = framesPerSecond;
+  this->looping       = loop;
+  this->opened        = true;
+  this->ring.resize(max<size_t>(bufferedFrames, 1));
+  this->ringStart     = 0;
+  this->ringCount     = 0;
+  this->nextFrame     = 1;
+  this->dueFrame      = 0;
+  this->stopping      = false;
+  this->shownFrame    = 0;
+  this->startCounter  = SDL_GetPerformanceCounter();
+  this->paused        = false;
+  this->finished      = false;
+  this->droppedFrames = 0;
+  this->decoder       = thread(&Flipbook::decode, this);
+  return true;
+}
+
+// Open a numbered sequence.
+bool Flipbook::open(const string &pattern, int first,
+  int count, double framesPerSecond, bool loop)
+{
+  // The paths of the frames.
+  vector<string> framePaths;
+  for (int i = 0; i < count; i++)
+    framePaths.push_back(formatPath(
+      pattern, static_cast<Sint64>(first) + i));
+  return this->open(framePaths, framesPerSecond, loop);
+}
+
+// Stop the playback.
+void Flipbook::close()
+{
+  if (!this->opened)
+    return;
+  {
+    lock_guard<mutex> lock(this->ringMutex);
+    this->stopping = true;
+  }
+  this->ringSpace.notify_one();
+  this->decoder.join();
+  for (; this->ringCount > 0; this->ringCount--)
+  {
+    SDL_FreeSurface(this->ring[this->ringStart].surface);
+    this->ringStart =
+      (this->ringStart + 1) % this->ring.size();
+  }
+  theTextureManager.erase(this->textureName);
+  this->paths.clear();
+  this->opened = false;
+}
+
+// Set the area of the player.
+void Flipbook::setArea(const SDL_Rect &playerArea)
+{
+  this->area = playerArea;
+}
+
+// Get the area of the player.
+const SDL_Rect &Flipbook::getArea() const
+{
+  return this->area;
+}
+
+// Pause the playback.
+void Flipbook::pause()
+{
+  if (this->paused)
+    return;
+  this->pauseCounter = SDL_GetPerformanceCounter();
+  this->paused       = true;
+}
+
+// Resume the playback.
+void Flipbook::resume()
+{
+  if (!this->paused)
+    return;
+  // The time paused doesn't count.
+  this->startCounter +=
+    SDL_GetPerformanceCounter() - this->pauseCounter;
+  this->paused = false;
+}
+
+// Query if the playback is paused.
+bool Flipbook::isPaused() const
+{
+  return this->paused;
+}
+
+// Query if the sequence ended.
+bool Flipbook::isFinished() const
+{
+  return this->finished;
+}
+
+// Get the dropped frames.
+Uint64 Flipbook::getDroppedFrames() const
+{
+  return this->droppedFrames;
+}
+
+// Get the name of the texture.
+const string &Flipbook::getTextureName() const
+{
+  return this->textureName;
+}
+
+// Show the frame due at the current time.
+void Flipbook::update()
+{
+  // The frame due.
+  Uint64 due = 0;
+  // The newest frame that is due.
+  Frame latest = {0, nullptr};
+  if (!this->opened || this->paused || this->finished)
+    return;
+  due = this->getDueFrame();
+  if (due == this->shownFrame)
+    return;
+  {
+    lock_guard<mutex> lock(this->ringMutex);
+    this->dueFrame = due;
+    // Only the newest of the late frames is shown.
+    while (this->ringCount > 0 &&
+           this->ring[this->ringStart].number <= due)
+    {
+      if (latest.surface)
+        SDL_FreeSurface(latest.surface);
+      latest          = this->ring[this->ringStart];
+      this->ringStart =
+        (this->ringStart + 1) % this->ring.size();
+      this->ringCount--;
+    }
+  }
+  this->ringSpace.notify_one();
+  if (latest.surface)
+  {
+    this->show(latest.surface);
+    SDL_FreeSurface(latest.surface);
+    this->droppedFrames +=
+      latest.number - this->shownFrame - 1;
+    this->shownFrame = latest.number;
+  }
+  if (!this->looping && due >= this->paths.size())
+    this->finished = true;
+}
+
+// Render the widget.
+void Flipbook::render()
+{
+  if (!this->opened)
+    return;
+  this->update();
+  if (this->area.w > 0 && this->area.h > 0)
+    theTextureManager.render(this->textureName, this->area);
+  else
+    theTextureManager.render(
+      this->textureName, this->area.x, this->area.y);
+}
+
+// The loop of the decoder thread.
+void Flipbook::decode()
+{
+  // The frame to decode.
+  Uint64 frame = 0;
+  // The decoded frame.
+  SDL_Surface *surface = nullptr;
+  // The frames that failed in a row.
+  size_t failures = 0;
+  unique_lock<mutex> lock(this->ringMutex);
+  while (true)
+  {
+    this->ringSpace.wait(lock, [this] {
+      return this->stopping ||
+             this->ringCount < this->ring.size();
+    });
+    if (this->stopping)
+      return;
+    // The frames already late are skipped.
+    frame = max(this->nextFrame, this->dueFrame);
+    if ((!this->looping && frame >= this->paths.size()) ||
+        failures >= this->paths.size())
+    {
+      this->ringSpace.wait(
+        lock, [this] { return this->stopping; });
+      return;
+    }
+    this->nextFrame = frame + 1;
+    lock.unlock();
+    surface =
+      loadFrame(this->paths[frame % this->paths.size()]);
+    if (!surface)
+      SDL_LogError(SDL_LOG_CATEGORY_ERROR,
+        "Error loading a frame of a flipbook: %s.\n",
+        IMG_GetError());
+    lock.lock();
+    if (!surface)
+    {
+      failures++;
+      continue;
+    }
+    failures = 0;
+    this->ring[(this->ringStart + this->ringCount) %
+               this->ring.size()] = {frame, surface};
+    this->ringCount++;
+  }
+}
+
+// Copy a frame into the texture.
+void Flipbook::show(SDL_Surface *surface)
+{
+  // The pixels of the texture.
+  StreamingTexture *stream =
+    theTextureManager.getStreamingTexture(
+      this->textureName);
+  // The area copied, frames of other size are cut.
+  int width = 0, height = 0;
+  if (!stream)
+    return;
+  width  = min(surface->w, stream->getWidth());
+  height = min(surface->h, stream->getHeight());
+  for (int y = 0; y < height; y++)
+    memcpy(stream->getPixels() + y * stream->getWidth(),
+      static_cast<Uint8 *>(surface->pixels) +
+        y * surface->pitch,
+      width * sizeof(Uint32));
+  stream->markDirty({0, 0, width, height});
+}
+
+// Get the frame due at the current time.
+Uint64 Flipbook::getDueFrame() const
+{
+  // The time since the start in seconds.
+  double seconds =
+    static_cast<double>(
+      SDL_GetPerformanceCounter() - this->startCounter) /
+    SDL_GetPerformanceFrequency();
+  return static_cast<Uint64>(seconds * this->rate);
+}
@@ -0,0 +1,165 @@
+/// @file Flipbook.hpp
+/// @author Duilio Pérez
+/// @brief A player of image sequences streamed from disk.
+#ifndef FLIPBOOK_HPP
+#define FLIPBOOK_HPP true
+#include "Widget.hpp"
+#include <SDL2/SDL.h>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace DPGE
+{
+
+  /// @brief A widget that plays a sequence of images, like
+  /// a cutscene or an animated background.
+  ///
+  /// The images aren't loaded in the texture manager. A
+  /// thread decodes the next frames into a small ring of
+  /// surfaces, and the frame due at the current time is
+  /// copied into a single streaming texture. When the
+  /// player falls behind, the late frames are dropped, and
+  /// the decoder skips them.
+  class Flipbook final : public Widget
+  {
+  public:
+    /// @brief Default constructor.
+    Flipbook();
+    /// @brief Constructor.
+    /// @param playerArea The area of the player, with a
+    /// width or height of 0 to use the size of the frames.
+    explicit Flipbook(const SDL_Rect &playerArea);
+    /// @brief Copy constructor deleted.
+    Flipbook(const Flipbook &) = delete;
+    /// @brief Destructor.
+    ~Flipbook();
+    /// @brief Open a sequence and start playing it.
+    /// @param framePaths The paths of the frames in order.
+    /// @param framesPerSecond The playback rate.
+    /// @param loop true to play the sequence again when it
+    /// ends.
+    /// @param bufferedFrames The most frames decoded ahead.
+    /// @return true in success, false otherwise.
+    ///
+    /// The first frame is loaded before returning, to
+    /// create the texture with its size.
+    bool open(const std::vector<std::string> &framePaths,
+      double framesPerSecond, bool loop = false,
+      size_t bufferedFrames = 8);
+    /// @brief Open a numbered sequence and start playing
+    /// it.
+    /// @param pattern The path of the frames with a
+    /// conversion for the number, like "intro/%04d.png".
+    /// Only the first %u, %d or %i is replaced, padded
+    /// with zeros to its width, and %% gives a %.
+    /// @param first The number of the first frame.
+    /// @param count The number of frames.
+    /// @param framesPerSecond The playback rate.
+    /// @param loop true to play the sequence again when it
+    /// ends.
+    /// @return true in success, false otherwise.
+    bool open(const std::string &pattern, int first,
+      int count, double framesPerSecond, bool loop = false);
+    /// @brief Stop the playback and free the frames.
+    void close();
+    /// @brief Set the area of the player.
+    /// @param playerArea The area of the player.
+    void setArea(const SDL_Rect &playerArea);
+    /// @brief Get the area of the player.
+    /// @return The area of the player.
+    const SDL_Rect &getArea() const;
+    /// @brief Pause the playback.
+    void pause();
+    /// @brief Resume the playback.
+    void resume();
+    /// @brief Query if the playback is paused.
+    /// @return true if it's paused.
+    bool isPaused() const;
+    /// @brief Query if a sequence without loop ended.
+    /// @return true if it ended.
+    bool isFinished() const;
+    /// @brief Get the frames that weren't shown because
+    /// the player was late.
+    /// @return The number of dropped frames.
+    Uint64 getDroppedFrames() const;
+    /// @brief Get the name of the texture of the player,
+    /// to draw it with the texture manager.
+    /// @return The name of the texture.
+    const std::string &getTextureName() const;
+    /// @brief Show the frame due at the current time.
+    ///
+    /// render() calls it, call it if the texture is drawn
+    /// in other way.
+    void update();
+    /// @brief Overriden funtion to render the widget.
+    void render() override;
+    /// @brief Copy operator deleted.
+    const Flipbook &operator=(const Flipbook &) = delete;
+
+  private:
+    /// @brief A decoded frame.
+    struct Frame
+    {
+      /// @brief The number of the frame since the start.
+      Uint64 number;
+      /// @brief The pixels in ARGB8888.
+      SDL_Surface *surface;
+    };
+    /// @brief The loop of the decoder thread.
+    void decode();
+    /// @brief Copy a frame into the texture.
+    /// @param surface The pixels of the frame.
+    void show(SDL_Surface *surface);
+    /// @brief Get the frame due at the current time.
+    /// @return The number of the frame.
+    Uint64 getDueFrame() const;
+    /// @brief The area of the player.
+    SDL_Rect area = {0, 0, 0, 0};
+    /// @brief The paths of the frames.
+    std::vector<std::string> paths;
+    /// @brief The playback rate.
+    double rate = 0;
+    /// @brief Indicator to know if the sequence loops.
+    bool looping = false;
+    /// @brief The name of the texture.
+    std::string textureName;
+    /// @brief Indicator to know if a sequence is open.
+    bool opened = false;
+    /// @brief The decoder thread.
+    std::thread decoder;
+    /// @brief Mutex of the ring and the decoder state.
+    std::mutex ringMutex;
+    /// @brief Condition to wake the decoder.
+    std::condition_variable ringSpace;
+    /// @brief The decoded frames.
+    std::vector<Frame> ring;
+    /// @brief The position of the oldest frame.
+    size_t ringStart = 0;
+    /// @brief The number of decoded frames.
+    size_t ringCount = 0;
+    /// @brief The next frame to decode.
+    Uint64 nextFrame = 0;
+    /// @brief The frame due, the decoder skips the older.
+    Uint64 dueFrame = 0;
+    /// @brief Indicator to stop the decoder.
+    bool stopping = false;
+    /// @brief The frame shown.
+    Uint64 shownFrame = 0;
+    /// @brief The start of the playback.
+    Uint64 startCounter = 0;
+    /// @brief The time when the playback was paused.
+    Uint64 pauseCounter = 0;
+    /// @brief Indicator to know if the playback is paused.
+    bool paused = false;
+    /// @brief Indicator to know if the sequence ended.
+    bool finished = false;
+    /// @brief The frames not shown.
+    Uint64 droppedFrames = 0;
+  };
+
+} // namespace DPGE
+
+#endif
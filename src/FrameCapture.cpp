@@ -0,0 +1,219 @@
+// File: FrameCapture.cpp
+// Author: Duilio Pérez
+// Implementation of the frame capture.
+#include "FrameCapture.hpp"
+#include "Game.hpp"
+#include "PathPattern.hpp"
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_image.h>
+#include <algorithm>
+using namespace DPGE;
+using namespace std;
+
+// Define the instance of the frame capture.
+FrameCapture &DPGE::theFrameCapture =
+  FrameCapture::getInstance();
+
+// Save the next presented frame.
+void FrameCapture::screenshot(const string &path)
+{
+  this->screenshotPath = path;
+}
+
+// Start recording the presented frames.
+void FrameCapture::startRecording(
+  const string &pattern, Uint32 interval)
+{
+  this->recordingPattern  = pattern;
+  this->recordingInterval = max<Uint32>(interval, 1);
+  this->recordingFrames   = 0;
+}
+
+// Stop recording the presented frames.
+void FrameCapture::stopRecording()
+{
+  this->recordingPattern.clear();
+}
+
+// Query if the frames are being recorded.
+bool FrameCapture::isRecording() const
+{
+  return !this->recordingPattern.empty();
+}
+
+// Query if the next presented frame is read.
+bool FrameCapture::isCapturing() const
+{
+  // The frame of the recording that is saved.
+  bool recorded = !this->recordingPattern.empty() &&
+                  this->recordingFrames %
+                      this->recordingInterval ==
+                    0;
+  return !this->screenshotPath.empty() || recorded;
+}
+
+// Set the number of frames that can wait to be encoded.
+void FrameCapture::setQueueDepth(size_t depth)
+{
+  lock_guard<mutex> lock(this->framesMutex);
+  this->queueDepth = max<size_t>(depth, 1);
+  // The buffers over the depth aren't kept.
+  if (this->freeFrames.size() > this->queueDepth)
+    this->freeFrames.resize(this->queueDepth);
+}
+
+// Get the number of dropped captures.
+Uint32 FrameCapture::getDroppedCaptures() const
+{
+  return this->droppedCaptures;
+}
+
+// Read the current frame if it must be saved.
+void FrameCapture::capture()
+{
+  if (!this->screenshotPath.empty())
+  {
+    this->read(this->screenshotPath);
+    this->screenshotPath.clear();
+  }
+  if (this->recordingPattern.empty())
+    return;
+  if (this->recordingFrames % this->recordingInterval == 0)
+    this->read(formatPath(this->recordingPattern,
+      this->recordingFrames / this->recordingInterval));
+  this->recordingFrames++;
+}
+
+// Stop the encoder thread.
+void FrameCapture::stop()
+{
+  if (!this->encoder.joinable())
+    return;
+  {
+    lock_guard<mutex> lock(this->framesMutex);
+    this->stopping = true;
+  }
+  this->framesQueued.notify_one();
+  this->encoder.join();
+  this->stopping = false;
+}
+
+// Get the instance of the class.
+FrameCapture &FrameCapture::getInstance()
+{
+  static FrameCapture theInstance;
+  return theInstance;
+}
+
+// Destructor.
+FrameCapture::~FrameCapture()
+{
+  this->stop();
+}
+
+// Read the current frame.
+void FrameCapture::read(const string &path)
+{
+  // The renderer of the game.
+  SDL_Renderer *renderer = theGame.getRenderer();
+  // The buffer of the frame.
+  unique_ptr<Frame> frame;
+  // The size of the frame.
+  int width = 0, height = 0;
+  // The area to read, all the output.
+  SDL_Rect area;
+  // The viewport of the renderer.
+  SDL_Rect viewport;
+  // The scale of the renderer.
+  float scaleX = 1, scaleY = 1;
+  // The result of the reading.
+  int result = 0;
+  SDL_GetRendererOutputSize(renderer, &width, &height);
+  if (width <= 0 || height <= 0)
+    return;
+  {
+    lock_guard<mutex> lock(this->framesMutex);
+    if (this->busyFrames >= this->queueDepth)
+    {
+      this->droppedCaptures++;
+      return;
+    }
+    this->busyFrames++;
+    if (!this->freeFrames.empty())
+    {
+      frame = move(this->freeFrames.back());
+      this->freeFrames.pop_back();
+    }
+  }
+  if (!frame)
+    frame.reset(new Frame);
+  frame->width  = width;
+  frame->height = height;
+  frame->path   = path;
+  frame->pixels.resize(
+    static_cast<size_t>(width) * height * 4);
+  // The pixels are read out of the viewport too.
+  area = {0, 0, width, height};
+  SDL_RenderGetViewport(renderer, &viewport);
+  SDL_RenderGetScale(renderer, &scaleX, &scaleY);
+  SDL_RenderSetScale(renderer, 1, 1);
+  SDL_RenderSetViewport(renderer, nullptr);
+  result = SDL_RenderReadPixels(renderer, &area,
+    SDL_PIXELFORMAT_RGB888, frame->pixels.data(),
+    width * 4);
+  SDL_RenderSetScale(renderer, scaleX, scaleY);
+  SDL_RenderSetViewport(renderer, &viewport);
+  if (result < 0)
+  {
+    SDL_LogError(SDL_LOG_CATEGORY_ERROR,
+      "Error capturing a frame: %s.\n", SDL_GetError());
+    lock_guard<mutex> lock(this->framesMutex);
+    this->freeFrames.push_back(move(frame));
+    this->busyFrames--;
+    return;
+  }
+  {
+    lock_guard<mutex> lock(this->framesMutex);
+    this->pendingFrames.push_back(move(frame));
+  }
+  // The encoder is started by the first capture.
+  if (!this->encoder.joinable())
+    this->encoder = thread(&FrameCapture::encode, this);
+  this->framesQueued.notify_one();
+}
+
+// The loop of the encoder thread.
+void FrameCapture::encode()
+{
+  // The frame to encode.
+  unique_ptr<Frame> frame;
+  // The surface of the frame.
+  SDL_Surface *surface = nullptr;
+  unique_lock<mutex> lock(this->framesMutex);
+  while (true)
+  {
+    this->framesQueued.wait(lock, [this] {
+      return this->stopping || !this->pendingFrames.empty();
+    });
+    // The queued frames are saved before stopping.
+    if (this->pendingFrames.empty())
+      return;
+    frame = move(this->pendingFrames.front());
+    this->pendingFrames.pop_front();
+    lock.unlock();
+    surface = SDL_CreateRGBSurfaceWithFormatFrom(
+      frame->pixels.data(), frame->width, frame->height, 32,
+      frame->width * 4, SDL_PIXELFORMAT_RGB888);
+    if (!surface ||
+        IMG_SavePNG(surface, frame->path.c_str()) < 0)
+      SDL_LogError(SDL_LOG_CATEGORY_ERROR,
+        "Error saving a frame in %s: %s.\n",
+        frame->path.c_str(), SDL_GetError());
+    SDL_FreeSurface(surface);
+    lock.lock();
+    if (this->freeFrames.size() < this->queueDepth)
+      this->freeFrames.push_back(move(frame));
+    frame.reset();
+    this->busyFrames--;
+  }
+}
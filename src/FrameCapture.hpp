@@ -0,0 +1,136 @@
+/// @file FrameCapture.hpp
+/// @author Duilio Pérez
+/// @brief Screenshots and recordings saved in the
+/// background.
+#ifndef FRAMECAPTURE_HPP
+#define FRAMECAPTURE_HPP true
+#include <SDL2/SDL.h>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace DPGE
+{
+
+  /// @brief A capturer of the presented frames.
+  ///
+  /// The texture manager reads the captured frames just
+  /// before presenting them, into buffers that are reused,
+  /// and a thread encodes them as PNG files, so the game
+  /// loop only waits for the read. When too many frames
+  /// wait to be encoded, the new captures are dropped.
+  class FrameCapture final
+  {
+  public:
+    /// @brief Copy constructor deleted.
+    FrameCapture(const FrameCapture &) = delete;
+    /// @brief Save the next presented frame.
+    /// @param path The path of the PNG file.
+    void screenshot(const std::string &path);
+    /// @brief Save the presented frames until the
+    /// recording is stopped.
+    /// @param pattern The path of the PNG files, with a
+    /// conversion for the number of the frame, like
+    /// "replay/%05u.png". Only the first %u, %d or %i is
+    /// replaced, padded with zeros to its width, and %%
+    /// gives a %.
+    /// @param interval Save a frame of every interval.
+    ///
+    /// The number of a frame is the number of intervals
+    /// since the start, so the dropped frames leave gaps.
+    void startRecording(
+      const std::string &pattern, Uint32 interval = 1);
+    /// @brief Stop saving the presented frames.
+    void stopRecording();
+    /// @brief Query if the frames are being recorded.
+    /// @return true if they are being recorded.
+    bool isRecording() const;
+    /// @brief Query if the next presented frame is read.
+    /// @return true if it's saved.
+    bool isCapturing() const;
+    /// @brief Set the number of frames that can wait to be
+    /// encoded.
+    /// @param depth The number of frames, 3 by default.
+    void setQueueDepth(size_t depth);
+    /// @brief Get the number of dropped captures.
+    /// @return The number of captures dropped because the
+    /// queue was full.
+    Uint32 getDroppedCaptures() const;
+    /// @brief Read the current frame if it must be saved.
+    ///
+    /// The texture manager calls it before presenting the
+    /// scene.
+    void capture();
+    /// @brief Wait until the captured frames are saved and
+    /// stop the encoder thread.
+    void stop();
+    /// @brief Get the instance of the class.
+    static FrameCapture &getInstance();
+    /// @brief Copy operator deleted.
+    const FrameCapture &operator=(
+      const FrameCapture &) = delete;
+
+  private:
+    /// @brief The pixels of a captured frame.
+    struct Frame
+    {
+      /// @brief The pixels, in RGB888 format.
+      std::vector<Uint8> pixels;
+      /// @brief The width of the frame.
+      int width = 0;
+      /// @brief The height of the frame.
+      int height = 0;
+      /// @brief The path of the file.
+      std::string path;
+    };
+    /// @brief Default constructor.
+    FrameCapture() = default;
+    /// @brief Destructor, it stops the encoder thread.
+    ~FrameCapture();
+    /// @brief Read the current frame into a buffer and
+    /// queue it.
+    /// @param path The path of the file.
+    void read(const std::string &path);
+    /// @brief The loop of the encoder thread.
+    void encode();
+    /// @brief The path of the next screenshot, empty if
+    /// there isn't.
+    std::string screenshotPath;
+    /// @brief The path pattern of the recording, empty if
+    /// there isn't.
+    std::string recordingPattern;
+    /// @brief The interval between recorded frames.
+    Uint32 recordingInterval = 1;
+    /// @brief The frames presented since the recording
+    /// started.
+    Uint32 recordingFrames = 0;
+    /// @brief The captures dropped.
+    Uint32 droppedCaptures = 0;
+    /// @brief The maximum number of frames being saved.
+    size_t queueDepth = 3;
+    /// @brief The number of frames being saved.
+    size_t busyFrames = 0;
+    /// @brief The buffers ready to be reused.
+    std::vector<std::unique_ptr<Frame>> freeFrames;
+    /// @brief The frames waiting to be encoded.
+    std::deque<std::unique_ptr<Frame>> pendingFrames;
+    /// @brief The encoder thread.
+    std::thread encoder;
+    /// @brief Mutex of the buffers.
+    std::mutex framesMutex;
+    /// @brief Condition to wake the encoder.
+    std::condition_variable framesQueued;
+    /// @brief Indicator to know if the encoder must finish.
+    bool stopping = false;
+  };
+
+  /// @brief The frame capture instance.
+  extern FrameCapture &theFrameCapture;
+
+} // namespace DPGE
+
+#endif
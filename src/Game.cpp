@@ -2,8 +2,12 @@
 // Author: Duilio Pérez.
 // Implementation of class Game.
 #include "Game.hpp"
+#include "AssetWatcher.hpp"
 #include "AudioManager.hpp"
+#include "FrameCapture.hpp"
 #include "GameStateManager.hpp"
+#include "TextRasterizer.hpp"
+#include "TextureManager.hpp"
 #include <SDL2/SDL.h>
 #include <SDL2/SDL_image.h>
 #include <SDL2/SDL_mixer.h>
@@ -16,7 +20,8 @@ DPGE::GameProperties DPGE::gameProperties = {
   true, MIX_DEFAULT_FREQUENCY, MIX_DEFAULT_FORMAT,
   MIX_DEFAULT_CHANNELS, 2048, "DPGE",
   SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED, 640, 360,
-  SDL_WINDOW_SHOWN, -1, SDL_RENDERER_ACCELERATED};
+  SDL_WINDOW_SHOWN, -1, SDL_RENDERER_ACCELERATED, false,
+  false};
 
 // Initialize the reference to the game's instance.
 Game &DPGE::theGame = Game::getInstace();
@@ -36,6 +41,7 @@ static void emscriptenMainLoop()
     emscripten_cancel_main_loop();
   }
   // Regular functions.
+  theAssetWatcher.poll();
   theGameStateManager.handleEvents();
   theGameStateManager.update();
   theGameStateManager.render();
@@ -90,6 +96,8 @@ void Game::initialize()
       SDL_GetError());
     return;
   }
+  theTextureManager.setTileRasterizer(
+    gameProperties.tileRasterizer);
   // Initialize SDL2_image if is requested.
   if (gameProperties.imagePluginSupport)
   {
@@ -141,6 +149,9 @@ void Game::initialize()
     else
       this->audioPluginWasInit = true;
   }
+  // Watch the files of the assets if is requested.
+  if (gameProperties.hotReload)
+    theAssetWatcher.start();
   // Set initialization flag to true.
   this->isGameRunning = true;
 }
@@ -155,6 +166,7 @@ void Game::run()
   // Normal game loop.
   while (this->isRunning())
   {
+    theAssetWatcher.poll();
     theGameStateManager.handleEvents();
     theGameStateManager.update();
     theGameStateManager.render();
@@ -171,6 +183,12 @@ bool Game::isRunning()
 // Deinitialize the game.
 void Game::deinitialize()
 {
+  // Stop watching the files of the assets.
+  theAssetWatcher.stop();
+  // Save the captured frames.
+  theFrameCapture.stop();
+  // Stop rasterizing texts before closing SDL2_ttf.
+  theTextRasterizer.stop();
   // Clear the audio manager.
   theAudioManager.clear();
   // Set the game state to nullptr to delete all if there
@@ -191,6 +209,7 @@ void Game::deinitialize()
   // Destroy the renderer.
   if (this->renderer)
   {
+    theTextureManager.setTileRasterizer(false);
     SDL_DestroyRenderer(this->renderer);
     this->renderer = nullptr;
   }
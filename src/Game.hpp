@@ -99,6 +99,12 @@ namespace DPGE
     int rendererIndex;
     /// @brief Renderer flags.
     SDL_RendererFlags rendererFlags;
+    /// @brief Draw the textures with the tile rasterizer,
+    /// useful with the software renderer.
+    bool tileRasterizer;
+    /// @brief Reload the assets when their files change,
+    /// useful while developing, only on Linux.
+    bool hotReload;
   } gameProperties;
 
   /// @brief The instace of the class Game.
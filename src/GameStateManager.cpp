@@ -4,6 +4,7 @@
 #include "GameStateManager.hpp"
 #include "Game.hpp"
 #include "GameState.hpp"
+#include "TextureManager.hpp"
 using namespace DPGE;
 
 // Define the reference to the game state manager.
@@ -57,6 +58,10 @@ void GameStateManager::handleEvents()
   // Handle the events while they're happenning.
   while (SDL_PollEvent(&this->topEvent))
   {
+    // The content of the layers is lost when the targets
+    // are reset.
+    if (this->topEvent.type == SDL_RENDER_TARGETS_RESET)
+      theTextureManager.markLayersDirty();
     // If there is no game state, send a request to quit.
     if (this->gameStates.empty())
       theGame.exit();
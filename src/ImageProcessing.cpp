@@ -0,0 +1,624 @@
+// File: ImageProcessing.cpp
+// Author: Duilio Pérez
+// Implementation of the image preprocessing functions.
+#include "ImageProcessing.hpp"
+#include <SDL2/SDL.h>
+#if defined(__GNUC__) && defined(__SSE2__)
+#define DPGE_SSE2 true
+#include <immintrin.h>
+#endif
+using namespace DPGE;
+using namespace std;
+
+namespace
+{
+
+  // How to move the channels between two formats.
+  struct ChannelMap
+  {
+    // The number of channels to move.
+    int count = 0;
+    // The shifts of the channels in the source.
+    int from[4];
+    // The shifts of the channels in the destination.
+    int to[4];
+    // The bits of the channels missing in the source.
+    Uint32 fill = 0;
+  };
+
+  // Make the map of the channels between two formats.
+  ChannelMap makeChannelMap(
+    const SDL_PixelFormat &from, const SDL_PixelFormat &to)
+  {
+    // The masks and shifts of every channel.
+    const Uint32 fromMasks[4] = {
+      from.Rmask, from.Gmask, from.Bmask, from.Amask};
+    const Uint32 toMasks[4] = {
+      to.Rmask, to.Gmask, to.Bmask, to.Amask};
+    const int fromShifts[4] = {
+      from.Rshift, from.Gshift, from.Bshift, from.Ashift};
+    const int toShifts[4] = {
+      to.Rshift, to.Gshift, to.Bshift, to.Ashift};
+    // The map to make.
+    ChannelMap map;
+    for (int i = 0; i < 4; i++)
+    {
+      if (!toMasks[i])
+        continue;
+      if (!fromMasks[i])
+        map.fill |= 0xFFu << toShifts[i];
+      else
+      {
+        map.from[map.count] = fromShifts[i];
+        map.to[map.count]   = toShifts[i];
+        map.count++;
+      }
+    }
+    return map;
+  }
+
+  // Query if a format has 32 bits and channels of 8 bits.
+  bool hasByteChannels(const SDL_PixelFormat &format)
+  {
+    // The masks and shifts of every channel.
+    const Uint32 masks[4] = {format.Rmask, format.Gmask,
+      format.Bmask, format.Amask};
+    const int shifts[4] = {format.Rshift, format.Gshift,
+      format.Bshift, format.Ashift};
+    if (format.BytesPerPixel != 4 || format.palette)
+      return false;
+    for (int i = 0; i < 4; i++)
+      if (masks[i] && masks[i] >> shifts[i] != 0xFF)
+        return false;
+    return true;
+  }
+
+  // Convert a pixel.
+  inline Uint32 convertPixel(
+    Uint32 pixel, const ChannelMap &map)
+  {
+    // The converted pixel.
+    Uint32 result = map.fill;
+    for (int i = 0; i < map.count; i++)
+      result |= ((pixel >> map.from[i]) & 0xFF)
+                << map.to[i];
+    return result;
+  }
+
+  // Multiply a channel by the alpha, rounding as x / 255.
+  inline Uint32 multiplyChannel(
+    Uint32 channel, Uint32 alpha)
+  {
+    // The product with bias.
+    Uint32 product = channel * alpha + 128;
+    return (product + (product >> 8)) >> 8;
+  }
+
+  // Premultiply a pixel.
+  inline Uint32 premultiplyPixel(
+    Uint32 pixel, int alphaShift)
+  {
+    // The alpha of the pixel.
+    Uint32 alpha = (pixel >> alphaShift) & 0xFF;
+    // The premultiplied pixel.
+    Uint32 result = alpha << alphaShift;
+    for (int shift = 0; shift < 32; shift += 8)
+      if (shift != alphaShift)
+        result |=
+          multiplyChannel((pixel >> shift) & 0xFF, alpha)
+          << shift;
+    return result;
+  }
+
+  // Average two pixels byte by byte, rounding up.
+  inline Uint32 averagePixels(Uint32 first, Uint32 second)
+  {
+    return (first | second) -
+           (((first ^ second) >> 1) & 0x7F7F7F7F);
+  }
+
+  // Convert pixels one by one.
+  void convertScalar(const Uint32 *src, Uint32 *dest,
+    size_t count, const ChannelMap &map)
+  {
+    for (size_t i = 0; i < count; i++)
+      dest[i] = convertPixel(src[i], map);
+  }
+
+  // Premultiply pixels one by one.
+  void premultiplyScalar(
+    Uint32 *pixels, size_t count, int alphaShift)
+  {
+    for (size_t i = 0; i < count; i++)
+      pixels[i] = premultiplyPixel(pixels[i], alphaShift);
+  }
+
+  // Reduce a row of blocks of 2x2 pixels one by one.
+  void halveRowScalar(const Uint32 *top,
+    const Uint32 *bottom, Uint32 *dest, int from, int to)
+  {
+    for (int x = from; x < to; x++)
+      dest[x] = averagePixels(
+        averagePixels(top[2 * x], bottom[2 * x]),
+        averagePixels(top[2 * x + 1], bottom[2 * x + 1]));
+  }
+
+  // Query if the pixels of a row are opaque.
+  bool isRowOpaqueScalar(const Uint32 *pixels, size_t from,
+    size_t to, Uint32 mask)
+  {
+    for (size_t x = from; x < to; x++)
+      if ((pixels[x] & mask) != mask)
+        return false;
+    return true;
+  }
+
+#ifdef DPGE_SSE2
+
+  // Query if the pixels of a row are opaque four by four.
+  size_t isRowOpaqueSSE2(const Uint32 *pixels, size_t count,
+    Uint32 mask, bool &opaque)
+  {
+    // The alpha mask in every pixel.
+    const __m128i alpha = _mm_set1_epi32(mask);
+    // The pixels with all their alpha bits.
+    __m128i covered = _mm_set1_epi32(-1);
+    // The index of the next pixel.
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4)
+      covered = _mm_and_si128(covered,
+        _mm_loadu_si128(
+          reinterpret_cast<const __m128i *>(pixels + i)));
+    covered = _mm_cmpeq_epi32(
+      _mm_and_si128(covered, alpha), alpha);
+    opaque  = _mm_movemask_epi8(covered) == 0xFFFF;
+    return i;
+  }
+
+  // Convert pixels four by four.
+  size_t convertSSE2(const Uint32 *src, Uint32 *dest,
+    size_t count, const ChannelMap &map)
+  {
+    // The constants of the conversion.
+    const __m128i byteMask = _mm_set1_epi32(0xFF);
+    const __m128i fill     = _mm_set1_epi32(map.fill);
+    __m128i       from[4], to[4];
+    // The index of the next pixel.
+    size_t i = 0;
+    for (int c = 0; c < map.count; c++)
+    {
+      from[c] = _mm_cvtsi32_si128(map.from[c]);
+      to[c]   = _mm_cvtsi32_si128(map.to[c]);
+    }
+    for (; i + 4 <= count; i += 4)
+    {
+      __m128i pixels = _mm_loadu_si128(
+        reinterpret_cast<const __m128i *>(src + i));
+      __m128i result = fill;
+      for (int c = 0; c < map.count; c++)
+        result = _mm_or_si128(result,
+          _mm_sll_epi32(_mm_and_si128(
+                          _mm_srl_epi32(pixels, from[c]),
+                          byteMask),
+            to[c]));
+      _mm_storeu_si128(
+        reinterpret_cast<__m128i *>(dest + i), result);
+    }
+    return i;
+  }
+
+  // Premultiply two pixels unpacked to 16 bits.
+  template <int lane>
+  inline __m128i premultiplyUnpacked(__m128i pixels)
+  {
+    // The alpha lanes of the two pixels.
+    const __m128i alphaLanes = _mm_set_epi16(
+      lane == 3 ? -1 : 0, lane == 2 ? -1 : 0,
+      lane == 1 ? -1 : 0, lane == 0 ? -1 : 0,
+      lane == 3 ? -1 : 0, lane == 2 ? -1 : 0,
+      lane == 1 ? -1 : 0, lane == 0 ? -1 : 0);
+    // The alpha in every lane, and 255 in the alpha lane
+    // to keep it.
+    __m128i alpha = _mm_shufflehi_epi16(
+      _mm_shufflelo_epi16(
+        pixels, _MM_SHUFFLE(lane, lane, lane, lane)),
+      _MM_SHUFFLE(lane, lane, lane, lane));
+    alpha = _mm_or_si128(
+      _mm_andnot_si128(alphaLanes, alpha),
+      _mm_and_si128(alphaLanes, _mm_set1_epi16(255)));
+    // The product with bias.
+    __m128i product = _mm_add_epi16(
+      _mm_mullo_epi16(pixels, alpha), _mm_set1_epi16(128));
+    return _mm_srli_epi16(
+      _mm_add_epi16(product, _mm_srli_epi16(product, 8)),
+      8);
+  }
+
+  // Premultiply pixels four by four.
+  template <int lane>
+  size_t premultiplySSE2(Uint32 *pixels, size_t count)
+  {
+    // The index of the next pixel.
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+      __m128i *address =
+        reinterpret_cast<__m128i *>(pixels + i);
+      __m128i next = _mm_loadu_si128(address);
+      __m128i low  = premultiplyUnpacked<lane>(
+        _mm_unpacklo_epi8(next, _mm_setzero_si128()));
+      __m128i high = premultiplyUnpacked<lane>(
+        _mm_unpackhi_epi8(next, _mm_setzero_si128()));
+      _mm_storeu_si128(
+        address, _mm_packus_epi16(low, high));
+    }
+    return i;
+  }
+
+  // Reduce a row of blocks of 2x2 pixels, producing four
+  // pixels at once.
+  int halveRowSSE2(const Uint32 *top, const Uint32 *bottom,
+    Uint32 *dest, int width)
+  {
+    // The index of the next reduced pixel.
+    int x = 0;
+    for (; x + 4 <= width; x += 4)
+    {
+      // The pixels of the two rows.
+      const __m128i *upper =
+        reinterpret_cast<const __m128i *>(top + 2 * x);
+      const __m128i *lower =
+        reinterpret_cast<const __m128i *>(bottom + 2 * x);
+      // The vertical averages.
+      __m128 first = _mm_castsi128_ps(_mm_avg_epu8(
+        _mm_loadu_si128(upper), _mm_loadu_si128(lower)));
+      __m128 second = _mm_castsi128_ps(_mm_avg_epu8(
+        _mm_loadu_si128(upper + 1),
+        _mm_loadu_si128(lower + 1)));
+      // The horizontal averages.
+      __m128i even = _mm_castps_si128(_mm_shuffle_ps(
+        first, second, _MM_SHUFFLE(2, 0, 2, 0)));
+      __m128i odd = _mm_castps_si128(_mm_shuffle_ps(
+        first, second, _MM_SHUFFLE(3, 1, 3, 1)));
+      _mm_storeu_si128(
+        reinterpret_cast<__m128i *>(dest + x),
+        _mm_avg_epu8(even, odd));
+    }
+    return x;
+  }
+
+#if defined(__x86_64__) || defined(__i386__)
+#define DPGE_AVX2 true
+
+  // Convert pixels eight by eight.
+  __attribute__((target("avx2"))) size_t convertAVX2(
+    const Uint32 *src, Uint32 *dest, size_t count,
+    const ChannelMap &map)
+  {
+    // The constants of the conversion.
+    const __m256i byteMask = _mm256_set1_epi32(0xFF);
+    const __m256i fill     = _mm256_set1_epi32(map.fill);
+    __m128i       from[4], to[4];
+    // The index of the next pixel.
+    size_t i = 0;
+    for (int c = 0; c < map.count; c++)
+    {
+      from[c] = _mm_cvtsi32_si128(map.from[c]);
+      to[c]   = _mm_cvtsi32_si128(map.to[c]);
+    }
+    for (; i + 8 <= count; i += 8)
+    {
+      __m256i pixels = _mm256_loadu_si256(
+        reinterpret_cast<const __m256i *>(src + i));
+      __m256i result = fill;
+      for (int c = 0; c < map.count; c++)
+        result = _mm256_or_si256(result,
+          _mm256_sll_epi32(
+            _mm256_and_si256(
+              _mm256_srl_epi32(pixels, from[c]), byteMask),
+            to[c]));
+      _mm256_storeu_si256(
+        reinterpret_cast<__m256i *>(dest + i), result);
+    }
+    return i;
+  }
+
+  // Premultiply four pixels unpacked to 16 bits.
+  template <int lane>
+  __attribute__((target("avx2"))) inline __m256i
+    premultiplyUnpackedAVX2(__m256i pixels)
+  {
+    // The alpha lanes of the four pixels.
+    const __m256i alphaLanes = _mm256_set_epi16(
+      lane == 3 ? -1 : 0, lane == 2 ? -1 : 0,
+      lane == 1 ? -1 : 0, lane == 0 ? -1 : 0,
+      lane == 3 ? -1 : 0, lane == 2 ? -1 : 0,
+      lane == 1 ? -1 : 0, lane == 0 ? -1 : 0,
+      lane == 3 ? -1 : 0, lane == 2 ? -1 : 0,
+      lane == 1 ? -1 : 0, lane == 0 ? -1 : 0,
+      lane == 3 ? -1 : 0, lane == 2 ? -1 : 0,
+      lane == 1 ? -1 : 0, lane == 0 ? -1 : 0);
+    // The alpha in every lane, and 255 in the alpha lane
+    // to keep it.
+    __m256i alpha = _mm256_shufflehi_epi16(
+      _mm256_shufflelo_epi16(
+        pixels, _MM_SHUFFLE(lane, lane, lane, lane)),
+      _MM_SHUFFLE(lane, lane, lane, lane));
+    alpha = _mm256_or_si256(
+      _mm256_andnot_si256(alphaLanes, alpha),
+      _mm256_and_si256(alphaLanes, _mm256_set1_epi16(255)));
+    // The product with bias.
+    __m256i product =
+      _mm256_add_epi16(_mm256_mullo_epi16(pixels, alpha),
+        _mm256_set1_epi16(128));
+    return _mm256_srli_epi16(
+      _mm256_add_epi16(
+        product, _mm256_srli_epi16(product, 8)),
+      8);
+  }
+
+  // Premultiply pixels eight by eight.
+  template <int lane>
+  __attribute__((target("avx2"))) size_t premultiplyAVX2(
+    Uint32 *pixels, size_t count)
+  {
+    // The index of the next pixel.
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8)
+    {
+      __m256i *address =
+        reinterpret_cast<__m256i *>(pixels + i);
+      __m256i next = _mm256_loadu_si256(address);
+      __m256i low  = premultiplyUnpackedAVX2<lane>(
+        _mm256_unpacklo_epi8(next, _mm256_setzero_si256()));
+      __m256i high = premultiplyUnpackedAVX2<lane>(
+        _mm256_unpackhi_epi8(next, _mm256_setzero_si256()));
+      _mm256_storeu_si256(
+        address, _mm256_packus_epi16(low, high));
+    }
+    return i;
+  }
+
+  // Reduce a row of blocks of 2x2 pixels, producing eight
+  // pixels at once.
+  __attribute__((target("avx2"))) int halveRowAVX2(
+    const Uint32 *top, const Uint32 *bottom, Uint32 *dest,
+    int width)
+  {
+    // The index of the next reduced pixel.
+    int x = 0;
+    for (; x + 8 <= width; x += 8)
+    {
+      // The pixels of the two rows.
+      const __m256i *upper =
+        reinterpret_cast<const __m256i *>(top + 2 * x);
+      const __m256i *lower =
+        reinterpret_cast<const __m256i *>(bottom + 2 * x);
+      // The vertical averages.
+      __m256 first = _mm256_castsi256_ps(_mm256_avg_epu8(
+        _mm256_loadu_si256(upper),
+        _mm256_loadu_si256(lower)));
+      __m256 second = _mm256_castsi256_ps(_mm256_avg_epu8(
+        _mm256_loadu_si256(upper + 1),
+        _mm256_loadu_si256(lower + 1)));
+      // The shuffle works by lanes of 128 bits, so the
+      // quarters are reordered after it.
+      __m256i even = _mm256_permute4x64_epi64(
+        _mm256_castps_si256(_mm256_shuffle_ps(
+          first, second, _MM_SHUFFLE(2, 0, 2, 0))),
+        _MM_SHUFFLE(3, 1, 2, 0));
+      __m256i odd = _mm256_permute4x64_epi64(
+        _mm256_castps_si256(_mm256_shuffle_ps(
+          first, second, _MM_SHUFFLE(3, 1, 3, 1))),
+        _MM_SHUFFLE(3, 1, 2, 0));
+      _mm256_storeu_si256(
+        reinterpret_cast<__m256i *>(dest + x),
+        _mm256_avg_epu8(even, odd));
+    }
+    return x;
+  }
+
+#endif
+#endif
+
+  // Query if the processor supports AVX2.
+  bool useAVX2()
+  {
+#ifdef DPGE_AVX2
+    static const bool hasAVX2 = SDL_HasAVX2();
+    return hasAVX2;
+#else
+    return false;
+#endif
+  }
+
+} // namespace
+
+// Convert pixels between formats.
+void DPGE::convertPixels(const Uint32 *src, Uint32 *dest,
+  size_t count, const SDL_PixelFormat &from,
+  const SDL_PixelFormat &to)
+{
+  // The map of the channels.
+  ChannelMap map = makeChannelMap(from, to);
+  // The pixels already converted.
+  size_t done = 0;
+#ifdef DPGE_AVX2
+  if (useAVX2())
+    done = convertAVX2(src, dest, count, map);
+#endif
+#ifdef DPGE_SSE2
+  done += convertSSE2(src + done, dest + done,
+    count - done, map);
+#endif
+  convertScalar(src + done, dest + done, count - done, map);
+}
+
+// Premultiply the color of pixels.
+void DPGE::premultiplyAlpha(Uint32 *pixels, size_t count,
+  const SDL_PixelFormat &format)
+{
+  // The pixels already premultiplied.
+  size_t done = 0;
+  if (!format.Amask)
+    return;
+#ifdef DPGE_AVX2
+  if (useAVX2())
+    switch (format.Ashift)
+    {
+    case 0:
+      done = premultiplyAVX2<0>(pixels, count);
+      break;
+    case 8:
+      done = premultiplyAVX2<1>(pixels, count);
+      break;
+    case 16:
+      done = premultiplyAVX2<2>(pixels, count);
+      break;
+    case 24:
+      done = premultiplyAVX2<3>(pixels, count);
+      break;
+    }
+#endif
+#ifdef DPGE_SSE2
+  switch (format.Ashift)
+  {
+  case 0:
+    done += premultiplySSE2<0>(pixels + done, count - done);
+    break;
+  case 8:
+    done += premultiplySSE2<1>(pixels + done, count - done);
+    break;
+  case 16:
+    done += premultiplySSE2<2>(pixels + done, count - done);
+    break;
+  case 24:
+    done += premultiplySSE2<3>(pixels + done, count - done);
+    break;
+  }
+#endif
+  premultiplyScalar(pixels + done, count - done,
+    format.Ashift);
+}
+
+// Reduce an image to the half of its size.
+void DPGE::halveImage(const Uint32 *src, int srcPitch,
+  int width, int height, Uint32 *dest, int destPitch)
+{
+  // The rows to reduce.
+  const Uint8 *top = reinterpret_cast<const Uint8 *>(src);
+  // The row to write.
+  Uint8 *row = reinterpret_cast<Uint8 *>(dest);
+  // The pixels already reduced in a row.
+  int done = 0;
+  for (int y = 0; y < (height + 1) / 2; y++)
+  {
+    const Uint32 *first =
+      reinterpret_cast<const Uint32 *>(top);
+    // The last row of an odd height is used twice.
+    const Uint32 *second = reinterpret_cast<const Uint32 *>(
+      2 * y + 1 < height ? top + srcPitch : top);
+    Uint32 *reduced = reinterpret_cast<Uint32 *>(row);
+    done            = 0;
+#ifdef DPGE_AVX2
+    if (useAVX2())
+      done =
+        halveRowAVX2(first, second, reduced, width / 2);
+#endif
+#ifdef DPGE_SSE2
+    done += halveRowSSE2(first + 2 * done,
+      second + 2 * done, reduced + done, width / 2 - done);
+#endif
+    halveRowScalar(first, second, reduced, done, width / 2);
+    // The last column of an odd width is used twice.
+    if (width % 2)
+      reduced[width / 2] =
+        averagePixels(first[width - 1], second[width - 1]);
+    top += 2 * srcPitch;
+    row += destPitch;
+  }
+}
+
+// Convert a surface to a format of 32 bits.
+SDL_Surface *DPGE::convertSurface(
+  SDL_Surface *surface, Uint32 format)
+{
+  // The converted surface.
+  SDL_Surface *converted = SDL_CreateRGBSurfaceWithFormat(
+    0, surface->w, surface->h, 32, format);
+  if (!converted)
+    return nullptr;
+  // SDL converts the formats that don't have channels of
+  // 8 bits.
+  // SDL turns the color key into transparent pixels.
+  if (!hasByteChannels(*surface->format) ||
+      !hasByteChannels(*converted->format) ||
+      SDL_MUSTLOCK(surface) || SDL_HasColorKey(surface))
+  {
+    SDL_FreeSurface(converted);
+    return SDL_ConvertSurfaceFormat(surface, format, 0);
+  }
+  for (int y = 0; y < surface->h; y++)
+    convertPixels(
+      reinterpret_cast<const Uint32 *>(
+        static_cast<const Uint8 *>(surface->pixels) +
+        y * surface->pitch),
+      reinterpret_cast<Uint32 *>(
+        static_cast<Uint8 *>(converted->pixels) +
+        y * converted->pitch),
+      surface->w, *surface->format, *converted->format);
+  return converted;
+}
+
+// Query if all the pixels of a surface are opaque.
+bool DPGE::isOpaque(SDL_Surface *surface)
+{
+  // The alpha bits of the format.
+  Uint32 mask = surface->format->Amask;
+  // The pixels already scanned in a row.
+  size_t done = 0;
+  // Indicator to know if the scanned pixels are opaque.
+  bool opaque = true;
+  // A color key or a palette can make pixels transparent.
+  if (SDL_HasColorKey(surface) ||
+      (mask && surface->format->BytesPerPixel != 4))
+    return false;
+  if (!mask)
+    return true;
+  if (SDL_MUSTLOCK(surface) && SDL_LockSurface(surface) < 0)
+    return false;
+  for (int y = 0; y < surface->h && opaque; y++)
+  {
+    const Uint32 *row = reinterpret_cast<const Uint32 *>(
+      static_cast<const Uint8 *>(surface->pixels) +
+      y * surface->pitch);
+    done = 0;
+#ifdef DPGE_SSE2
+    done = isRowOpaqueSSE2(row, surface->w, mask, opaque);
+#endif
+    opaque = opaque &&
+             isRowOpaqueScalar(row, done, surface->w, mask);
+  }
+  if (SDL_MUSTLOCK(surface))
+    SDL_UnlockSurface(surface);
+  return opaque;
+}
+
+// Create a surface of the half of the size of other one.
+SDL_Surface *DPGE::halveSurface(SDL_Surface *surface)
+{
+  // The reduced surface.
+  SDL_Surface *reduced = nullptr;
+  if (surface->w < 2 || surface->h < 2 ||
+      surface->format->BytesPerPixel != 4)
+    return nullptr;
+  reduced = SDL_CreateRGBSurfaceWithFormat(0,
+    (surface->w + 1) / 2, (surface->h + 1) / 2, 32,
+    surface->format->format);
+  if (!reduced)
+    return nullptr;
+  halveImage(static_cast<const Uint32 *>(surface->pixels),
+    surface->pitch, surface->w, surface->h,
+    static_cast<Uint32 *>(reduced->pixels), reduced->pitch);
+  return reduced;
+}
@@ -0,0 +1,81 @@
+/// @file ImageProcessing.hpp
+/// @author Duilio Pérez
+/// @brief Functions to prepare the images before creating
+/// their textures.
+#ifndef IMAGEPROCESSING_HPP
+#define IMAGEPROCESSING_HPP true
+#include <SDL2/SDL.h>
+#include <cstddef>
+
+namespace DPGE
+{
+
+  /// @brief The preprocessing of the loaded images.
+  struct ImageOptions
+  {
+    /// @brief Convert the image to the renderer's native
+    /// format, so it isn't converted again when uploaded.
+    bool convertToNative = true;
+    /// @brief Premultiply the color by the alpha.
+    ///
+    /// The textures use a premultiplied blend mode, so it's
+    /// ignored if the renderer doesn't support it, like the
+    /// software renderer.
+    bool premultiplyAlpha = false;
+    /// @brief Create a half resolution variant, used when
+    /// the texture is drawn at half its size or less.
+    bool halfResolution = false;
+  };
+
+  /// @brief Convert pixels between formats of 32 bits with
+  /// channels of 8 bits.
+  /// @param src The pixels to convert.
+  /// @param dest Where to write the converted pixels.
+  /// @param count The number of pixels.
+  /// @param from The format of the source.
+  /// @param to The format of the destination.
+  ///
+  /// A channel missing in the source is filled with 255.
+  void convertPixels(const Uint32 *src, Uint32 *dest,
+    size_t count, const SDL_PixelFormat &from,
+    const SDL_PixelFormat &to);
+  /// @brief Premultiply the color of pixels by their alpha.
+  /// @param pixels The pixels to modify.
+  /// @param count The number of pixels.
+  /// @param format The format of 32 bits of the pixels.
+  void premultiplyAlpha(Uint32 *pixels, size_t count,
+    const SDL_PixelFormat &format);
+  /// @brief Reduce an image to the half of its size
+  /// averaging each block of 2x2 pixels.
+  /// @param src The pixels of the image.
+  /// @param srcPitch The bytes of a row of the image.
+  /// @param width The width of the image.
+  /// @param height The height of the image.
+  /// @param dest The pixels of the reduced image, of
+  /// (width + 1) / 2 by (height + 1) / 2 pixels, the last
+  /// row and column of odd sizes are averaged alone.
+  /// @param destPitch The bytes of a row of the reduced
+  /// image.
+  void halveImage(const Uint32 *src, int srcPitch,
+    int width, int height, Uint32 *dest, int destPitch);
+  /// @brief Convert a surface to a format of 32 bits.
+  /// @param surface The surface to convert, its color key
+  /// becomes transparent if the format has alpha.
+  /// @param format The format of the new surface.
+  /// @return A new surface, or nullptr in error.
+  SDL_Surface *convertSurface(
+    SDL_Surface *surface, Uint32 format);
+  /// @brief Create a surface of the half of the size of
+  /// other one.
+  /// @param surface A surface with a format of 32 bits.
+  /// @return A new surface, or nullptr in error.
+  SDL_Surface *halveSurface(SDL_Surface *surface);
+  /// @brief Query if all the pixels of a surface are
+  /// opaque.
+  /// @param surface The surface to scan.
+  /// @return true if no pixel is transparent.
+  bool isOpaque(SDL_Surface *surface);
+
+} // namespace DPGE
+
+#endif
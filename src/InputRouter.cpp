@@ -0,0 +1,225 @@
+// File: InputRouter.cpp
+// Author: Duilio Pérez
+// Implementation of the input router.
+#include "InputRouter.hpp"
+#include <algorithm>
+using namespace DPGE;
+using namespace std;
+
+// Divide a coordinate rounding towards negative infinity.
+static int getCell(int coordinate, int size)
+{
+  return coordinate >= 0 ? coordinate / size
+                         : (coordinate - size + 1) / size;
+}
+
+// Join the coordinates of a cell in its key.
+static Uint64 joinCell(int x, int y)
+{
+  return static_cast<Uint64>(static_cast<Uint32>(x)) << 32 |
+         static_cast<Uint32>(y);
+}
+
+// Constructor.
+InputRouter::InputRouter(int gridCellSize)
+{
+  this->cellSize = max(gridCellSize, 1);
+}
+
+// Destructor.
+InputRouter::~InputRouter()
+{
+  this->clear();
+}
+
+// Add a button or change its depth.
+void InputRouter::add(Button &button, int depth)
+{
+  // A button is only in a router.
+  if (button.getInputRouter() &&
+      button.getInputRouter() != this)
+    button.getInputRouter()->remove(button);
+  // The entry of the button.
+  Entry &entry = this->entries[&button];
+  if (entry.button)
+    this->erase(entry);
+  entry = {&button, button.getArea(), depth,
+    this->nextOrder++};
+  this->insert(entry);
+  button.setInputRouter(this);
+}
+
+// Remove a button.
+void InputRouter::remove(const Button &button)
+{
+  // The entry of the button.
+  auto entry = this->entries.find(&button);
+  if (entry == this->entries.end())
+    return;
+  this->erase(entry->second);
+  entry->second.button->setInputRouter(nullptr);
+  this->entries.erase(entry);
+  if (this->hovered == &button)
+    this->hovered = nullptr;
+}
+
+// Index the area of a button again.
+void InputRouter::refresh(const Button &button)
+{
+  // The entry of the button.
+  auto entry = this->entries.find(&button);
+  if (entry == this->entries.end())
+    return;
+  this->erase(entry->second);
+  entry->second.area = button.getArea();
+  this->insert(entry->second);
+}
+
+// Remove all the buttons.
+void InputRouter::clear()
+{
+  for (auto &entry : this->entries)
+    entry.second.button->setInputRouter(nullptr);
+  this->entries.clear();
+  this->cells.clear();
+  this->hovered = nullptr;
+}
+
+// Find the topmost button at a point.
+Button *InputRouter::find(int x, int y)
+{
+  // The point.
+  SDL_Point point = {x, y};
+  // The topmost entry found.
+  const Entry *topmost = nullptr;
+  // The buttons of the cell.
+  auto cell =
+    this->cells.find(joinCell(getCell(x, this->cellSize),
+      getCell(y, this->cellSize)));
+  if (cell == this->cells.end())
+    return nullptr;
+  for (const Entry *entry : cell->second)
+    if (SDL_PointInRect(&point, &entry->area) &&
+        (!topmost || entry->depth > topmost->depth ||
+          (entry->depth == topmost->depth &&
+            entry->order > topmost->order)))
+      topmost = entry;
+  return topmost ? topmost->button : nullptr;
+}
+
+// Get the button under the cursor.
+Button *InputRouter::getHovered() const
+{
+  return this->hovered;
+}
+
+// Route an event to the buttons.
+void InputRouter::handleEvents(const SDL_Event &event)
+{
+  // The buttons that receive the event.
+  vector<Button *> buttons;
+  switch (event.type)
+  {
+  case SDL_MOUSEMOTION:
+    this->setHovered(
+      this->find(event.motion.x, event.motion.y), event);
+    if (this->hovered)
+      this->hovered->handleEvents(event);
+    break;
+  case SDL_MOUSEBUTTONDOWN:
+  case SDL_MOUSEBUTTONUP:
+    this->setHovered(
+      this->find(event.button.x, event.button.y), event);
+    if (this->hovered)
+      this->hovered->handleEvents(event);
+    break;
+  case SDL_MOUSEWHEEL:
+    if (this->hovered)
+      this->hovered->handleEvents(event);
+    break;
+  default:
+    if (event.type == SDL_WINDOWEVENT &&
+        event.window.event == SDL_WINDOWEVENT_LEAVE)
+      this->setHovered(nullptr, event);
+    // The handlers can add and remove buttons, so a copy
+    // of the list is used, reusing the memory of the last
+    // event.
+    buttons.swap(this->dispatched);
+    buttons.clear();
+    for (auto &entry : this->entries)
+      buttons.push_back(entry.second.button);
+    for (Button *button : buttons)
+      if (this->entries.count(button))
+        button->handleEvents(event);
+    buttons.swap(this->dispatched);
+    break;
+  }
+}
+
+// Get the cells covered by an area.
+bool InputRouter::getCells(const SDL_Rect &area,
+  SDL_Point &first, SDL_Point &last) const
+{
+  if (SDL_RectEmpty(&area))
+    return false;
+  first = {getCell(area.x, this->cellSize),
+    getCell(area.y, this->cellSize)};
+  last  = {getCell(area.x + area.w - 1, this->cellSize),
+    getCell(area.y + area.h - 1, this->cellSize)};
+  return true;
+}
+
+// Add a button to the cells of its area.
+void InputRouter::insert(Entry &entry)
+{
+  // The first and last cells of the area.
+  SDL_Point first, last;
+  if (!this->getCells(entry.area, first, last))
+    return;
+  for (int y = first.y; y <= last.y; y++)
+    for (int x = first.x; x <= last.x; x++)
+      this->cells[joinCell(x, y)].push_back(&entry);
+}
+
+// Remove a button from the cells of its area.
+void InputRouter::erase(const Entry &entry)
+{
+  // The first and last cells of the area.
+  SDL_Point first, last;
+  // The buttons of a cell.
+  unordered_map<Uint64, vector<Entry *>>::iterator cell;
+  if (!this->getCells(entry.area, first, last))
+    return;
+  for (int y = first.y; y <= last.y; y++)
+    for (int x = first.x; x <= last.x; x++)
+    {
+      cell = this->cells.find(joinCell(x, y));
+      if (cell == this->cells.end())
+        continue;
+      // Inside the class, remove names
+      // InputRouter::remove, so call std::remove.
+      cell->second.erase(std::remove(cell->second.begin(),
+                           cell->second.end(), &entry),
+        cell->second.end());
+      if (cell->second.empty())
+        this->cells.erase(cell);
+    }
+}
+
+// Change the button under the cursor.
+void InputRouter::setHovered(
+  Button *button, const SDL_Event &event)
+{
+  if (button == this->hovered)
+    return;
+  if (this->hovered)
+    this->hovered->getEventListener().handleEvents(
+      EventType::MOUSELEAVE, event);
+  // The handler of the old button can remove the new one.
+  if (button && !this->entries.count(button))
+    button = nullptr;
+  this->hovered = button;
+  if (button)
+    button->getEventListener().handleEvents(
+      EventType::MOUSEENTER, event);
+}
@@ -0,0 +1,123 @@
+/// @file InputRouter.hpp
+/// @author Duilio Pérez
+/// @brief Routing of the pointer events to the buttons.
+#ifndef INPUTROUTER_HPP
+#define INPUTROUTER_HPP true
+#include "Button.hpp"
+#include <SDL2/SDL.h>
+#include <map>
+#include <unordered_map>
+#include <vector>
+
+namespace DPGE
+{
+
+  /// @brief A router of the events to the buttons.
+  ///
+  /// The areas of the buttons are indexed in a grid, so
+  /// the mouse events are delivered only to the topmost
+  /// button under the cursor without testing all of them.
+  /// When the button under the cursor changes, the old one
+  /// receives a MOUSELEAVE event and the new one a
+  /// MOUSEENTER event. The mouse wheel goes to the button
+  /// under the cursor, and the other events go to all the
+  /// buttons.
+  ///
+  /// The buttons aren't owned, they must be removed before
+  /// they are destroyed. They are refreshed when their area
+  /// changes, and a button is only in a router.
+  class InputRouter final
+  {
+  public:
+    /// @brief Constructor.
+    /// @param gridCellSize The size of the cells of the
+    /// grid in pixels.
+    explicit InputRouter(int gridCellSize = 64);
+    /// @brief Copy constructor deleted.
+    InputRouter(const InputRouter &) = delete;
+    /// @brief Destructor, it removes the buttons.
+    ~InputRouter();
+    /// @brief Add a button or change its depth.
+    /// @param button The button.
+    /// @param depth The depth of the button, the buttons
+    /// with greater depth are above. Between buttons with
+    /// the same depth, the last added is above.
+    ///
+    /// The button is removed from its previous router.
+    void add(Button &button, int depth = 0);
+    /// @brief Remove a button.
+    /// @param button The button.
+    void remove(const Button &button);
+    /// @brief Index the area of a button again.
+    /// @param button The button, after its area changed.
+    ///
+    /// The buttons call it from setArea().
+    void refresh(const Button &button);
+    /// @brief Remove all the buttons.
+    void clear();
+    /// @brief Find the topmost button at a point.
+    /// @param x The x coordinate.
+    /// @param y The y coordinate.
+    /// @return The button, or nullptr if there is none.
+    Button *find(int x, int y);
+    /// @brief Get the button under the cursor.
+    /// @return The button, or nullptr if there is none.
+    Button *getHovered() const;
+    /// @brief Route an event to the buttons.
+    /// @param event The event.
+    ///
+    /// The handlers of the buttons can add and remove
+    /// buttons, the removed ones don't receive the event.
+    void handleEvents(const SDL_Event &event);
+    /// @brief Copy operator deleted.
+    const InputRouter &operator=(
+      const InputRouter &) = delete;
+
+  private:
+    /// @brief A button in the grid.
+    struct Entry
+    {
+      /// @brief The button.
+      Button *button;
+      /// @brief The indexed area.
+      SDL_Rect area;
+      /// @brief The depth of the button.
+      int depth;
+      /// @brief The order of addition.
+      Uint64 order;
+    };
+    /// @brief Get the cells covered by an area.
+    /// @param area The area.
+    /// @param first Where the first cell is saved.
+    /// @param last Where the last cell is saved.
+    /// @return false if the area is empty.
+    bool getCells(const SDL_Rect &area, SDL_Point &first,
+      SDL_Point &last) const;
+    /// @brief Add a button to the cells of its area.
+    /// @param entry The button.
+    void insert(Entry &entry);
+    /// @brief Remove a button from the cells of its area.
+    /// @param entry The button.
+    void erase(const Entry &entry);
+    /// @brief Change the button under the cursor.
+    /// @param button The new button under the cursor.
+    /// @param event The event that moved the cursor.
+    void setHovered(Button *button, const SDL_Event &event);
+    /// @brief The buttons.
+    std::map<const Button *, Entry> entries;
+    /// @brief The buttons that cover every cell.
+    std::unordered_map<Uint64, std::vector<Entry *>> cells;
+    /// @brief The size of the cells.
+    int cellSize;
+    /// @brief The order of the next added button.
+    Uint64 nextOrder = 0;
+    /// @brief The button under the cursor.
+    Button *hovered = nullptr;
+    /// @brief The memory of the list of buttons that
+    /// receive an event.
+    std::vector<Button *> dispatched;
+  };
+
+} // namespace DPGE
+
+#endif
@@ -0,0 +1,274 @@
+// File: LayeredWidget.cpp
+// Author: Duilio Pérez
+// Implementation of the widget drawn with layers.
+#include "LayeredWidget.hpp"
+#include "Game.hpp"
+using namespace DPGE;
+using namespace std;
+
+// Constructor.
+LayeredWidget::LayeredWidget(const SDL_Rect &widgetArea)
+{
+  this->area = widgetArea;
+}
+
+// Set the area of the widget.
+void LayeredWidget::setArea(const SDL_Rect &widgetArea)
+{
+  this->area = widgetArea;
+  this->invalidate();
+}
+
+// Set the layers of the widget.
+void LayeredWidget::setLayers(
+  const vector<WidgetLayer> &widgetLayers)
+{
+  this->layers = widgetLayers;
+  this->invalidate();
+}
+
+// Set the layers of the widget from their information.
+void LayeredWidget::setLayers(
+  const list<TextureInfo> &widgetLayers)
+{
+  // An empty area.
+  const SDL_Rect empty = {0, 0, 0, 0};
+  this->layers.clear();
+  this->layers.reserve(widgetLayers.size());
+  for (const TextureInfo &nextLayer : widgetLayers)
+    this->layers.push_back({nextLayer.name,
+      nextLayer.src ? *nextLayer.src : empty,
+      nextLayer.dest ? *nextLayer.dest : empty,
+      !nextLayer.src, !nextLayer.dest});
+  this->invalidate();
+}
+
+// Change a layer of the widget.
+void LayeredWidget::setLayer(
+  size_t index, const WidgetLayer &layer)
+{
+  if (index >= this->layers.size())
+    return;
+  this->layers[index] = layer;
+  if (index < this->clippedLayers.size())
+    this->clippedLayers[index].dirty = true;
+  if (layer.wholeWindow)
+    this->coversWindow = true;
+}
+
+// Get the area of the widget.
+const SDL_Rect &LayeredWidget::getArea() const
+{
+  return this->area;
+}
+
+// Get the layers of the current widget.
+const vector<WidgetLayer> &LayeredWidget::getLayers() const
+{
+  return this->layers;
+}
+
+// Render the widget.
+void LayeredWidget::render()
+{
+  // The clipped layer.
+  const ClippedLayer *clipped = nullptr;
+  this->prepare();
+  // Render every texture of the widget.
+  for (size_t i = 0; i < this->layers.size(); i++)
+  {
+    clipped = &this->clippedLayers[i];
+    // The texture stays valid while its generation
+    // doesn't change.
+    if (clipped->visible)
+      theTextureManager.render(this->layers[i].name,
+        clipped->texture, clipped->clippedSrc,
+        clipped->clippedDest);
+    else if (clipped->texture)
+      theTextureManager.countCulledDraws();
+  }
+}
+
+// Get the version of the content of the widget.
+Uint64 LayeredWidget::getVersion()
+{
+  this->prepare();
+  return this->version;
+}
+
+// Update the widget.
+void LayeredWidget::update(
+  bool (*function)(vector<WidgetLayer> &))
+{
+  if (function && function(this->layers))
+    this->invalidate();
+}
+
+// Clip again the layers that changed.
+void LayeredWidget::prepare()
+{
+  // Game's window's size.
+  SDL_Rect currentWindowSize = {0, 0, 0, 0};
+  // The current generation of the textures.
+  Uint64 generation =
+    theTextureManager.getTextureGeneration();
+  // The clipped layer.
+  ClippedLayer *clipped = nullptr;
+  // The previous clipped layer.
+  ClippedLayer previous;
+  // The window is queried only if a layer covers it.
+  if (this->coversWindow)
+  {
+    SDL_GetWindowSize(theGame.getWindow(),
+      &currentWindowSize.w, &currentWindowSize.h);
+    if (currentWindowSize.w != this->windowSize.w ||
+        currentWindowSize.h != this->windowSize.h)
+    {
+      this->windowSize = currentWindowSize;
+      this->invalidate();
+    }
+  }
+  // Only the layers whose textures were replaced or
+  // changed are clipped again, and change the version.
+  if (generation != this->textureGeneration)
+  {
+    this->textureGeneration = generation;
+    for (size_t i = 0; i < this->clippedLayers.size() &&
+                       i < this->layers.size();
+         i++)
+      if (this->clippedLayers[i].generation !=
+          theTextureManager.getTextureGeneration(
+            this->layers[i].name))
+        this->clippedLayers[i].dirty = true;
+  }
+  if (this->clippedLayers.size() != this->layers.size())
+  {
+    this->clippedLayers.resize(this->layers.size(),
+      {nullptr, 0, {}, {}, false, true});
+    this->version++;
+  }
+  for (size_t i = 0; i < this->layers.size(); i++)
+  {
+    clipped = &this->clippedLayers[i];
+    // The missing textures change the generation when
+    // they are loaded.
+    if (!clipped->dirty)
+      continue;
+    previous = *clipped;
+    this->clip(this->layers[i], *clipped);
+    if (clipped->texture != previous.texture ||
+        clipped->generation != previous.generation ||
+        clipped->visible != previous.visible ||
+        (clipped->visible &&
+          (!SDL_RectEquals(
+             &clipped->clippedSrc, &previous.clippedSrc) ||
+            !SDL_RectEquals(&clipped->clippedDest,
+              &previous.clippedDest))))
+      this->version++;
+  }
+}
+
+// Clip a layer to the area of the widget.
+void LayeredWidget::clip(
+  const WidgetLayer &layer, ClippedLayer &clipped)
+{
+  // The source and destination areas.
+  SDL_Rect src = layer.src, dest = layer.dest;
+  // Horizontal and vertical scaling factors.
+  float xScale = 0;
+  float yScale = 0;
+  // Value to increase or decrease
+  int delta = 0;
+  clipped.texture =
+    theTextureManager.getModifiableTexture(layer.name);
+  clipped.generation =
+    theTextureManager.getTextureGeneration(layer.name);
+  clipped.visible = false;
+  clipped.dirty   = false;
+  if (!clipped.texture)
+    return;
+  if (layer.wholeWindow)
+    dest = this->windowSize;
+  // If the source is the whole texture, query its size.
+  if (layer.wholeTexture)
+  {
+    src = {0, 0, 0, 0};
+    if (SDL_QueryTexture(clipped.texture, nullptr,
+          nullptr, &src.w, &src.h) < 0)
+    {
+      SDL_Log(
+        "Failed to query texture: %s\n", SDL_GetError());
+      return;
+    }
+  }
+  // Don't render if width or height is non-positive.
+  if (src.w <= 0 || src.h <= 0 || dest.w <= 0 ||
+      dest.h <= 0)
+    return;
+  // Clipping and scaling algorithm.
+  if (dest.x >= this->area.x && dest.y >= this->area.y &&
+      dest.x + dest.w <= this->area.x + this->area.w &&
+      dest.y + dest.h <= this->area.y + this->area.h)
+  {
+    // Destination is completely within the widget area.
+    clipped.clippedSrc  = src;
+    clipped.clippedDest = dest;
+    clipped.visible     = true;
+    return;
+  }
+  // Destination is completely outside the widget area.
+  if (dest.x + dest.w < this->area.x ||
+      dest.y + dest.h < this->area.y ||
+      dest.x > this->area.x + this->area.w ||
+      dest.y > this->area.y + this->area.h)
+    return;
+  // Calculate horizontal and vertical scaling factors.
+  xScale = static_cast<float>(src.w) / dest.w;
+  yScale = static_cast<float>(src.h) / dest.h;
+  // Adjust source and destination rectangles based on
+  // widget boundaries.
+  if (dest.x < this->area.x)
+  {
+    delta = (this->area.x - dest.x) * xScale;
+    src.x += delta;
+    dest.x = this->area.x;
+  }
+  if (dest.y < this->area.y)
+  {
+    delta = (this->area.y - dest.y) * yScale;
+    src.y += delta;
+    dest.y = this->area.y;
+  }
+  if (dest.x + dest.w > this->area.x + this->area.w)
+  {
+    delta = ((dest.x + dest.w) -
+              (this->area.x + this->area.w)) *
+            xScale;
+    src.w -= delta;
+    dest.w = this->area.x + this->area.w - dest.x;
+  }
+  if (dest.y + dest.h > this->area.y + this->area.h)
+  {
+    delta = ((dest.y + dest.h) -
+              (this->area.y + this->area.h)) *
+            yScale;
+    src.h -= delta;
+    dest.h = this->area.y + this->area.h - dest.y;
+  }
+  // Render the clipped area if valid.
+  clipped.clippedSrc  = src;
+  clipped.clippedDest = dest;
+  clipped.visible =
+    src.w > 0 && src.h > 0 && dest.w > 0 && dest.h > 0;
+}
+
+// Mark all the layers to be clipped again.
+void LayeredWidget::invalidate()
+{
+  this->coversWindow = false;
+  for (const WidgetLayer &layer : this->layers)
+    if (layer.wholeWindow)
+      this->coversWindow = true;
+  for (ClippedLayer &clipped : this->clippedLayers)
+    clipped.dirty = true;
+}
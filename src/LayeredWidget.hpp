@@ -0,0 +1,137 @@
+/// @file LayeredWidget.hpp
+/// @author Duilio Pérez
+/// @brief A widget drawn with layers of textures.
+#ifndef LAYEREDWIDGET_HPP
+#define LAYEREDWIDGET_HPP true
+#include "TextureManager.hpp"
+#include "Widget.hpp"
+#include <SDL2/SDL.h>
+#include <list>
+#include <string>
+#include <vector>
+
+namespace DPGE
+{
+
+  /// @brief A layer of a widget.
+  struct WidgetLayer
+  {
+    /// @brief The name of the texture.
+    std::string name;
+    /// @brief The source area, if it isn't the whole
+    /// texture.
+    SDL_Rect src = {0, 0, 0, 0};
+    /// @brief The destination area, if it isn't the whole
+    /// window.
+    SDL_Rect dest = {0, 0, 0, 0};
+    /// @brief Indicator to draw the whole texture.
+    bool wholeTexture = false;
+    /// @brief Indicator to cover the whole window.
+    bool wholeWindow = false;
+  };
+
+  /// @brief A widget drawn with layers of textures clipped
+  /// to its area.
+  ///
+  /// The layers are kept in an array with their areas, and
+  /// the clipped source and destination of every layer are
+  /// kept between frames with its texture. They are
+  /// computed again only when the area, the layers, the
+  /// textures or the size of the window change, so
+  /// rendering an unchanged widget doesn't allocate memory.
+  /// The version of the widget changes only when the
+  /// clipped layers are different or the pixels of their
+  /// textures change, like the streaming textures and the
+  /// layers of the texture manager.
+  class LayeredWidget : public Widget
+  {
+  public:
+    /// @brief Default constructor.
+    LayeredWidget() = default;
+    /// @brief Constructor.
+    /// @param widgetArea The area of the widget.
+    explicit LayeredWidget(const SDL_Rect &widgetArea);
+    /// @brief Set the area of the widget.
+    /// @param widgetArea The area of the widget.
+    void setArea(const SDL_Rect &widgetArea) override;
+    /// @brief Get the area of the widget.
+    /// @return The area of the widget.
+    const SDL_Rect &getArea() const;
+    /// @brief Get the layers of the widget.
+    /// @return The layers of the widget.
+    const std::vector<WidgetLayer> &getLayers() const;
+    /// @brief Set the layers of the widget.
+    /// @param widgetLayers The layers of the widget.
+    void setLayers(
+      const std::vector<WidgetLayer> &widgetLayers);
+    /// @brief Set the layers of the widget.
+    /// @param widgetLayers The layers of the widget, their
+    /// areas are copied.
+    void setLayers(
+      const std::list<TextureInfo> &widgetLayers);
+    /// @brief Change a layer of the widget.
+    /// @param index The position of the layer.
+    /// @param layer The new layer.
+    void setLayer(size_t index, const WidgetLayer &layer);
+    /// @brief Update the current widget
+    /// @param function The function to call to update, it
+    /// returns true if it changed the layers.
+    void update(
+      bool (*function)(std::vector<WidgetLayer> &));
+    /// @brief Get the version of the content of the widget.
+    /// @return A value that changes when the clipped layers
+    /// change.
+    Uint64 getVersion() override;
+    /// @brief Overriden funtion to render the widget.
+    void render() override;
+
+  private:
+    /// @brief A layer clipped to the area of the widget.
+    struct ClippedLayer
+    {
+      /// @brief The texture of the layer.
+      SDL_Texture *texture;
+      /// @brief The generation of the texture, which
+      /// changes even if a new one gets the same address.
+      Uint64 generation;
+      /// @brief The clipped source area.
+      SDL_Rect clippedSrc;
+      /// @brief The clipped destination area.
+      SDL_Rect clippedDest;
+      /// @brief Indicator to know if the layer is drawn.
+      bool visible;
+      /// @brief Indicator to know if the layer must be
+      /// clipped again.
+      bool dirty;
+    };
+    /// @brief Clip again the layers that changed.
+    void prepare();
+    /// @brief Clip a layer to the area of the widget.
+    /// @param layer The layer.
+    /// @param clipped Where the clipped layer is saved.
+    void clip(
+      const WidgetLayer &layer, ClippedLayer &clipped);
+    /// @brief Mark all the layers to be clipped again.
+    void invalidate();
+    /// @brief The layers of the widget.
+    std::vector<WidgetLayer> layers;
+    /// @brief The clipped layers, in the same order.
+    std::vector<ClippedLayer> clippedLayers;
+    /// @brief The area of the widget.
+    SDL_Rect area = {0, 0, 0, 0};
+    /// @brief The size of the window when the layers were
+    /// clipped.
+    SDL_Rect windowSize = {0, 0, 0, 0};
+    /// @brief The generation of the textures when they
+    /// were obtained.
+    Uint64 textureGeneration = 0;
+    /// @brief The version of the clipped layers.
+    Uint64 version = 1;
+    /// @brief Indicator to know if a layer covers the
+    /// window.
+    bool coversWindow = false;
+  };
+
+} // namespace DPGE
+
+#endif
@@ -0,0 +1,255 @@
+// File: Layout.cpp
+// Author: Duilio Pérez
+// Implementation of the layout.
+#include "Layout.hpp"
+#include "Game.hpp"
+#include <algorithm>
+#include <cmath>
+using namespace DPGE;
+using namespace std;
+
+// Constructor.
+Layout::Layout()
+{
+  this->nodes.push_back({root, {}, LayoutItem(),
+    LayoutBox(), nullptr, {0, 0, 0, 0}, true, false,
+    false});
+}
+
+// Add a box.
+size_t Layout::addBox(size_t parent, const LayoutBox &box,
+  const LayoutItem &item)
+{
+  return this->addNode(parent, {parent, {}, item, box,
+                                 nullptr, {0, 0, 0, 0},
+                                 true, false, false});
+}
+
+// Add a widget.
+size_t Layout::addWidget(
+  size_t parent, Widget &widget, const LayoutItem &item)
+{
+  return this->addNode(parent, {parent, {}, item,
+                                 LayoutBox(), &widget,
+                                 {0, 0, 0, 0}, false,
+                                 false, false});
+}
+
+// Remove a node and its children.
+void Layout::remove(size_t node)
+{
+  // The children of the parent.
+  vector<size_t> *siblings = nullptr;
+  if (node == root || node >= this->nodes.size() ||
+      this->nodes[node].removed)
+    return;
+  siblings =
+    &this->nodes[this->nodes[node].parent].children;
+  // std::remove, not this member function.
+  siblings->erase(
+    std::remove(siblings->begin(), siblings->end(), node),
+    siblings->end());
+  this->markDirty(this->nodes[node].parent);
+  while (!this->nodes[node].children.empty())
+    this->remove(this->nodes[node].children.back());
+  this->nodes[node].removed = true;
+  this->nodes[node].widget  = nullptr;
+}
+
+// Remove all the nodes except the root.
+void Layout::clear()
+{
+  this->nodes.resize(1);
+  this->nodes[root].children.clear();
+  this->markDirty(root);
+}
+
+// Change the size of a node in its parent.
+void Layout::setItem(size_t node, const LayoutItem &item)
+{
+  if (node >= this->nodes.size() ||
+      this->nodes[node].removed)
+    return;
+  this->nodes[node].item = item;
+  // The siblings are moved too.
+  this->markDirty(this->nodes[node].parent);
+}
+
+// Change the placement of the children of a box.
+void Layout::setBox(size_t node, const LayoutBox &box)
+{
+  if (node >= this->nodes.size() ||
+      this->nodes[node].removed || this->nodes[node].widget)
+    return;
+  this->nodes[node].box = box;
+  this->markDirty(node);
+}
+
+// Set the area of the root box.
+void Layout::setArea(const SDL_Rect *area)
+{
+  this->coversWindow = !area;
+  if (area)
+    this->fixedArea = *area;
+  this->markDirty(root);
+}
+
+// Get the area of a node.
+const SDL_Rect &Layout::getArea(size_t node) const
+{
+  if (node >= this->nodes.size())
+    return this->nodes[root].area;
+  return this->nodes[node].area;
+}
+
+// Place the dirty boxes.
+void Layout::update()
+{
+  // The area of the root.
+  SDL_Rect area = this->fixedArea;
+  if (this->coversWindow)
+  {
+    area = {0, 0, 0, 0};
+    SDL_GetWindowSize(
+      theGame.getWindow(), &area.w, &area.h);
+  }
+  this->place(root, area);
+  this->updateNode(root);
+}
+
+// Add a node.
+size_t Layout::addNode(size_t parent, const Node &node)
+{
+  if (parent >= this->nodes.size() ||
+      this->nodes[parent].removed ||
+      this->nodes[parent].widget)
+  {
+    SDL_LogError(SDL_LOG_CATEGORY_ERROR,
+      "Can't add a node to the layout: The parent isn't a "
+      "box.\n");
+    return root;
+  }
+  this->nodes.push_back(node);
+  this->nodes[parent].children.push_back(
+    this->nodes.size() - 1);
+  this->markDirty(parent);
+  return this->nodes.size() - 1;
+}
+
+// Mark a box as dirty.
+void Layout::markDirty(size_t node)
+{
+  this->nodes[node].dirty = true;
+  // The path from the root is followed by update().
+  while (node != root)
+  {
+    node = this->nodes[node].parent;
+    if (this->nodes[node].dirtyDescendant)
+      break;
+    this->nodes[node].dirtyDescendant = true;
+  }
+}
+
+// Place a node in an area.
+void Layout::place(size_t node, const SDL_Rect &area)
+{
+  // The node to place.
+  Node &placed = this->nodes[node];
+  if (SDL_RectEquals(&area, &placed.area))
+    return;
+  placed.area = area;
+  if (placed.widget)
+    placed.widget->setArea(area);
+  else
+    placed.dirty = true;
+}
+
+// Place the children of a box.
+void Layout::placeChildren(size_t node)
+{
+  // The box.
+  const Node &box = this->nodes[node];
+  // The area inside the padding.
+  SDL_Rect inner = {box.area.x + box.box.padding,
+    box.area.y + box.box.padding,
+    max(box.area.w - 2 * box.box.padding, 0),
+    max(box.area.h - 2 * box.box.padding, 0)};
+  // Indicator to know if the children are in a row.
+  bool row = box.box.direction == LayoutDirection::ROW;
+  // The size along and across the box.
+  int mainSize = row ? inner.w : inner.h;
+  int crossSize = row ? inner.h : inner.w;
+  // The sum of the basis, the grow and the shrink weights.
+  float basis = 0, grow = 0, shrink = 0;
+  // The space left after the basis.
+  float freeSpace = 0;
+  // The position and size of a child along the box.
+  float position = row ? inner.x : inner.y;
+  float size     = 0;
+  // The start and end of a child along and across the box.
+  int start = 0, end = 0, crossStart = 0, crossLength = 0;
+  // The area of a child.
+  SDL_Rect area;
+  // The size of a child.
+  const LayoutItem *item = nullptr;
+  for (size_t child : box.children)
+  {
+    item = &this->nodes[child].item;
+    basis += max(item->basis, 0);
+    grow += max(item->grow, 0.0f);
+    shrink += max(item->shrink, 0.0f) * max(item->basis, 0);
+  }
+  if (!box.children.empty())
+    mainSize -= box.box.gap *
+                static_cast<int>(box.children.size() - 1);
+  freeSpace = mainSize - basis;
+  for (size_t child : box.children)
+  {
+    item = &this->nodes[child].item;
+    size = max(item->basis, 0);
+    if (freeSpace > 0 && grow > 0)
+      size += freeSpace * max(item->grow, 0.0f) / grow;
+    else if (freeSpace < 0 && shrink > 0)
+      size += freeSpace * max(item->shrink, 0.0f) *
+              max(item->basis, 0) / shrink;
+    size = max(size, 0.0f);
+    // The edges are rounded, so there are no holes.
+    start = static_cast<int>(lround(position));
+    end   = static_cast<int>(lround(position + size));
+    position += size + box.box.gap;
+    crossLength = item->crossSize > 0 &&
+                      item->align != LayoutAlign::STRETCH
+                    ? min(item->crossSize, crossSize)
+                    : crossSize;
+    crossStart = row ? inner.y : inner.x;
+    if (item->align == LayoutAlign::CENTER)
+      crossStart += (crossSize - crossLength) / 2;
+    else if (item->align == LayoutAlign::END)
+      crossStart += crossSize - crossLength;
+    if (row)
+      area = {start, crossStart, end - start, crossLength};
+    else
+      area = {crossStart, start, crossLength, end - start};
+    this->place(child, area);
+  }
+}
+
+// Place the dirty boxes under a node.
+void Layout::updateNode(size_t node)
+{
+  // Indicator to know if the children were placed.
+  bool placed = this->nodes[node].dirty;
+  if (placed)
+  {
+    this->placeChildren(node);
+    this->nodes[node].dirty = false;
+  }
+  // The boxes whose area changed are dirty now.
+  if (!placed && !this->nodes[node].dirtyDescendant)
+    return;
+  this->nodes[node].dirtyDescendant = false;
+  for (size_t child : this->nodes[node].children)
+    if (this->nodes[child].dirty ||
+        this->nodes[child].dirtyDescendant)
+      this->updateNode(child);
+}
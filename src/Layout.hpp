@@ -0,0 +1,179 @@
+/// @file Layout.hpp
+/// @author Duilio Pérez
+/// @brief Placement of widgets in rows and columns.
+#ifndef LAYOUT_HPP
+#define LAYOUT_HPP true
+#include "Widget.hpp"
+#include <SDL2/SDL.h>
+#include <vector>
+
+namespace DPGE
+{
+
+  /// @brief The direction of the children of a box.
+  enum struct LayoutDirection
+  {
+    /// @brief From left to right.
+    ROW,
+    /// @brief From top to bottom.
+    COLUMN
+  };
+
+  /// @brief The alignment of an item across its box.
+  enum struct LayoutAlign
+  {
+    /// @brief Fill the box.
+    STRETCH,
+    /// @brief At the start of the box.
+    START,
+    /// @brief At the center of the box.
+    CENTER,
+    /// @brief At the end of the box.
+    END
+  };
+
+  /// @brief The size of an item of a box.
+  struct LayoutItem
+  {
+    /// @brief The size along the box before growing or
+    /// shrinking.
+    int basis = 0;
+    /// @brief The share of the free space taken.
+    float grow = 0;
+    /// @brief The share of the missing space given, in
+    /// proportion to the basis.
+    float shrink = 1;
+    /// @brief The size across the box, 0 to fill it.
+    int crossSize = 0;
+    /// @brief The alignment across the box.
+    LayoutAlign align = LayoutAlign::STRETCH;
+  };
+
+  /// @brief The placement of the children of a box.
+  struct LayoutBox
+  {
+    /// @brief The direction of the children.
+    LayoutDirection direction = LayoutDirection::COLUMN;
+    /// @brief The space around the children.
+    int padding = 0;
+    /// @brief The space between the children.
+    int gap = 0;
+  };
+
+  /// @brief A tree of boxes that places widgets in rows and
+  /// columns, like the flexible boxes of CSS.
+  ///
+  /// Every node is a box with children, or a widget. The
+  /// children of a box take their basis along it, and the
+  /// free or missing space is shared by grow and shrink.
+  /// The changes mark their boxes as dirty, and update()
+  /// places only the dirty boxes and the boxes whose area
+  /// changed. The widgets get their area only when it
+  /// changes. The widgets aren't owned.
+  class Layout final
+  {
+  public:
+    /// @brief The node of the root box.
+    static constexpr size_t root = 0;
+    /// @brief Default constructor, the root box covers the
+    /// window.
+    Layout();
+    /// @brief Add a box.
+    /// @param parent The node of the parent box.
+    /// @param box The placement of its children.
+    /// @param item The size of the box in its parent.
+    /// @return The node of the box.
+    size_t addBox(size_t parent, const LayoutBox &box,
+      const LayoutItem &item = LayoutItem());
+    /// @brief Add a widget.
+    /// @param parent The node of the parent box.
+    /// @param widget The widget.
+    /// @param item The size of the widget in its parent.
+    /// @return The node of the widget.
+    size_t addWidget(size_t parent, Widget &widget,
+      const LayoutItem &item = LayoutItem());
+    /// @brief Remove a node and its children, their numbers
+    /// aren't used again.
+    /// @param node The node, not the root.
+    void remove(size_t node);
+    /// @brief Remove all the nodes except the root.
+    void clear();
+    /// @brief Change the size of a node in its parent.
+    /// @param node The node.
+    /// @param item The size of the node.
+    void setItem(size_t node, const LayoutItem &item);
+    /// @brief Change the placement of the children of a
+    /// box.
+    /// @param node The node of the box.
+    /// @param box The placement of its children.
+    void setBox(size_t node, const LayoutBox &box);
+    /// @brief Set the area of the root box.
+    /// @param area The area, nullptr to cover the window.
+    void setArea(const SDL_Rect *area);
+    /// @brief Get the area of a node.
+    /// @param node The node.
+    /// @return The area placed by the last update.
+    const SDL_Rect &getArea(size_t node) const;
+    /// @brief Place the dirty boxes.
+    ///
+    /// Call it before rendering the widgets, the size of
+    /// the window is checked every time.
+    void update();
+
+  private:
+    /// @brief A node of the tree.
+    struct Node
+    {
+      /// @brief The parent box.
+      size_t parent;
+      /// @brief The children, if it's a box.
+      std::vector<size_t> children;
+      /// @brief The size in its parent.
+      LayoutItem item;
+      /// @brief The placement of its children.
+      LayoutBox box;
+      /// @brief The widget, or nullptr for a box.
+      Widget *widget;
+      /// @brief The placed area.
+      SDL_Rect area;
+      /// @brief Indicator to know if the children must be
+      /// placed again.
+      bool dirty;
+      /// @brief Indicator to know if a descendant is dirty.
+      bool dirtyDescendant;
+      /// @brief Indicator to know if the node was removed.
+      bool removed;
+    };
+    /// @brief Add a node.
+    /// @param parent The node of the parent box.
+    /// @param node The new node.
+    /// @return The number of the node, or the root in
+    /// error.
+    size_t addNode(size_t parent, const Node &node);
+    /// @brief Mark a box as dirty.
+    /// @param node The node of the box.
+    void markDirty(size_t node);
+    /// @brief Place a node in an area.
+    /// @param node The node.
+    /// @param area The area, the children of a box are
+    /// placed again if it changed.
+    void place(size_t node, const SDL_Rect &area);
+    /// @brief Place the children of a box.
+    /// @param node The node of the box.
+    void placeChildren(size_t node);
+    /// @brief Place the dirty boxes under a node.
+    /// @param node The node.
+    void updateNode(size_t node);
+    /// @brief The nodes, the first is the root.
+    std::vector<Node> nodes;
+    /// @brief The area of the root, if it doesn't cover the
+    /// window.
+    SDL_Rect fixedArea = {0, 0, 0, 0};
+    /// @brief Indicator to know if the root covers the
+    /// window.
+    bool coversWindow = true;
+  };
+
+} // namespace DPGE
+
+#endif
@@ -0,0 +1,177 @@
+// File: NineSlice.cpp
+// Author: Duilio Pérez
+// Implementation of the nine-slice panel.
+#include "NineSlice.hpp"
+#include "TextureManager.hpp"
+#include <cstdio>
+using namespace DPGE;
+using namespace std;
+
+// Split a length in three parts, reducing the margins
+// proportionally if they don't fit.
+static void split(int length, int first, int last,
+  int &firstPart, int &lastPart)
+{
+  if (first + last > length && first + last > 0)
+  {
+    firstPart = first * length / (first + last);
+    lastPart  = length - firstPart;
+  }
+  else
+  {
+    firstPart = first;
+    lastPart  = last;
+  }
+}
+
+// Default constructor.
+NineSlice::NineSlice()
+{
+  // The name must be unique for every panel.
+  char name[64];
+  snprintf(name, sizeof(name), "DPGE::NineSlice:%p",
+    static_cast<void *>(this));
+  this->layerName = name;
+}
+
+// Constructor.
+NineSlice::NineSlice(const string &textureName,
+  const Insets &margins, const SDL_Rect &panelArea)
+: NineSlice()
+{
+  this->texture = textureName;
+  this->insets  = margins;
+  this->area    = panelArea;
+}
+
+// Destructor.
+NineSlice::~NineSlice()
+{
+  if (this->layerWidth)
+    theTextureManager.erase(this->layerName);
+}
+
+// Set the texture of the panel.
+void NineSlice::setTexture(
+  const string &textureName, const Insets &margins)
+{
+  this->texture = textureName;
+  this->insets  = margins;
+  theTextureManager.markLayerDirty(this->layerName);
+}
+
+// Get the name of the texture.
+const string &NineSlice::getTexture() const
+{
+  return this->texture;
+}
+
+// Get the margins of the corners.
+const Insets &NineSlice::getMargins() const
+{
+  return this->insets;
+}
+
+// Set the area of the panel.
+void NineSlice::setArea(const SDL_Rect &panelArea)
+{
+  this->area = panelArea;
+}
+
+// Get the area of the panel.
+const SDL_Rect &NineSlice::getArea() const
+{
+  return this->area;
+}
+
+// Render the widget.
+void NineSlice::render()
+{
+  if (this->texture.empty() || this->area.w <= 0 ||
+      this->area.h <= 0)
+    return;
+  // The layer is created again when the size changes.
+  if (this->layered && (this->layerWidth != this->area.w ||
+                         this->layerHeight != this->area.h))
+  {
+    if (this->layerWidth)
+      theTextureManager.erase(this->layerName);
+    this->layerWidth  = 0;
+    this->layerHeight = 0;
+    if (theTextureManager.createLayer(
+          this->layerName, this->area.w, this->area.h))
+    {
+      this->layerWidth  = this->area.w;
+      this->layerHeight = this->area.h;
+    }
+    else
+      this->layered = false;
+  }
+  if (!this->layered)
+  {
+    this->drawSlices(this->area.x, this->area.y);
+    return;
+  }
+  if (theTextureManager.beginLayer(this->layerName))
+  {
+    this->drawSlices(0, 0);
+    theTextureManager.endLayer();
+  }
+  theTextureManager.render(this->layerName, this->area);
+}
+
+// Draw the slices.
+void NineSlice::drawSlices(int x, int y)
+{
+  // The size of the texture.
+  int textureWidth = 0, textureHeight = 0;
+  // The columns and rows of the texture.
+  int srcColumns[4], srcRows[4];
+  // The columns and rows of the panel.
+  int destColumns[4], destRows[4];
+  // The size of the destination margins.
+  int left = 0, top = 0, right = 0, bottom = 0;
+  // The areas of a slice.
+  SDL_Rect src, dest;
+  // The texture of the slices.
+  SDL_Texture *slices =
+    theTextureManager.getModifiableTexture(this->texture);
+  if (SDL_QueryTexture(slices, nullptr, nullptr,
+        &textureWidth, &textureHeight) < 0)
+    return;
+  split(this->area.w, this->insets.left,
+    this->insets.right, left, right);
+  split(this->area.h, this->insets.top,
+    this->insets.bottom, top, bottom);
+  srcColumns[0]  = 0;
+  srcColumns[1]  = this->insets.left;
+  srcColumns[2]  = textureWidth - this->insets.right;
+  srcColumns[3]  = textureWidth;
+  srcRows[0]     = 0;
+  srcRows[1]     = this->insets.top;
+  srcRows[2]     = textureHeight - this->insets.bottom;
+  srcRows[3]     = textureHeight;
+  destColumns[0] = x;
+  destColumns[1] = x + left;
+  destColumns[2] = x + this->area.w - right;
+  destColumns[3] = x + this->area.w;
+  destRows[0]    = y;
+  destRows[1]    = y + top;
+  destRows[2]    = y + this->area.h - bottom;
+  destRows[3]    = y + this->area.h;
+  for (int row = 0; row < 3; row++)
+    for (int column = 0; column < 3; column++)
+    {
+      src  = {srcColumns[column], srcRows[row],
+        srcColumns[column + 1] - srcColumns[column],
+        srcRows[row + 1] - srcRows[row]};
+      dest = {destColumns[column], destRows[row],
+        destColumns[column + 1] - destColumns[column],
+        destRows[row + 1] - destRows[row]};
+      // Empty slices, like the edges of a small panel.
+      if (src.w <= 0 || src.h <= 0 || dest.w <= 0 ||
+          dest.h <= 0)
+        continue;
+      theTextureManager.render(this->texture, src, dest);
+    }
+}
@@ -0,0 +1,96 @@
+/// @file NineSlice.hpp
+/// @author Duilio Pérez
+/// @brief A scalable panel made of nine slices.
+#ifndef NINESLICE_HPP
+#define NINESLICE_HPP true
+#include "Widget.hpp"
+#include <SDL2/SDL.h>
+#include <string>
+
+namespace DPGE
+{
+
+  /// @brief The margins of the corners of a texture.
+  struct Insets
+  {
+    /// @brief The width of the left column.
+    int left;
+    /// @brief The height of the top row.
+    int top;
+    /// @brief The width of the right column.
+    int right;
+    /// @brief The height of the bottom row.
+    int bottom;
+  };
+
+  /// @brief A panel that scales a texture keeping its
+  /// borders.
+  ///
+  /// The texture is cut in nine slices by the margins. The
+  /// corners keep their size, the edges are stretched in
+  /// one direction and the center in both. The slices are
+  /// recorded in a layer of the size of the panel, so a
+  /// frame only copies the layer, and they are drawn again
+  /// when the size or the texture changes.
+  class NineSlice final : public Widget
+  {
+  public:
+    /// @brief Default constructor.
+    NineSlice();
+    /// @brief Constructor.
+    /// @param textureName The name of the texture.
+    /// @param margins The margins of the corners.
+    /// @param panelArea The area of the panel.
+    NineSlice(const std::string &textureName,
+      const Insets &margins, const SDL_Rect &panelArea);
+    /// @brief Copy constructor deleted.
+    NineSlice(const NineSlice &) = delete;
+    /// @brief Destructor.
+    ~NineSlice();
+    /// @brief Set the texture of the panel.
+    /// @param textureName The name of the texture.
+    /// @param margins The margins of the corners.
+    void setTexture(const std::string &textureName,
+      const Insets &margins);
+    /// @brief Get the name of the texture of the panel.
+    /// @return The name of the texture.
+    const std::string &getTexture() const;
+    /// @brief Get the margins of the corners.
+    /// @return The margins of the corners.
+    const Insets &getMargins() const;
+    /// @brief Set the area of the panel.
+    /// @param panelArea The area of the panel.
+    void setArea(const SDL_Rect &panelArea);
+    /// @brief Get the area of the panel.
+    /// @return The area of the panel.
+    const SDL_Rect &getArea() const;
+    /// @brief Overriden funtion to render the widget.
+    void render() override;
+    /// @brief Copy operator deleted.
+    const NineSlice &operator=(const NineSlice &) = delete;
+
+  private:
+    /// @brief Draw the slices.
+    /// @param x The x coordinate of the panel.
+    /// @param y The y coordinate of the panel.
+    void drawSlices(int x, int y);
+    /// @brief The name of the texture.
+    std::string texture;
+    /// @brief The margins of the corners.
+    Insets insets = {0, 0, 0, 0};
+    /// @brief The area of the panel.
+    SDL_Rect area = {0, 0, 0, 0};
+    /// @brief The name of the layer.
+    std::string layerName;
+    /// @brief The width of the layer, 0 without layer.
+    int layerWidth = 0;
+    /// @brief The height of the layer, 0 without layer.
+    int layerHeight = 0;
+    /// @brief Indicator to know if the layers are
+    /// supported, the slices are drawn every frame if not.
+    bool layered = true;
+  };
+
+} // namespace DPGE
+
+#endif
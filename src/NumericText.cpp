@@ -0,0 +1,257 @@
+// File: NumericText.cpp
+// Author: Duilio Pérez
+// Implementation of the numeric text.
+#include "NumericText.hpp"
+#include "TextLayout.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+using namespace DPGE;
+using namespace std;
+
+// The pre-rendered glyphs, in the order of the cells.
+static const char glyphSet[] = "0123456789+-.,:";
+
+// Write the digits of a number with leading zeros.
+static int writeDigits(char *text, Uint64 value, int digits)
+{
+  // The number of written digits.
+  int length = 0;
+  // The digits in reverse order.
+  char reversed[24];
+  do
+  {
+    reversed[length++] =
+      static_cast<char>('0' + value % 10);
+    value /= 10;
+  } while (value || length < digits);
+  for (int i = 0; i < length; i++)
+    text[i] = reversed[length - 1 - i];
+  return length;
+}
+
+// Default constructor.
+NumericText::NumericText()
+{
+  // The name must be unique for every numeric text.
+  char name[64];
+  snprintf(name, sizeof(name), "DPGE::NumericText:%p",
+    static_cast<void *>(this));
+  this->textureName = name;
+}
+
+// Constructor.
+NumericText::NumericText(const SDL_Color &textColor)
+: NumericText()
+{
+  this->color = textColor;
+}
+
+// Destructor.
+NumericText::~NumericText()
+{
+  if (this->ready)
+    theTextureManager.erase(this->textureName);
+}
+
+// Set the color of the numbers.
+void NumericText::setColor(const SDL_Color &textColor)
+{
+  this->color = textColor;
+}
+
+// Get the color of the numbers.
+const SDL_Color &NumericText::getColor() const
+{
+  return this->color;
+}
+
+// Separate the thousands with commas.
+void NumericText::setGrouping(bool enable)
+{
+  this->grouping = enable;
+}
+
+// Query if the thousands are separated.
+bool NumericText::hasGrouping() const
+{
+  return this->grouping;
+}
+
+// Render an integer.
+bool NumericText::renderInteger(Sint64 value, int x, int y)
+{
+  // The composed text.
+  char text[maxLength];
+  // The magnitude, valid for the lowest integer.
+  Uint64 magnitude = value < 0
+                       ? 0 - static_cast<Uint64>(value)
+                       : static_cast<Uint64>(value);
+  return this->renderGlyphs(text,
+    this->writeNumber(text, value < 0, magnitude, 0), x, y);
+}
+
+// Render a number with a fixed number of decimals.
+bool NumericText::renderFixed(
+  double value, int decimals, int x, int y)
+{
+  // The composed text.
+  char text[maxLength];
+  // The number scaled to an integer.
+  double scaled = fabs(value);
+  // The rounded magnitude.
+  Uint64 magnitude = 0;
+  // NaN can't be converted to an integer.
+  if (!isfinite(value))
+  {
+    SDL_LogError(SDL_LOG_CATEGORY_ERROR,
+      "Can't render a number: It isn't finite.\n");
+    return false;
+  }
+  decimals = clamp(decimals, 0, 9);
+  for (int i = 0; i < decimals; i++)
+    scaled *= 10;
+  magnitude = static_cast<Uint64>(
+    min(floor(scaled + 0.5), 1.8e19));
+  return this->renderGlyphs(text,
+    this->writeNumber(
+      text, value < 0 && magnitude, magnitude, decimals),
+    x, y);
+}
+
+// Render a time.
+bool NumericText::renderTime(
+  Uint64 milliseconds, int x, int y, int decimals)
+{
+  // The composed text.
+  char text[maxLength];
+  // The number of written characters.
+  int length = 0;
+  // The whole seconds.
+  Uint64 seconds = milliseconds / 1000;
+  // The milliseconds of the last second.
+  Uint64 fraction = milliseconds % 1000;
+  decimals        = clamp(decimals, 0, 3);
+  if (seconds >= 3600)
+  {
+    length += writeDigits(text, seconds / 3600, 1);
+    text[length++] = ':';
+    length +=
+      writeDigits(text + length, seconds / 60 % 60, 2);
+  }
+  else
+    length += writeDigits(text, seconds / 60, 1);
+  text[length++] = ':';
+  length += writeDigits(text + length, seconds % 60, 2);
+  if (decimals > 0)
+  {
+    for (int i = decimals; i < 3; i++)
+      fraction /= 10;
+    text[length++] = '.';
+    length +=
+      writeDigits(text + length, fraction, decimals);
+  }
+  return this->renderGlyphs(text, length, x, y);
+}
+
+// Write a number.
+int NumericText::writeNumber(char *text, bool negative,
+  Uint64 magnitude, int decimals) const
+{
+  // The digits of the number.
+  char digits[24];
+  // The number of digits.
+  int count = writeDigits(digits, magnitude, decimals + 1);
+  // The number of written characters.
+  int length = 0;
+  if (negative)
+    text[length++] = '-';
+  for (int i = 0; i < count; i++)
+  {
+    text[length++] = digits[i];
+    // The number of digits after this one.
+    if (count - 1 - i == decimals && decimals > 0)
+      text[length++] = '.';
+    else if (this->grouping && count - 1 - i > decimals &&
+             (count - 1 - i - decimals) % 3 == 0)
+      text[length++] = ',';
+  }
+  return length;
+}
+
+// Rasterize the glyphs if it's needed.
+bool NumericText::prepare()
+{
+  // The font of the texture manager.
+  TTF_Font *currentFont = theTextureManager.getFont();
+  // The previous text color.
+  SDL_Color previousColor;
+  // The layout of the glyphs, separated by spaces.
+  TextLayout layout;
+  // The next cell.
+  int cell = 0;
+  if (!currentFont)
+    return false;
+  // A new font can get the address of the old one.
+  if (this->ready &&
+      theTextureManager.getFontGeneration() ==
+        this->fontGeneration &&
+      theTextureManager.getTextQuality() == this->quality &&
+      memcmp(&this->color, &this->glyphColor,
+        sizeof(SDL_Color)) == 0 &&
+      memcmp(&theTextureManager.getBackgroundColor(),
+        &this->glyphBackground, sizeof(SDL_Color)) == 0)
+    return true;
+  if (this->ready)
+    theTextureManager.erase(this->textureName);
+  layout.setFont(currentFont);
+  layout.setText("0 1 2 3 4 5 6 7 8 9 + - . , :");
+  previousColor = theTextureManager.getForegroundColor();
+  theTextureManager.setForegroundColor(this->color);
+  this->ready = theTextureManager.loadFromText(
+    this->textureName, layout);
+  theTextureManager.setForegroundColor(previousColor);
+  if (!this->ready)
+    return false;
+  for (const TextGlyph &glyph : layout.getGlyphs())
+    if (glyph.codepoint != ' ' && cell < glyphCount)
+      this->cells[cell++] = {
+        glyph.x, 0, glyph.advance, layout.getHeight()};
+  this->fontGeneration =
+    theTextureManager.getFontGeneration();
+  this->quality    = theTextureManager.getTextQuality();
+  this->glyphColor = this->color;
+  // The shaded and LCD glyphs are drawn over it.
+  this->glyphBackground =
+    theTextureManager.getBackgroundColor();
+  return true;
+}
+
+// Copy the glyphs of a text.
+bool NumericText::renderGlyphs(
+  const char *text, int length, int x, int y)
+{
+  // The destination of a glyph.
+  SDL_Rect dest = {x, y, 0, 0};
+  // The glyph to copy.
+  const char *glyph = nullptr;
+  // The area of the glyph in the texture.
+  const SDL_Rect *cell = nullptr;
+  if (!this->prepare())
+    return false;
+  for (int i = 0; i < length; i++)
+  {
+    glyph = strchr(glyphSet, text[i]);
+    if (!glyph || !*glyph)
+      continue;
+    cell   = &this->cells[glyph - glyphSet];
+    dest.w = cell->w;
+    dest.h = cell->h;
+    if (!theTextureManager.render(
+          this->textureName, *cell, dest))
+      return false;
+    dest.x += cell->w;
+  }
+  return true;
+}
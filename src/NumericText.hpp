@@ -0,0 +1,129 @@
+/// @file NumericText.hpp
+/// @author Duilio Pérez
+/// @brief A renderer of numbers from pre-rendered glyphs.
+#ifndef NUMERICTEXT_HPP
+#define NUMERICTEXT_HPP true
+#include "TextureManager.hpp"
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_ttf.h>
+#include <string>
+
+namespace DPGE
+{
+
+  /// @brief A renderer of integers, fixed-point numbers and
+  /// times that change every frame, like scores, timers or
+  /// FPS counters.
+  ///
+  /// The digits, the signs and the separators are
+  /// rasterized once in a texture with the font, quality
+  /// and color of the texture manager, and every number is
+  /// composed copying those glyphs, without allocating
+  /// memory or rasterizing text. The glyphs are rasterized
+  /// again when the font, its size, the quality, the color
+  /// or the background color of the texture manager
+  /// change.
+  class NumericText final
+  {
+  public:
+    /// @brief Default constructor.
+    NumericText();
+    /// @brief Constructor.
+    /// @param textColor The color of the numbers.
+    explicit NumericText(const SDL_Color &textColor);
+    /// @brief Copy constructor deleted.
+    NumericText(const NumericText &) = delete;
+    /// @brief Destructor.
+    ~NumericText();
+    /// @brief Set the color of the numbers.
+    /// @param textColor The color of the numbers.
+    void setColor(const SDL_Color &textColor);
+    /// @brief Get the color of the numbers.
+    /// @return The color of the numbers.
+    const SDL_Color &getColor() const;
+    /// @brief Separate the thousands with commas.
+    /// @param enable true to separate them.
+    void setGrouping(bool enable);
+    /// @brief Query if the thousands are separated.
+    /// @return true if they are separated with commas.
+    bool hasGrouping() const;
+    /// @brief Render an integer.
+    /// @param value The integer.
+    /// @param x The x coordinate.
+    /// @param y The y coordinate.
+    /// @return true in success, false otherwise.
+    bool renderInteger(Sint64 value, int x, int y);
+    /// @brief Render a number with a fixed number of
+    /// decimals.
+    /// @param value The number, rounded to the decimals.
+    /// NaN and the infinites aren't rendered.
+    /// @param decimals The number of decimals, up to 9.
+    /// @param x The x coordinate.
+    /// @param y The y coordinate.
+    /// @return true in success, false otherwise.
+    bool renderFixed(
+      double value, int decimals, int x, int y);
+    /// @brief Render a time as minutes and seconds, or
+    /// hours, minutes and seconds from an hour.
+    /// @param milliseconds The time in milliseconds.
+    /// @param x The x coordinate.
+    /// @param y The y coordinate.
+    /// @param decimals The decimals of the seconds, up to
+    /// 3.
+    /// @return true in success, false otherwise.
+    bool renderTime(Uint64 milliseconds, int x, int y,
+      int decimals = 0);
+    /// @brief Copy operator deleted.
+    const NumericText &operator=(
+      const NumericText &) = delete;
+
+  private:
+    /// @brief The number of pre-rendered glyphs.
+    static constexpr int glyphCount = 15;
+    /// @brief The maximum length of a number.
+    static constexpr int maxLength = 48;
+    /// @brief Write a number.
+    /// @param text The buffer of the text.
+    /// @param negative true to write the minus sign.
+    /// @param magnitude The digits of the number.
+    /// @param decimals The number of decimal digits.
+    /// @return The number of written characters.
+    int writeNumber(char *text, bool negative,
+      Uint64 magnitude, int decimals) const;
+    /// @brief Rasterize the glyphs if it's needed.
+    /// @return true if the glyphs are ready, false in
+    /// error.
+    bool prepare();
+    /// @brief Copy the glyphs of a text.
+    /// @param text The text.
+    /// @param length The length of the text.
+    /// @param x The x coordinate.
+    /// @param y The y coordinate.
+    /// @return true in success, false otherwise.
+    bool renderGlyphs(
+      const char *text, int length, int x, int y);
+    /// @brief The name of the texture of the glyphs.
+    std::string textureName;
+    /// @brief The areas of the glyphs in the texture.
+    SDL_Rect cells[glyphCount];
+    /// @brief The color of the numbers.
+    SDL_Color color = {0, 0, 0, 255};
+    /// @brief Indicator to know if the thousands are
+    /// separated.
+    bool grouping = false;
+    /// @brief The generation of the font of the glyphs.
+    Uint64 fontGeneration = 0;
+    /// @brief The quality of the glyphs.
+    TextQuality quality = TextQuality::SOLID;
+    /// @brief The color of the glyphs.
+    SDL_Color glyphColor = {0, 0, 0, 0};
+    /// @brief The background color of the glyphs.
+    SDL_Color glyphBackground = {0, 0, 0, 0};
+    /// @brief Indicator to know if the glyphs were
+    /// rasterized.
+    bool ready = false;
+  };
+
+} // namespace DPGE
+
+#endif
@@ -0,0 +1,155 @@
+// File: Panel.cpp
+// Author: Duilio Pérez
+// Implementation of the panel.
+#include "Panel.hpp"
+#include "TextureManager.hpp"
+#include <algorithm>
+#include <cstdio>
+using namespace DPGE;
+using namespace std;
+
+// Mix bytes in a FNV-1a hash.
+static Uint64 hashBytes(
+  Uint64 hash, const void *data, size_t size)
+{
+  // The bytes to mix.
+  const Uint8 *bytes = static_cast<const Uint8 *>(data);
+  for (size_t i = 0; i < size; i++)
+    hash = (hash ^ bytes[i]) * 1099511628211ULL;
+  return hash;
+}
+
+// Default constructor.
+Panel::Panel()
+{
+  // The name must be unique for every panel.
+  char name[64];
+  snprintf(name, sizeof(name), "DPGE::Panel:%p",
+    static_cast<void *>(this));
+  this->textureName = name;
+}
+
+// Constructor.
+Panel::Panel(const SDL_Rect &panelArea)
+: Panel()
+{
+  this->area = panelArea;
+}
+
+// Destructor.
+Panel::~Panel()
+{
+  if (this->created)
+    theTextureManager.erase(this->textureName);
+}
+
+// Set the area of the panel.
+void Panel::setArea(const SDL_Rect &panelArea)
+{
+  if (this->created && (panelArea.w != this->area.w ||
+                         panelArea.h != this->area.h))
+  {
+    theTextureManager.erase(this->textureName);
+    this->created = false;
+  }
+  this->area = panelArea;
+}
+
+// Get the area of the panel.
+const SDL_Rect &Panel::getArea() const
+{
+  return this->area;
+}
+
+// Add a widget.
+void Panel::add(Widget &widget)
+{
+  this->widgets.push_back(&widget);
+  this->changes++;
+}
+
+// Remove a widget.
+void Panel::remove(const Widget &widget)
+{
+  // Qualified, a plain remove here is Panel::remove.
+  this->widgets.erase(std::remove(this->widgets.begin(),
+                        this->widgets.end(), &widget),
+    this->widgets.end());
+  this->changes++;
+}
+
+// Remove all the widgets.
+void Panel::clear()
+{
+  this->widgets.clear();
+  this->changes++;
+}
+
+// Bind a value.
+void Panel::bind(const void *value, size_t size)
+{
+  if (value && size)
+    this->bindings.push_back({value, size});
+}
+
+// Remove all the bound values.
+void Panel::clearBindings()
+{
+  this->bindings.clear();
+}
+
+// Draw the widgets again in the next frame.
+void Panel::markDirty()
+{
+  if (this->created)
+    theTextureManager.markLayerDirty(this->textureName);
+}
+
+// Get the version of the content of the panel.
+Uint64 Panel::getVersion()
+{
+  // The inputs of the layer.
+  Uint64 inputs = this->getInputs();
+  // The position changes the panels that draw this one.
+  return hashBytes(inputs, &this->area, sizeof(SDL_Rect));
+}
+
+// Render the panel.
+void Panel::render()
+{
+  if (!this->created)
+  {
+    if (this->area.w <= 0 || this->area.h <= 0)
+      return;
+    this->created = theTextureManager.createLayer(
+      this->textureName, this->area.w, this->area.h);
+    if (!this->created)
+      return;
+  }
+  if (theTextureManager.beginLayer(
+        this->textureName, this->getInputs()))
+  {
+    for (Widget *widget : this->widgets)
+      widget->render();
+    theTextureManager.endLayer();
+  }
+  theTextureManager.render(this->textureName, this->area);
+}
+
+// Get the inputs of the layer.
+Uint64 Panel::getInputs()
+{
+  // The hash of the inputs.
+  Uint64 hash = 14695981039346656037ULL;
+  // The version of a widget.
+  Uint64 version = 0;
+  hash = hashBytes(hash, &this->changes, sizeof(Uint64));
+  for (Widget *widget : this->widgets)
+  {
+    version = widget->getVersion();
+    hash    = hashBytes(hash, &version, sizeof(Uint64));
+  }
+  for (const Binding &binding : this->bindings)
+    hash = hashBytes(hash, binding.value, binding.size);
+  return hash;
+}
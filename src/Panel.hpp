@@ -0,0 +1,108 @@
+/// @file Panel.hpp
+/// @author Duilio Pérez
+/// @brief A group of widgets composited in a texture.
+#ifndef PANEL_HPP
+#define PANEL_HPP true
+#include "Widget.hpp"
+#include <SDL2/SDL.h>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace DPGE
+{
+
+  /// @brief A group of widgets composited in a layer of
+  /// the texture manager.
+  ///
+  /// The widgets are drawn in the layer only when the
+  /// version of one of them or a bound value changes, and
+  /// the layer is drawn with one copy otherwise. The areas
+  /// of the widgets are relative to the panel. The widgets
+  /// that don't track their version need markDirty() to be
+  /// drawn again. The widgets and the values aren't owned.
+  class Panel final : public Widget
+  {
+  public:
+    /// @brief Default constructor.
+    Panel();
+    /// @brief Constructor.
+    /// @param panelArea The area of the panel.
+    explicit Panel(const SDL_Rect &panelArea);
+    /// @brief Copy constructor deleted.
+    Panel(const Panel &) = delete;
+    /// @brief Destructor, it erases the layer.
+    ~Panel();
+    /// @brief Set the area of the panel.
+    /// @param panelArea The area of the panel, the layer is
+    /// created again if its size changes.
+    void setArea(const SDL_Rect &panelArea) override;
+    /// @brief Get the area of the panel.
+    /// @return The area of the panel.
+    const SDL_Rect &getArea() const;
+    /// @brief Add a widget, it's drawn above the previous
+    /// ones.
+    /// @param widget The widget.
+    void add(Widget &widget);
+    /// @brief Remove a widget.
+    /// @param widget The widget.
+    void remove(const Widget &widget);
+    /// @brief Remove all the widgets.
+    void clear();
+    /// @brief Draw the widgets again when a value changes.
+    /// @param value The value.
+    /// @param size The size of the value in bytes.
+    void bind(const void *value, size_t size);
+    /// @brief Draw the widgets again when a value changes.
+    /// @param value The value, without pointers to its
+    /// content.
+    template <typename T>
+    void bind(const T &value)
+    {
+      static_assert(std::is_trivially_copyable<T>::value,
+        "The bound values are compared by their bytes");
+      this->bind(&value, sizeof(T));
+    }
+    /// @brief Remove all the bound values.
+    void clearBindings();
+    /// @brief Draw the widgets again in the next frame.
+    void markDirty();
+    /// @brief Get the version of the content of the panel.
+    /// @return A value that changes when the panel draws
+    /// something different.
+    Uint64 getVersion() override;
+    /// @brief Overriden funtion to render the widget.
+    void render() override;
+    /// @brief Copy operator deleted.
+    const Panel &operator=(const Panel &) = delete;
+
+  private:
+    /// @brief A value bound to the panel.
+    struct Binding
+    {
+      /// @brief The value.
+      const void *value;
+      /// @brief The size of the value.
+      size_t size;
+    };
+    /// @brief Get the inputs of the layer.
+    /// @return A hash of the versions of the widgets and
+    /// the bound values.
+    Uint64 getInputs();
+    /// @brief The widgets.
+    std::vector<Widget *> widgets;
+    /// @brief The bound values.
+    std::vector<Binding> bindings;
+    /// @brief The name of the layer.
+    std::string textureName;
+    /// @brief The area of the panel.
+    SDL_Rect area = {0, 0, 0, 0};
+    /// @brief The number of changes of the widgets.
+    Uint64 changes = 0;
+    /// @brief Indicator to know if the layer was created.
+    bool created = false;
+  };
+
+} // namespace DPGE
+
+#endif
@@ -0,0 +1,66 @@
+// File: PathPattern.cpp
+// Author: Duilio Pérez
+// Implementation of the path pattern functions.
+#include "PathPattern.hpp"
+using namespace DPGE;
+using namespace std;
+
+// Put a number in a path pattern.
+string DPGE::formatPath(
+  const string &pattern, Sint64 number)
+{
+  // The formatted path.
+  string path;
+  // The digits of the number, without the sign.
+  string digits = to_string(number);
+  // The sign of the number.
+  string sign;
+  // The position of a character of the pattern.
+  size_t i = 0;
+  // The end of a conversion.
+  size_t end = 0;
+  // The minimum width of the number.
+  size_t width = 0;
+  // Indicator to know if the number was put.
+  bool numbered = false;
+  if (number < 0)
+  {
+    sign   = "-";
+    digits = digits.substr(1);
+  }
+  while (i < pattern.size())
+  {
+    if (pattern[i] != '%')
+    {
+      path += pattern[i++];
+      continue;
+    }
+    if (i + 1 < pattern.size() && pattern[i + 1] == '%')
+    {
+      path += '%';
+      i    += 2;
+      continue;
+    }
+    width = 0;
+    end   = i + 1;
+    while (end < pattern.size() && pattern[end] >= '0' &&
+           pattern[end] <= '9' && width < 20)
+      width = width * 10 + (pattern[end++] - '0');
+    if (!numbered && end < pattern.size() &&
+        (pattern[end] == 'u' || pattern[end] == 'd' ||
+          pattern[end] == 'i'))
+    {
+      // The zeros go after the sign, like in printf.
+      path += sign;
+      if (sign.size() + digits.size() < width)
+        path.append(
+          width - sign.size() - digits.size(), '0');
+      path    += digits;
+      numbered = true;
+      i        = end + 1;
+    }
+    else
+      path += pattern[i++];
+  }
+  return path;
+}
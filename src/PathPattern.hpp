@@ -0,0 +1,27 @@
+/// @file PathPattern.hpp
+/// @author Duilio Pérez
+/// @brief Functions to make the paths of numbered files.
+#ifndef PATHPATTERN_HPP
+#define PATHPATTERN_HPP true
+#include <SDL2/SDL.h>
+#include <string>
+
+namespace DPGE
+{
+
+  /// @brief Put a number in a path pattern.
+  /// @param pattern The path with a conversion for the
+  /// number, like "intro/%04d.png".
+  /// @param number The number to put.
+  /// @return The path with the number.
+  ///
+  /// Only the first %u, %d or %i is replaced, padded with
+  /// zeros to its width, and %% gives a %. The rest of the
+  /// pattern is copied as it is, it's never used as a
+  /// printf format.
+  std::string formatPath(
+    const std::string &pattern, Sint64 number);
+
+} // namespace DPGE
+
+#endif
@@ -0,0 +1,295 @@
+// File: RenderQueue.cpp
+// Author: Duilio Pérez
+// Implementation of the render queue.
+#include "RenderQueue.hpp"
+#include "TextureManager.hpp"
+#include <SDL2/SDL.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+using namespace DPGE;
+using namespace std;
+
+// Define the instance of the render queue.
+RenderQueue &DPGE::theRenderQueue =
+  RenderQueue::getInstance();
+
+// The buffer of every thread.
+thread_local RenderQueue::LocalBuffer
+  RenderQueue::localBuffer;
+
+// Compare two commands by their keys.
+static bool compareCommands(
+  const RenderCommand &first, const RenderCommand &second)
+{
+  return first.key < second.key;
+}
+
+// Compare two areas by their sizes.
+static bool compareAreas(
+  const SDL_FRect &first, const SDL_FRect &second)
+{
+  return first.w * first.h < second.w * second.h;
+}
+
+// Release the buffer of a finished thread.
+RenderQueue::LocalBuffer::~LocalBuffer()
+{
+  // The queue deletes it in the next flush.
+  if (this->buffer)
+    this->buffer->orphaned = true;
+}
+
+// Make the sort key of a command.
+Uint64 RenderQueue::makeKey(Uint8 layer, Uint16 depth,
+  const SDL_Texture *texture, SDL_BlendMode blend)
+{
+  // Textures are aligned, so the lowest bits are useless.
+  Uint64 textureBits =
+    (reinterpret_cast<uintptr_t>(texture) >> 4) &
+    0xFFFFFFFF;
+  return static_cast<Uint64>(layer) << 56 |
+         static_cast<Uint64>(depth) << 40 |
+         textureBits << 8 |
+         (static_cast<Uint64>(blend) & 0xFF);
+}
+
+// Record a command.
+void RenderQueue::submit(Uint8 layer, Uint16 depth,
+  SDL_Texture *texture, const SDL_Rect *src,
+  const SDL_FRect &dest, double angle,
+  const SDL_FPoint *center, const SDL_RendererFlip &flip,
+  SDL_BlendMode blend)
+{
+  // The command to record.
+  RenderCommand command;
+  command.key       = makeKey(layer, depth, texture, blend);
+  command.texture   = texture;
+  command.src       = src ? *src : SDL_Rect{0, 0, 0, 0};
+  command.dest      = dest;
+  command.center    = center ? *center : SDL_FPoint{0, 0};
+  command.angle     = angle;
+  command.blend     = blend;
+  command.flip      = flip;
+  command.hasSrc    = src;
+  command.hasCenter = center;
+  this->getBuffer().commands.push_back(command);
+}
+
+// Record a command.
+void RenderQueue::submit(const RenderCommand &command)
+{
+  this->getBuffer().commands.push_back(command);
+}
+
+// Merge and execute all the commands.
+bool RenderQueue::flush()
+{
+  // The result of the execution.
+  bool success = true;
+  // The last texture and its own blend mode.
+  SDL_Texture  *lastTexture   = nullptr;
+  SDL_BlendMode originalBlend = SDL_BLENDMODE_INVALID;
+  {
+    lock_guard<mutex> lock(this->buffersMutex);
+    this->merged.clear();
+    for (auto &buffer : this->buffers)
+    {
+      // Every buffer is sorted, and then merged with the
+      // previous ones.
+      auto &commands = buffer->commands;
+      if (commands.empty())
+        continue;
+      stable_sort(
+        commands.begin(), commands.end(), compareCommands);
+      this->mergeBuffer.resize(
+        this->merged.size() + commands.size());
+      merge(this->merged.begin(), this->merged.end(),
+        commands.begin(), commands.end(),
+        this->mergeBuffer.begin(), compareCommands);
+      this->merged.swap(this->mergeBuffer);
+      commands.clear();
+    }
+    // Delete the buffers of the finished threads.
+    this->buffers.erase(
+      remove_if(this->buffers.begin(), this->buffers.end(),
+        [](const unique_ptr<Buffer> &buffer) {
+          return buffer->orphaned.load();
+        }),
+      this->buffers.end());
+  }
+  // The destroyed textures are skipped, and the commands
+  // without blend mode take the one of their texture.
+  sort(this->forgotten.begin(), this->forgotten.end());
+  for (RenderCommand &command : this->merged)
+    if (binary_search(this->forgotten.begin(),
+          this->forgotten.end(), command.texture))
+      command.texture = nullptr;
+    else if (command.blend == SDL_BLENDMODE_INVALID)
+      command.blend =
+        theTextureManager.getBlendMode(command.texture);
+  this->forgotten.clear();
+  theTextureManager.countOccludedDraws(
+    this->findOccluded());
+  // Execute the commands.
+  for (size_t i = 0; i < this->merged.size(); i++)
+  {
+    // The command to execute.
+    const RenderCommand &command = this->merged[i];
+    if (!command.texture || this->occluded[i])
+      continue;
+    // The blend mode of the previous texture is restored.
+    if (command.texture != lastTexture)
+    {
+      if (lastTexture)
+        theTextureManager.setBlendMode(
+          lastTexture, originalBlend);
+      lastTexture = command.texture;
+      originalBlend =
+        theTextureManager.getBlendMode(command.texture);
+    }
+    theTextureManager.setBlendMode(
+      command.texture, command.blend);
+    theTextureManager.countCopy(command.texture);
+    if (!theTextureManager.copy(command.texture,
+          command.hasSrc ? &command.src : nullptr,
+          &command.dest, command.angle,
+          command.hasCenter ? &command.center : nullptr,
+          command.flip))
+    {
+      SDL_LogError(SDL_LOG_CATEGORY_ERROR,
+        "Error executing a render command: %s.\n",
+        SDL_GetError());
+      success = false;
+    }
+  }
+  if (lastTexture)
+    theTextureManager.setBlendMode(
+      lastTexture, originalBlend);
+  this->merged.clear();
+  return success;
+}
+
+// Skip the commands of a destroyed texture.
+void RenderQueue::forget(const SDL_Texture *texture)
+{
+  this->forgotten.push_back(texture);
+}
+
+// Discard all the commands.
+void RenderQueue::clear()
+{
+  lock_guard<mutex> lock(this->buffersMutex);
+  for (auto &buffer : this->buffers)
+    buffer->commands.clear();
+}
+
+// Get the buffer of the current thread.
+RenderQueue::Buffer &RenderQueue::getBuffer()
+{
+  // Register a buffer the first time a thread submits.
+  if (!localBuffer.buffer)
+  {
+    lock_guard<mutex> lock(this->buffersMutex);
+    this->buffers.emplace_back(new Buffer);
+    localBuffer.buffer = this->buffers.back().get();
+  }
+  return *localBuffer.buffer;
+}
+
+// Find the commands hidden by later opaque commands.
+Uint32 RenderQueue::findOccluded()
+{
+  // The number of hidden commands.
+  Uint32 count = 0;
+  // The pixels touched by a command.
+  SDL_FRect bounds;
+  this->occluded.assign(this->merged.size(), false);
+  this->occluders.clear();
+  // The commands are visited from the last drawn, so the
+  // areas only hide the commands drawn before them.
+  for (size_t i = this->merged.size(); i-- > 0;)
+  {
+    // The command to test.
+    const RenderCommand &command = this->merged[i];
+    // The rotated commands are never hidden.
+    if (!command.texture || command.angle != 0)
+      continue;
+    bounds.x = floorf(command.dest.x);
+    bounds.y = floorf(command.dest.y);
+    bounds.w = ceilf(command.dest.x + command.dest.w) -
+               bounds.x;
+    bounds.h = ceilf(command.dest.y + command.dest.h) -
+               bounds.y;
+    for (const SDL_FRect &area : this->occluders)
+      if (bounds.x >= area.x && bounds.y >= area.y &&
+          bounds.x + bounds.w <= area.x + area.w &&
+          bounds.y + bounds.h <= area.y + area.h)
+      {
+        this->occluded[i] = true;
+        break;
+      }
+    if (this->occluded[i])
+    {
+      count++;
+      continue;
+    }
+    if (!isOccluder(command))
+      continue;
+    // Only the pixels covered completely are opaque.
+    bounds.x = ceilf(command.dest.x);
+    bounds.y = ceilf(command.dest.y);
+    bounds.w =
+      floorf(command.dest.x + command.dest.w) - bounds.x;
+    bounds.h =
+      floorf(command.dest.y + command.dest.h) - bounds.y;
+    if (bounds.w <= 0 || bounds.h <= 0)
+      continue;
+    if (this->occluders.size() < maxOccluders)
+      this->occluders.push_back(bounds);
+    else
+    {
+      // Replace the smallest area if this one is larger.
+      auto smallest = min_element(this->occluders.begin(),
+        this->occluders.end(), compareAreas);
+      if (smallest->w * smallest->h < bounds.w * bounds.h)
+        *smallest = bounds;
+    }
+  }
+  return count;
+}
+
+// Query if a command covers completely its destination.
+bool RenderQueue::isOccluder(const RenderCommand &command)
+{
+  // The alpha modulation of the texture.
+  Uint8 alpha = 0;
+  // The size of the texture.
+  int width = 0, height = 0;
+  if (command.angle != 0)
+    return false;
+  if (command.blend != SDL_BLENDMODE_NONE &&
+      (command.blend != SDL_BLENDMODE_BLEND ||
+        !theTextureManager.isOpaque(command.texture) ||
+        SDL_GetTextureAlphaMod(command.texture, &alpha) <
+          0 ||
+        alpha != 255))
+    return false;
+  // A source area out of the texture is clipped, and the
+  // destination is reduced.
+  if (command.hasSrc &&
+      (SDL_QueryTexture(command.texture, nullptr, nullptr,
+         &width, &height) < 0 ||
+        command.src.x < 0 || command.src.y < 0 ||
+        command.src.x + command.src.w > width ||
+        command.src.y + command.src.h > height))
+    return false;
+  return true;
+}
+
+// Get the instance of the class.
+RenderQueue &RenderQueue::getInstance()
+{
+  static RenderQueue theInstance;
+  return theInstance;
+}
@@ -0,0 +1,182 @@
+/// @file RenderQueue.hpp
+/// @author Duilio Pérez
+/// @brief Render command buffers that can be filled from
+/// any thread.
+#ifndef RENDERQUEUE_HPP
+#define RENDERQUEUE_HPP true
+#include <SDL2/SDL.h>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace DPGE
+{
+
+  /// @brief A command to copy a texture in the renderer.
+  ///
+  /// It's a plain structure, so it can be copied and
+  /// sorted cheaply.
+  struct RenderCommand
+  {
+    /// @brief The sort key, see RenderQueue::makeKey().
+    Uint64 key;
+    /// @brief The texture to copy.
+    SDL_Texture *texture;
+    /// @brief The source area.
+    SDL_Rect src;
+    /// @brief The destination area.
+    SDL_FRect dest;
+    /// @brief The rotation center.
+    SDL_FPoint center;
+    /// @brief The rotation angle.
+    double angle;
+    /// @brief The blend mode, SDL_BLENDMODE_INVALID to use
+    /// the blend mode of the texture.
+    SDL_BlendMode blend;
+    /// @brief The flip direction.
+    SDL_RendererFlip flip;
+    /// @brief Indicator to know if the source area is
+    /// used, otherwise the whole texture is copied.
+    bool hasSrc;
+    /// @brief Indicator to know if the center is used,
+    /// otherwise it's the center of the destination.
+    bool hasCenter;
+  };
+
+  /// @brief A queue of render commands.
+  ///
+  /// Every thread records its commands in its own buffer
+  /// without locks, for example, while updating the game
+  /// objects. The main thread merges the buffers sorted by
+  /// their keys and executes them when the scene is
+  /// presented, so the commands are drawn over the ones
+  /// rendered directly by the texture manager. All the
+  /// submissions must be finished before the flush.
+  ///
+  /// The commands completely covered by later opaque
+  /// commands aren't drawn. A command is opaque if it isn't
+  /// rotated and its texture is opaque, see
+  /// TextureManager::isOpaque(), or it doesn't blend.
+  class RenderQueue final
+  {
+  public:
+    /// @brief Copy constructor deleted.
+    RenderQueue(const RenderQueue &) = delete;
+    /// @brief Make the sort key of a command.
+    /// @param layer The layer, the lower are drawn first.
+    /// @param depth The depth inside the layer, the lower
+    /// are drawn first.
+    /// @param texture The texture of the command.
+    /// @param blend The blend mode of the command.
+    /// @return The key, with the layer in the highest 8
+    /// bits, then 16 bits of depth, 32 bits of texture and
+    /// 8 bits of blend mode.
+    static Uint64 makeKey(Uint8 layer, Uint16 depth,
+      const SDL_Texture *texture, SDL_BlendMode blend);
+    /// @brief Record a command in the current thread's
+    /// buffer.
+    /// @param layer The layer of the command.
+    /// @param depth The depth inside the layer.
+    /// @param texture The texture to copy.
+    /// @param src The source area, nullptr to copy the
+    /// whole texture.
+    /// @param dest The destination area.
+    /// @param angle The rotation angle.
+    /// @param center The rotation center, nullptr to set it
+    /// at the center of the destination.
+    /// @param flip The flip direction.
+    /// @param blend The blend mode, SDL_BLENDMODE_INVALID
+    /// to use the blend mode of the texture.
+    void submit(Uint8 layer, Uint16 depth,
+      SDL_Texture *texture, const SDL_Rect *src,
+      const SDL_FRect &dest, double angle = 0,
+      const SDL_FPoint       *center = nullptr,
+      const SDL_RendererFlip &flip   = SDL_FLIP_NONE,
+      SDL_BlendMode blend = SDL_BLENDMODE_INVALID);
+    /// @brief Record a command in the current thread's
+    /// buffer.
+    /// @param command The command, with its key.
+    void submit(const RenderCommand &command);
+    /// @brief Merge and execute all the commands.
+    /// @return true in success, false if a command failed.
+    ///
+    /// It must be called from the main thread. The blend
+    /// modes of the commands are set only while they are
+    /// drawn.
+    bool flush();
+    /// @brief Skip the commands of a destroyed texture in
+    /// the next flush.
+    /// @param texture The texture, it must be kept until
+    /// the flush, so its address isn't used again.
+    ///
+    /// It must be called from the main thread.
+    void forget(const SDL_Texture *texture);
+    /// @brief Discard all the commands.
+    void clear();
+    /// @brief Get the instance of the class.
+    static RenderQueue &getInstance();
+    /// @brief Copy operator deleted.
+    const RenderQueue &operator=(
+      const RenderQueue &) = delete;
+
+  private:
+    /// @brief The commands of a thread.
+    struct Buffer
+    {
+      /// @brief The recorded commands.
+      std::vector<RenderCommand> commands;
+      /// @brief Indicator to know if the thread has
+      /// finished.
+      std::atomic<bool> orphaned{false};
+    };
+    /// @brief The owner of the buffer of a thread.
+    struct LocalBuffer
+    {
+      /// @brief Destructor, called when the thread
+      /// finishes.
+      ~LocalBuffer();
+      /// @brief The buffer of the thread.
+      Buffer *buffer = nullptr;
+    };
+    /// @brief Default constructor.
+    RenderQueue() = default;
+    /// @brief The most opaque areas kept to hide the
+    /// commands, the largest.
+    static constexpr size_t maxOccluders = 8;
+    /// @brief Get the buffer of the current thread.
+    /// @return The buffer.
+    Buffer &getBuffer();
+    /// @brief Find the merged commands hidden by later
+    /// opaque commands.
+    /// @return The number of hidden commands.
+    Uint32 findOccluded();
+    /// @brief Query if a command covers completely its
+    /// destination.
+    /// @param command The command.
+    /// @return true if the command is opaque.
+    static bool isOccluder(const RenderCommand &command);
+    /// @brief The buffer of every thread.
+    static thread_local LocalBuffer localBuffer;
+    /// @brief Mutex to register the buffers.
+    std::mutex buffersMutex;
+    /// @brief All the buffers.
+    std::vector<std::unique_ptr<Buffer>> buffers;
+    /// @brief The merged commands.
+    std::vector<RenderCommand> merged;
+    /// @brief Temporary storage to merge.
+    std::vector<RenderCommand> mergeBuffer;
+    /// @brief Indicators of the hidden merged commands.
+    std::vector<bool> occluded;
+    /// @brief The opaque areas of the later commands.
+    std::vector<SDL_FRect> occluders;
+    /// @brief The textures destroyed before the flush.
+    std::vector<const SDL_Texture *> forgotten;
+  };
+
+  /// @brief The render queue instance.
+  extern RenderQueue &theRenderQueue;
+
+} // namespace DPGE
+
+#endif
@@ -0,0 +1,350 @@
+// File: ScrollList.cpp
+// Author: Duilio Pérez
+// Implementation of the scroll list.
+#include "ScrollList.hpp"
+#include "TextureManager.hpp"
+#include <algorithm>
+#include <cstdio>
+using namespace DPGE;
+using namespace std;
+
+// Default constructor.
+ScrollList::ScrollList()
+{
+  this->createRows();
+}
+
+// Constructor.
+ScrollList::ScrollList(
+  const SDL_Rect &listArea, int listRowHeight)
+{
+  this->area      = listArea;
+  this->rowHeight = max(listRowHeight, 1);
+  this->createRows();
+}
+
+// Destructor.
+ScrollList::~ScrollList()
+{
+  this->eraseRows();
+}
+
+// Set the area of the list.
+void ScrollList::setArea(const SDL_Rect &listArea)
+{
+  this->area = listArea;
+  this->createRows();
+  this->setScroll(this->scroll);
+}
+
+// Get the area of the list.
+const SDL_Rect &ScrollList::getArea() const
+{
+  return this->area;
+}
+
+// Set the height of the rows.
+void ScrollList::setRowHeight(int listRowHeight)
+{
+  this->rowHeight = max(listRowHeight, 1);
+  this->createRows();
+  this->setScroll(this->scroll);
+}
+
+// Get the height of the rows.
+int ScrollList::getRowHeight() const
+{
+  return this->rowHeight;
+}
+
+// Set the rows created out of the area.
+void ScrollList::setOverscan(int rows)
+{
+  this->overscan = max(rows, 0);
+  this->createRows();
+}
+
+// Set the space at the left of the texts.
+void ScrollList::setPadding(int pixels)
+{
+  this->padding = pixels;
+  for (Row &row : this->rows)
+    row.y = INT_MIN;
+  this->changes++;
+}
+
+// Set the texture drawn behind every row.
+void ScrollList::setRowBackground(const string &name)
+{
+  this->rowBackground = name;
+  for (Row &row : this->rows)
+    row.y = INT_MIN;
+  this->changes++;
+}
+
+// Set the function that gives the texts.
+void ScrollList::setTextFunction(
+  void (*function)(size_t item, string &text))
+{
+  this->textFunction = function;
+  this->refresh();
+}
+
+// Set the number of items.
+void ScrollList::setItemCount(size_t count)
+{
+  // The rows of the removed items can't be used again.
+  for (Row &row : this->rows)
+    if (row.item != SIZE_MAX && row.item >= count)
+      row.item = SIZE_MAX;
+  this->itemCount = count;
+  this->changes++;
+  this->setScroll(this->scroll);
+}
+
+// Get the number of items.
+size_t ScrollList::getItemCount() const
+{
+  return this->itemCount;
+}
+
+// Ask the texts of all the rows again.
+void ScrollList::refresh()
+{
+  // The textures are replaced when the rows are rendered.
+  for (Row &row : this->rows)
+    row.item = SIZE_MAX;
+  this->changes++;
+}
+
+// Ask the text of an item again.
+void ScrollList::refresh(size_t item)
+{
+  // The row of the item.
+  Row *row = nullptr;
+  if (this->rows.empty())
+    return;
+  row = &this->rows[item % this->rows.size()];
+  if (row->item != item)
+    return;
+  row->item = SIZE_MAX;
+  this->changes++;
+}
+
+// Set the scrolled distance.
+void ScrollList::setScroll(int offset)
+{
+  offset = max(min(offset, this->getMaxScroll()), 0);
+  if (offset == this->scroll)
+    return;
+  this->scroll = offset;
+  this->changes++;
+}
+
+// Scroll the list.
+void ScrollList::scrollBy(int delta)
+{
+  // The new distance, it can't overflow.
+  Sint64 offset = static_cast<Sint64>(this->scroll) + delta;
+  offset = max<Sint64>(min<Sint64>(offset, INT_MAX), 0);
+  this->setScroll(static_cast<int>(offset));
+}
+
+// Get the scrolled distance.
+int ScrollList::getScroll() const
+{
+  return this->scroll;
+}
+
+// Get the item at a point.
+bool ScrollList::getItemAt(int x, int y, size_t &item) const
+{
+  // The point in the space of the area.
+  SDL_Point point = {
+    x - this->eventOrigin.x, y - this->eventOrigin.y};
+  // The distance from the top of the first item.
+  Sint64 offset = 0;
+  if (!SDL_PointInRect(&point, &this->area))
+    return false;
+  offset = static_cast<Sint64>(point.y) - this->area.y +
+           this->scroll;
+  if (static_cast<Uint64>(offset / this->rowHeight) >=
+      this->itemCount)
+    return false;
+  item = static_cast<size_t>(offset / this->rowHeight);
+  return true;
+}
+
+// Handle the events of the list.
+void ScrollList::handleEvents(const SDL_Event &event)
+{
+  // The position of the mouse.
+  SDL_Point mouse = {0, 0};
+  // The scrolled rows, positive to go up.
+  int wheel = 0;
+  if (event.type != SDL_MOUSEWHEEL)
+    return;
+  // The area is relative to the panel of the list.
+  SDL_GetMouseState(&mouse.x, &mouse.y);
+  mouse.x -= this->eventOrigin.x;
+  mouse.y -= this->eventOrigin.y;
+  if (!SDL_PointInRect(&mouse, &this->area))
+    return;
+  wheel = event.wheel.y;
+  if (event.wheel.direction == SDL_MOUSEWHEEL_FLIPPED)
+    wheel = -wheel;
+  this->scrollBy(-wheel * this->rowHeight);
+}
+
+// Set the position of the space of the area.
+void ScrollList::setEventOrigin(int x, int y)
+{
+  this->eventOrigin = {x, y};
+}
+
+// Get the version of the content of the list.
+Uint64 ScrollList::getVersion()
+{
+  return this->changes;
+}
+
+// Render the list.
+void ScrollList::render()
+{
+  // The first and last rows that intersect the area.
+  Sint64 firstVisible = 0, lastVisible = 0;
+  // The first and last items that get a row.
+  Sint64 first = 0, last = 0;
+  // The row of an item.
+  Row *row = nullptr;
+  if (this->rows.empty() || !this->itemCount)
+    return;
+  firstVisible = this->scroll / this->rowHeight;
+  lastVisible  = (static_cast<Sint64>(this->scroll) +
+                   this->area.h - 1) /
+                this->rowHeight;
+  first = max<Sint64>(firstVisible - this->overscan, 0);
+  last  = min<Sint64>(lastVisible + this->overscan,
+    static_cast<Sint64>(this->itemCount) - 1);
+  // The overscan rows are loaded, but not drawn.
+  for (Sint64 item = first; item <= last; item++)
+  {
+    row = &this->rows[item % this->rows.size()];
+    if (row->item != static_cast<size_t>(item))
+      this->loadRow(*row, static_cast<size_t>(item));
+    if (item < firstVisible || item > lastVisible)
+      continue;
+    this->placeRow(*row,
+      static_cast<int>(this->area.y +
+                       item * this->rowHeight -
+                       this->scroll));
+    row->label.render();
+  }
+}
+
+// Create the rows that fit in the area.
+void ScrollList::createRows()
+{
+  // The number of rows.
+  size_t count = 0;
+  // The name of the texture of a row.
+  char name[80];
+  if (this->area.h > 0)
+    count = static_cast<size_t>(
+      (this->area.h + this->rowHeight - 1) /
+        this->rowHeight +
+      1 + 2 * this->overscan);
+  if (count != this->rows.size())
+  {
+    this->eraseRows();
+    this->rows.resize(count);
+    for (size_t i = 0; i < count; i++)
+    {
+      // The name must be unique for every row.
+      snprintf(name, sizeof(name),
+        "DPGE::ScrollList:%p:%zu",
+        static_cast<void *>(this), i);
+      this->rows[i].textureName = name;
+      this->rows[i].item        = SIZE_MAX;
+      this->rows[i].label.setLayers(
+        vector<WidgetLayer>(2));
+    }
+  }
+  for (Row &row : this->rows)
+  {
+    row.label.setArea(this->area);
+    row.y = INT_MIN;
+  }
+  this->changes++;
+}
+
+// Erase the textures of the rows.
+void ScrollList::eraseRows()
+{
+  for (Row &row : this->rows)
+  {
+    if (row.loaded)
+      theTextureManager.erase(row.textureName);
+    row.loaded = false;
+  }
+}
+
+// Rasterize the text of an item in a row.
+void ScrollList::loadRow(Row &row, size_t item)
+{
+  row.item       = item;
+  row.textWidth  = 0;
+  row.textHeight = 0;
+  row.y          = INT_MIN;
+  this->text.clear();
+  if (this->textFunction)
+    this->textFunction(item, this->text);
+  if (this->text.empty())
+    return;
+  // The texture of the row is used again if the text
+  // fits in it.
+  if (theTextureManager.reloadFromText(row.textureName,
+        this->text, row.textWidth, row.textHeight))
+    row.loaded = true;
+  else
+  {
+    row.textWidth  = 0;
+    row.textHeight = 0;
+  }
+}
+
+// Place the layers of a row.
+void ScrollList::placeRow(Row &row, int rowY)
+{
+  // The layer of the background.
+  WidgetLayer background;
+  // The layer of the text.
+  WidgetLayer textLayer;
+  if (row.y == rowY)
+    return;
+  row.y = rowY;
+  background.name         = this->rowBackground;
+  background.dest         = {
+    this->area.x, rowY, this->area.w, this->rowHeight};
+  background.wholeTexture = true;
+  // The texture can be bigger than the text.
+  if (row.textWidth > 0)
+    textLayer.name = row.textureName;
+  textLayer.src  = {0, 0, row.textWidth, row.textHeight};
+  textLayer.dest = {this->area.x + this->padding,
+    rowY + (this->rowHeight - row.textHeight) / 2,
+    row.textWidth, row.textHeight};
+  row.label.setLayer(0, background);
+  row.label.setLayer(1, textLayer);
+}
+
+// Get the greatest scrolled distance.
+int ScrollList::getMaxScroll() const
+{
+  // The height of all the items.
+  Sint64 height =
+    static_cast<Sint64>(this->itemCount) * this->rowHeight;
+  return static_cast<int>(
+    min<Sint64>(max<Sint64>(height - this->area.h, 0),
+      INT_MAX));
+}
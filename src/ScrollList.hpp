@@ -0,0 +1,184 @@
+/// @file ScrollList.hpp
+/// @author Duilio Pérez
+/// @brief A list of text rows that scrolls.
+#ifndef SCROLLLIST_HPP
+#define SCROLLLIST_HPP true
+#include "Label.hpp"
+#include "Widget.hpp"
+#include <SDL2/SDL.h>
+#include <climits>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace DPGE
+{
+
+  /// @brief A list of text rows that scrolls, with any
+  /// number of items.
+  ///
+  /// Only the rows in the area and some rows around it are
+  /// created, as labels with a texture for their text. When
+  /// the list scrolls, the rows that leave the area are
+  /// used for the items that enter it, so the cost doesn't
+  /// depend on the number of items. The texts are asked to
+  /// a function when an item gets a row, and rasterized
+  /// with the current font, quality and colors of the
+  /// texture manager.
+  class ScrollList final : public Widget
+  {
+  public:
+    /// @brief Default constructor.
+    ScrollList();
+    /// @brief Constructor.
+    /// @param listArea The area of the list.
+    /// @param listRowHeight The height of the rows.
+    ScrollList(const SDL_Rect &listArea, int listRowHeight);
+    /// @brief Copy constructor deleted.
+    ScrollList(const ScrollList &) = delete;
+    /// @brief Destructor, it erases the textures.
+    ~ScrollList();
+    /// @brief Set the area of the list.
+    /// @param listArea The area of the list.
+    void setArea(const SDL_Rect &listArea) override;
+    /// @brief Get the area of the list.
+    /// @return The area of the list.
+    const SDL_Rect &getArea() const;
+    /// @brief Set the height of the rows.
+    /// @param listRowHeight The height in pixels.
+    void setRowHeight(int listRowHeight);
+    /// @brief Get the height of the rows.
+    /// @return The height in pixels.
+    int getRowHeight() const;
+    /// @brief Set the rows created out of the area.
+    /// @param rows The rows above and below the area.
+    void setOverscan(int rows);
+    /// @brief Set the space at the left of the texts.
+    /// @param pixels The space in pixels.
+    void setPadding(int pixels);
+    /// @brief Set the texture drawn behind every row.
+    /// @param name The name of the texture, empty for
+    /// none.
+    void setRowBackground(const std::string &name);
+    /// @brief Set the function that gives the texts.
+    /// @param function The function, it receives the
+    /// number of an item and saves its text.
+    void setTextFunction(
+      void (*function)(size_t item, std::string &text));
+    /// @brief Set the number of items.
+    /// @param count The number of items.
+    void setItemCount(size_t count);
+    /// @brief Get the number of items.
+    /// @return The number of items.
+    size_t getItemCount() const;
+    /// @brief Ask the texts of all the rows again.
+    void refresh();
+    /// @brief Ask the text of an item again, if it has a
+    /// row.
+    /// @param item The number of the item.
+    void refresh(size_t item);
+    /// @brief Set the scrolled distance.
+    /// @param offset The distance from the top in pixels,
+    /// it's limited to the height of the items.
+    void setScroll(int offset);
+    /// @brief Scroll the list.
+    /// @param delta The distance in pixels, positive to go
+    /// down.
+    void scrollBy(int delta);
+    /// @brief Get the scrolled distance.
+    /// @return The distance from the top in pixels.
+    int getScroll() const;
+    /// @brief Get the item at a point.
+    /// @param x The x coordinate in the window, like the
+    /// one of the mouse.
+    /// @param y The y coordinate.
+    /// @param item Where the number of the item is saved.
+    /// @return true if there is an item at the point.
+    bool getItemAt(int x, int y, size_t &item) const;
+    /// @brief Scroll with the mouse wheel over the list.
+    /// @param event The next event to proccess.
+    void handleEvents(const SDL_Event &event);
+    /// @brief Set the position in the window of the space
+    /// of the area, to find the mouse and the points of
+    /// getItemAt() in it.
+    /// @param x The x coordinate, like the one of the panel
+    /// that draws the list.
+    /// @param y The y coordinate.
+    void setEventOrigin(int x, int y);
+    /// @brief Get the version of the content of the list.
+    /// @return A value that changes when the list draws
+    /// something different.
+    Uint64 getVersion() override;
+    /// @brief Overriden funtion to render the widget.
+    void render() override;
+    /// @brief Copy operator deleted.
+    const ScrollList &operator=(
+      const ScrollList &) = delete;
+
+  private:
+    /// @brief A row of the list.
+    struct Row
+    {
+      /// @brief The widget of the row.
+      Label label;
+      /// @brief The name of the texture of the text.
+      std::string textureName;
+      /// @brief The item shown, or SIZE_MAX for none.
+      size_t item = SIZE_MAX;
+      /// @brief The size of the text, 0 for none, the
+      /// texture can be bigger.
+      int textWidth = 0, textHeight = 0;
+      /// @brief The position of the row, or INT_MIN if it
+      /// must be placed again.
+      int y = INT_MIN;
+      /// @brief Indicator to know if the texture exists,
+      /// it's used again for the next items.
+      bool loaded = false;
+    };
+    /// @brief Create the rows that fit in the area.
+    void createRows();
+    /// @brief Erase the textures of the rows.
+    void eraseRows();
+    /// @brief Rasterize the text of an item in the texture
+    /// of a row.
+    /// @param row The row.
+    /// @param item The number of the item.
+    void loadRow(Row &row, size_t item);
+    /// @brief Place the layers of a row.
+    /// @param row The row.
+    /// @param rowY The position of the row.
+    void placeRow(Row &row, int rowY);
+    /// @brief Get the greatest scrolled distance.
+    /// @return The distance in pixels.
+    int getMaxScroll() const;
+    /// @brief The rows, the item n uses the row n modulo
+    /// their number.
+    std::vector<Row> rows;
+    /// @brief The function that gives the texts.
+    void (*textFunction)(size_t, std::string &) = nullptr;
+    /// @brief The texture behind the rows.
+    std::string rowBackground;
+    /// @brief The text of the item being loaded.
+    std::string text;
+    /// @brief The area of the list.
+    SDL_Rect area = {0, 0, 0, 0};
+    /// @brief The position in the window of the space of
+    /// the area.
+    SDL_Point eventOrigin = {0, 0};
+    /// @brief The number of items.
+    size_t itemCount = 0;
+    /// @brief The height of the rows.
+    int rowHeight = 1;
+    /// @brief The rows created out of the area.
+    int overscan = 2;
+    /// @brief The space at the left of the texts.
+    int padding = 4;
+    /// @brief The scrolled distance.
+    int scroll = 0;
+    /// @brief The number of changes of the list.
+    Uint64 changes = 0;
+  };
+
+} // namespace DPGE
+
+#endif
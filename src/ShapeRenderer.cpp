@@ -0,0 +1,399 @@
+// File: ShapeRenderer.cpp
+// Author: Duilio Pérez
+// Implementation of the shape renderer.
+#include "ShapeRenderer.hpp"
+#include "Game.hpp"
+#include "TextureManager.hpp"
+#include <SDL2/SDL.h>
+#include <algorithm>
+#include <cmath>
+using namespace DPGE;
+using namespace std;
+
+// Define the instance of the shape renderer.
+ShapeRenderer &DPGE::theShapeRenderer =
+  ShapeRenderer::getInstance();
+
+// The maximum distance of the circles to the segments.
+static constexpr float tolerance = 0.25f;
+// The maximum length of a corner of a border, relative to
+// its thickness.
+static constexpr float miterLimit = 4;
+
+// Get the normal of a segment, or 0 if it's empty.
+static SDL_FPoint getNormal(
+  const SDL_FPoint &start, const SDL_FPoint &end)
+{
+  // The direction of the segment.
+  float x = end.x - start.x, y = end.y - start.y;
+  // The length of the segment.
+  float length = sqrtf(x * x + y * y);
+  if (length < 1e-6f)
+    return {0, 0};
+  return {-y / length, x / length};
+}
+
+// Add a line.
+void ShapeRenderer::drawLine(const SDL_FPoint &start,
+  const SDL_FPoint &end, float thickness,
+  const SDL_Color &color)
+{
+  // The normal of the line, by the half thickness.
+  SDL_FPoint normal = getNormal(start, end);
+  // The first corner.
+  int first = 0;
+  if ((normal.x == 0 && normal.y == 0) || thickness <= 0)
+    return;
+  normal.x *= thickness / 2;
+  normal.y *= thickness / 2;
+  first = this->addVertex(
+    {start.x + normal.x, start.y + normal.y}, color);
+  this->addVertex(
+    {end.x + normal.x, end.y + normal.y}, color);
+  this->addVertex(
+    {end.x - normal.x, end.y - normal.y}, color);
+  this->addVertex(
+    {start.x - normal.x, start.y - normal.y}, color);
+  this->addQuad(first, first + 1, first + 2, first + 3);
+}
+
+// Add a filled rectangle.
+void ShapeRenderer::fillRect(
+  const SDL_FRect &rect, const SDL_Color &color)
+{
+  // The first corner.
+  int first = 0;
+  if (rect.w <= 0 || rect.h <= 0)
+    return;
+  first = this->addVertex({rect.x, rect.y}, color);
+  this->addVertex({rect.x + rect.w, rect.y}, color);
+  this->addVertex(
+    {rect.x + rect.w, rect.y + rect.h}, color);
+  this->addVertex({rect.x, rect.y + rect.h}, color);
+  this->addQuad(first, first + 1, first + 2, first + 3);
+}
+
+// Add the border of a rectangle.
+void ShapeRenderer::drawRect(const SDL_FRect &rect,
+  float thickness, const SDL_Color &color)
+{
+  // The half thickness.
+  float half = thickness / 2;
+  if (rect.w <= 0 || rect.h <= 0 || thickness <= 0)
+    return;
+  // A border that fills the rectangle.
+  if (thickness * 2 >= min(rect.w, rect.h))
+  {
+    this->fillRect(rect, color);
+    return;
+  }
+  this->path.clear();
+  this->path.push_back({rect.x + half, rect.y + half});
+  this->path.push_back(
+    {rect.x + rect.w - half, rect.y + half});
+  this->path.push_back(
+    {rect.x + rect.w - half, rect.y + rect.h - half});
+  this->path.push_back(
+    {rect.x + half, rect.y + rect.h - half});
+  this->strokePath(true, thickness, color);
+}
+
+// Add a filled circle.
+void ShapeRenderer::fillCircle(const SDL_FPoint &center,
+  float radius, const SDL_Color &color)
+{
+  // The number of segments of the circle.
+  int segments = countSegments(radius);
+  if (radius <= 0)
+    return;
+  this->path.clear();
+  this->addArc(center, radius, 0,
+    static_cast<float>(2 * M_PI), segments);
+  // The last point is the first one.
+  this->path.pop_back();
+  this->fillPath(color);
+}
+
+// Add the border of a circle.
+void ShapeRenderer::drawCircle(const SDL_FPoint &center,
+  float radius, float thickness, const SDL_Color &color)
+{
+  // The number of segments of the circle.
+  int segments = countSegments(radius);
+  if (radius <= 0 || thickness <= 0)
+    return;
+  if (thickness >= radius)
+  {
+    this->fillCircle(center, radius, color);
+    return;
+  }
+  this->path.clear();
+  this->addArc(center, radius - thickness / 2, 0,
+    static_cast<float>(2 * M_PI), segments);
+  this->path.pop_back();
+  this->strokePath(true, thickness, color);
+}
+
+// Add a filled convex polygon.
+void ShapeRenderer::fillPolygon(const SDL_FPoint *points,
+  int count, const SDL_Color &color)
+{
+  if (!points || count < 3)
+    return;
+  this->path.assign(points, points + count);
+  this->fillPath(color);
+}
+
+// Add the border of a polygon.
+void ShapeRenderer::drawPolygon(const SDL_FPoint *points,
+  int count, float thickness, const SDL_Color &color)
+{
+  if (!points || count < 2 || thickness <= 0)
+    return;
+  this->path.assign(points, points + count);
+  this->strokePath(count > 2, thickness, color);
+}
+
+// Add a filled rectangle with rounded corners.
+void ShapeRenderer::fillRoundedRect(const SDL_FRect &rect,
+  float radius, const SDL_Color &color)
+{
+  if (rect.w <= 0 || rect.h <= 0)
+    return;
+  this->path.clear();
+  this->addRoundedRect(rect, radius);
+  this->fillPath(color);
+}
+
+// Add the border of a rectangle with rounded corners.
+void ShapeRenderer::drawRoundedRect(const SDL_FRect &rect,
+  float radius, float thickness, const SDL_Color &color)
+{
+  // The half thickness.
+  float half = thickness / 2;
+  if (rect.w <= 0 || rect.h <= 0 || thickness <= 0)
+    return;
+  if (thickness * 2 >= min(rect.w, rect.h))
+  {
+    this->fillRoundedRect(rect, radius, color);
+    return;
+  }
+  // The border follows the middle of its thickness.
+  this->path.clear();
+  this->addRoundedRect({rect.x + half, rect.y + half,
+                         rect.w - thickness,
+                         rect.h - thickness},
+    radius - half);
+  this->strokePath(true, thickness, color);
+}
+
+// Draw the added shapes.
+bool ShapeRenderer::flush()
+{
+  // The renderer of the game.
+  SDL_Renderer *renderer = theGame.getRenderer();
+  // The blend mode of the renderer.
+  SDL_BlendMode blend = SDL_BLENDMODE_NONE;
+  // The result of the drawing.
+  bool success = true;
+  // The texture manager flushes the shapes before drawing
+  // them.
+  if (this->indices.empty() || this->flushing)
+    return true;
+  // The triangles without texture use the blend mode of
+  // the renderer.
+  SDL_GetRenderDrawBlendMode(renderer, &blend);
+  SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
+  this->flushing = true;
+  success = theTextureManager.renderGeometry("",
+    this->vertices.data(),
+    static_cast<int>(this->vertices.size()),
+    this->indices.data(),
+    static_cast<int>(this->indices.size()));
+  this->flushing = false;
+  SDL_SetRenderDrawBlendMode(renderer, blend);
+  this->clear();
+  return success;
+}
+
+// Remove the added shapes.
+void ShapeRenderer::clear()
+{
+  this->vertices.clear();
+  this->indices.clear();
+}
+
+// Get the instance of the class.
+ShapeRenderer &ShapeRenderer::getInstance()
+{
+  static ShapeRenderer theInstance;
+  return theInstance;
+}
+
+// Add a vertex.
+int ShapeRenderer::addVertex(
+  const SDL_FPoint &point, const SDL_Color &color)
+{
+  this->vertices.push_back({point, color, {0, 0}});
+  return static_cast<int>(this->vertices.size() - 1);
+}
+
+// Add a quad.
+void ShapeRenderer::addQuad(
+  int first, int second, int third, int fourth)
+{
+  this->indices.push_back(first);
+  this->indices.push_back(second);
+  this->indices.push_back(third);
+  this->indices.push_back(first);
+  this->indices.push_back(third);
+  this->indices.push_back(fourth);
+}
+
+// Add the points of an arc.
+void ShapeRenderer::addArc(const SDL_FPoint &center,
+  float radius, float start, float end, int segments)
+{
+  // The angle of a point.
+  float angle = 0;
+  for (int i = 0; i <= segments; i++)
+  {
+    angle = start + (end - start) * i / segments;
+    this->path.push_back({center.x + radius * cosf(angle),
+      center.y + radius * sinf(angle)});
+  }
+}
+
+// Add the path of a rounded rectangle.
+void ShapeRenderer::addRoundedRect(
+  const SDL_FRect &rect, float radius)
+{
+  // The number of segments of every corner.
+  int segments = 0;
+  // A quarter of circle.
+  const float quarter = static_cast<float>(M_PI / 2);
+  radius = min(radius, min(rect.w, rect.h) / 2);
+  if (radius <= 0)
+  {
+    this->path.push_back({rect.x, rect.y});
+    this->path.push_back({rect.x + rect.w, rect.y});
+    this->path.push_back(
+      {rect.x + rect.w, rect.y + rect.h});
+    this->path.push_back({rect.x, rect.y + rect.h});
+    return;
+  }
+  segments = max(countSegments(radius) / 4, 1);
+  this->addArc(
+    {rect.x + rect.w - radius, rect.y + radius}, radius,
+    -quarter, 0, segments);
+  this->addArc({rect.x + rect.w - radius,
+                 rect.y + rect.h - radius},
+    radius, 0, quarter, segments);
+  this->addArc(
+    {rect.x + radius, rect.y + rect.h - radius}, radius,
+    quarter, 2 * quarter, segments);
+  this->addArc({rect.x + radius, rect.y + radius}, radius,
+    2 * quarter, 3 * quarter, segments);
+  // The sides between equal points are removed.
+  for (size_t i = 1; i < this->path.size(); i++)
+    if (this->path[i].x == this->path[i - 1].x &&
+        this->path[i].y == this->path[i - 1].y)
+      this->path.erase(this->path.begin() + i--);
+}
+
+// Fill the path.
+void ShapeRenderer::fillPath(const SDL_Color &color)
+{
+  // The number of points.
+  int count = static_cast<int>(this->path.size());
+  // The first vertex of the polygon.
+  int first = 0;
+  if (count < 3)
+    return;
+  first = this->addVertex(this->path[0], color);
+  for (int i = 1; i < count; i++)
+    this->addVertex(this->path[i], color);
+  // A fan of triangles from the first vertex.
+  for (int i = 1; i + 1 < count; i++)
+  {
+    this->indices.push_back(first);
+    this->indices.push_back(first + i);
+    this->indices.push_back(first + i + 1);
+  }
+}
+
+// Draw the border of the path.
+void ShapeRenderer::strokePath(
+  bool closed, float thickness, const SDL_Color &color)
+{
+  // The number of points.
+  size_t count = this->path.size();
+  // The first vertex of the border.
+  int first = static_cast<int>(this->vertices.size());
+  // The half thickness.
+  float half = thickness / 2;
+  // The normals of the sides before and after a point.
+  SDL_FPoint before, after;
+  // The direction and the distance of the corner.
+  SDL_FPoint miter;
+  float      distance = 0;
+  if (count < 2)
+    return;
+  // Every point has a vertex outside and another inside.
+  for (size_t i = 0; i < count; i++)
+  {
+    before = {0, 0};
+    after  = {0, 0};
+    if (i > 0 || closed)
+      before = getNormal(
+        this->path[(i + count - 1) % count], this->path[i]);
+    if (i + 1 < count || closed)
+      after = getNormal(
+        this->path[i], this->path[(i + 1) % count]);
+    if (before.x == 0 && before.y == 0)
+      before = after;
+    if (after.x == 0 && after.y == 0)
+      after = before;
+    miter    = {before.x + after.x, before.y + after.y};
+    distance = sqrtf(miter.x * miter.x + miter.y * miter.y);
+    if (distance < 1e-6f)
+      miter = after;
+    else
+    {
+      miter.x /= distance;
+      miter.y /= distance;
+    }
+    // The corner reaches the border of both sides.
+    distance = miter.x * after.x + miter.y * after.y;
+    distance = distance > 1 / miterLimit
+                 ? half / distance
+                 : half * miterLimit;
+    this->addVertex({this->path[i].x + miter.x * distance,
+                      this->path[i].y + miter.y * distance},
+      color);
+    this->addVertex({this->path[i].x - miter.x * distance,
+                      this->path[i].y - miter.y * distance},
+      color);
+  }
+  for (size_t i = 0; i + 1 < count; i++)
+    this->addQuad(first + static_cast<int>(i) * 2,
+      first + static_cast<int>(i) * 2 + 2,
+      first + static_cast<int>(i) * 2 + 3,
+      first + static_cast<int>(i) * 2 + 1);
+  if (closed)
+    this->addQuad(first + static_cast<int>(count) * 2 - 2,
+      first, first + 1,
+      first + static_cast<int>(count) * 2 - 1);
+}
+
+// Get the number of segments of a circle.
+int ShapeRenderer::countSegments(float radius)
+{
+  // The segments are shorter than the tolerance allows.
+  if (radius <= tolerance)
+    return 8;
+  return min(max(static_cast<int>(ceilf(static_cast<float>(
+                   M_PI / acos(1 - tolerance / radius)))),
+               8),
+    512);
+}
@@ -0,0 +1,163 @@
+/// @file ShapeRenderer.hpp
+/// @author Duilio Pérez
+/// @brief A renderer of primitive shapes in a batch.
+#ifndef SHAPERENDERER_HPP
+#define SHAPERENDERER_HPP true
+#include <SDL2/SDL.h>
+#include <vector>
+
+namespace DPGE
+{
+
+  /// @brief A renderer of lines, rectangles, circles and
+  /// polygons.
+  ///
+  /// The shapes are converted in triangles when they are
+  /// added and drawn in batch with a single geometry call
+  /// by the texture manager before the next texture, the
+  /// next change of layer, or when the scene is presented,
+  /// so they keep the order of the draws. It must be used
+  /// from the main thread.
+  class ShapeRenderer final
+  {
+  public:
+    /// @brief Copy constructor deleted.
+    ShapeRenderer(const ShapeRenderer &) = delete;
+    /// @brief Add a line.
+    /// @param start The start point.
+    /// @param end The end point.
+    /// @param thickness The thickness of the line.
+    /// @param color The color of the line.
+    void drawLine(const SDL_FPoint &start,
+      const SDL_FPoint &end, float thickness,
+      const SDL_Color &color);
+    /// @brief Add a filled rectangle.
+    /// @param rect The area of the rectangle.
+    /// @param color The color of the rectangle.
+    void fillRect(
+      const SDL_FRect &rect, const SDL_Color &color);
+    /// @brief Add the border of a rectangle.
+    /// @param rect The area of the rectangle.
+    /// @param thickness The thickness of the border, drawn
+    /// inside the area.
+    /// @param color The color of the border.
+    void drawRect(const SDL_FRect &rect, float thickness,
+      const SDL_Color &color);
+    /// @brief Add a filled circle.
+    /// @param center The center of the circle.
+    /// @param radius The radius of the circle.
+    /// @param color The color of the circle.
+    void fillCircle(const SDL_FPoint &center, float radius,
+      const SDL_Color &color);
+    /// @brief Add the border of a circle.
+    /// @param center The center of the circle.
+    /// @param radius The radius of the circle.
+    /// @param thickness The thickness of the border, drawn
+    /// inside the circle.
+    /// @param color The color of the border.
+    void drawCircle(const SDL_FPoint &center, float radius,
+      float thickness, const SDL_Color &color);
+    /// @brief Add a filled convex polygon.
+    /// @param points The vertices of the polygon, in order.
+    /// @param count The number of vertices.
+    /// @param color The color of the polygon.
+    void fillPolygon(const SDL_FPoint *points, int count,
+      const SDL_Color &color);
+    /// @brief Add the border of a polygon.
+    /// @param points The vertices of the polygon, in order.
+    /// @param count The number of vertices.
+    /// @param thickness The thickness of the border,
+    /// centered on the edges.
+    /// @param color The color of the border.
+    void drawPolygon(const SDL_FPoint *points, int count,
+      float thickness, const SDL_Color &color);
+    /// @brief Add a filled rectangle with rounded corners.
+    /// @param rect The area of the rectangle.
+    /// @param radius The radius of the corners.
+    /// @param color The color of the rectangle.
+    void fillRoundedRect(const SDL_FRect &rect,
+      float radius, const SDL_Color &color);
+    /// @brief Add the border of a rectangle with rounded
+    /// corners.
+    /// @param rect The area of the rectangle.
+    /// @param radius The radius of the corners.
+    /// @param thickness The thickness of the border, drawn
+    /// inside the area.
+    /// @param color The color of the border.
+    void drawRoundedRect(const SDL_FRect &rect,
+      float radius, float thickness,
+      const SDL_Color &color);
+    /// @brief Draw the added shapes and remove them.
+    /// @return true in success, false otherwise.
+    ///
+    /// The shapes are blended with their alpha. The texture
+    /// manager calls it before drawing a texture.
+    bool flush();
+    /// @brief Remove the added shapes without drawing them.
+    void clear();
+    /// @brief Get the instance of the class.
+    static ShapeRenderer &getInstance();
+    /// @brief Copy operator deleted.
+    const ShapeRenderer &operator=(
+      const ShapeRenderer &) = delete;
+
+  private:
+    /// @brief Default constructor.
+    ShapeRenderer() = default;
+    /// @brief Add a vertex.
+    /// @param point The position of the vertex.
+    /// @param color The color of the vertex.
+    /// @return The index of the vertex.
+    int addVertex(
+      const SDL_FPoint &point, const SDL_Color &color);
+    /// @brief Add a quad as two triangles.
+    /// @param first The index of the first corner.
+    /// @param second The index of the second corner.
+    /// @param third The index of the third corner.
+    /// @param fourth The index of the fourth corner.
+    void addQuad(int first, int second, int third,
+      int fourth);
+    /// @brief Add the points of an arc to the path.
+    /// @param center The center of the arc.
+    /// @param radius The radius of the arc.
+    /// @param start The start angle in radians.
+    /// @param end The end angle in radians.
+    /// @param segments The number of segments.
+    void addArc(const SDL_FPoint &center, float radius,
+      float start, float end, int segments);
+    /// @brief Add the path of a rounded rectangle.
+    /// @param rect The area of the rectangle.
+    /// @param radius The radius of the corners.
+    void addRoundedRect(
+      const SDL_FRect &rect, float radius);
+    /// @brief Fill the path as a convex polygon.
+    /// @param color The color of the polygon.
+    void fillPath(const SDL_Color &color);
+    /// @brief Draw the border of the path.
+    /// @param closed true to join the last point with the
+    /// first one.
+    /// @param thickness The thickness of the border.
+    /// @param color The color of the border.
+    void strokePath(bool closed, float thickness,
+      const SDL_Color &color);
+    /// @brief Get the number of segments of a circle.
+    /// @param radius The radius of the circle.
+    /// @return The number of segments.
+    static int countSegments(float radius);
+    /// @brief The vertices of the shapes.
+    std::vector<SDL_Vertex> vertices;
+    /// @brief The triangles of the shapes.
+    std::vector<int> indices;
+    /// @brief The points of the shape being added.
+    std::vector<SDL_FPoint> path;
+    /// @brief Indicator to know if the shapes are being
+    /// drawn.
+    bool flushing = false;
+  };
+
+  /// @brief The shape renderer instance.
+  extern ShapeRenderer &theShapeRenderer;
+
+} // namespace DPGE
+
+#endif
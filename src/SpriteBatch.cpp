@@ -0,0 +1,561 @@
+// File: SpriteBatch.cpp
+// Author: Duilio Pérez
+// Implementation of the sprite batches.
+#include "SpriteBatch.hpp"
+#include "TextureManager.hpp"
+#include <SDL2/SDL.h>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#if defined(__GNUC__) && defined(__SSE2__)
+#define DPGE_SSE2 true
+#include <immintrin.h>
+#endif
+using namespace DPGE;
+using namespace std;
+
+namespace
+{
+
+  // The quads of a block of sprites, by lanes.
+  struct QuadLanes
+  {
+    // The coordinates of the four corners.
+    float x[4][8];
+    float y[4][8];
+    // The minimum and maximum texture coordinates.
+    float u[2][8];
+    float v[2][8];
+  };
+
+  // Get the rotation of a sprite, like SDL.
+  inline void getRotation(const SpriteArrays &sprites,
+    size_t index, float &cosine, float &sine)
+  {
+    // The angle in radians.
+    float radians = 0;
+    if (sprites.angle)
+      radians = static_cast<float>(
+        M_PI * sprites.angle[index] / 180.0);
+    cosine = cosf(radians);
+    sine   = sinf(radians);
+  }
+
+  // Write the vertices of the quads of a block.
+  inline void writeQuads(const QuadLanes &lanes, int count,
+    const SDL_Color &color, SDL_Vertex *vertices)
+  {
+    for (int i = 0; i < count; i++, vertices += 4)
+    {
+      // An empty source isn't drawn.
+      if (lanes.u[1][i] <= lanes.u[0][i] ||
+          lanes.v[1][i] <= lanes.v[0][i])
+      {
+        for (int corner = 0; corner < 4; corner++)
+          vertices[corner] = {
+            {lanes.x[0][i], lanes.y[0][i]}, color, {0, 0}};
+        continue;
+      }
+      vertices[0] = {{lanes.x[0][i], lanes.y[0][i]}, color,
+        {lanes.u[0][i], lanes.v[0][i]}};
+      vertices[1] = {{lanes.x[1][i], lanes.y[1][i]}, color,
+        {lanes.u[1][i], lanes.v[0][i]}};
+      vertices[2] = {{lanes.x[2][i], lanes.y[2][i]}, color,
+        {lanes.u[1][i], lanes.v[1][i]}};
+      vertices[3] = {{lanes.x[3][i], lanes.y[3][i]}, color,
+        {lanes.u[0][i], lanes.v[1][i]}};
+    }
+  }
+
+  // Generate the quads one by one.
+  void generateScalar(const SpriteArrays &sprites,
+    size_t from, size_t to, float textureWidth,
+    float textureHeight, const SDL_Color &color,
+    SDL_Vertex *vertices)
+  {
+    // The quad of a sprite.
+    QuadLanes lanes;
+    // The rotation of a sprite.
+    float cosine = 0, sine = 0;
+    for (size_t i = from; i < to; i++)
+    {
+      // The destination, swapped by the flip.
+      float minX = sprites.x[i];
+      float maxX = sprites.x[i] + sprites.width[i];
+      float minY = sprites.y[i];
+      float maxY = sprites.y[i] + sprites.height[i];
+      // The rotation center.
+      float centerX =
+        (sprites.centerX ? sprites.centerX[i]
+                         : sprites.width[i] / 2.0f) +
+        sprites.x[i];
+      float centerY =
+        (sprites.centerY ? sprites.centerY[i]
+                         : sprites.height[i] / 2.0f) +
+        sprites.y[i];
+      getRotation(sprites, i, cosine, sine);
+      if (sprites.flip &&
+          sprites.flip[i] & SDL_FLIP_HORIZONTAL)
+        swap(minX, maxX);
+      if (sprites.flip &&
+          sprites.flip[i] & SDL_FLIP_VERTICAL)
+        swap(minY, maxY);
+      // The corners relative to the center.
+      minX -= centerX;
+      maxX -= centerX;
+      minY -= centerY;
+      maxY -= centerY;
+      float cornersX[4] = {minX, maxX, maxX, minX};
+      float cornersY[4] = {minY, minY, maxY, maxY};
+      for (int corner = 0; corner < 4; corner++)
+      {
+        lanes.x[corner][0] = (cornersX[corner] * cosine -
+                               cornersY[corner] * sine) +
+                             centerX;
+        lanes.y[corner][0] = (cornersX[corner] * sine +
+                               cornersY[corner] * cosine) +
+                             centerY;
+      }
+      lanes.u[0][0] = 0;
+      lanes.u[1][0] = 1;
+      lanes.v[0][0] = 0;
+      lanes.v[1][0] = 1;
+      if (sprites.srcX)
+      {
+        lanes.u[0][0] =
+          max(sprites.srcX[i], 0.0f) / textureWidth;
+        lanes.u[1][0] =
+          min(sprites.srcX[i] + sprites.srcWidth[i],
+            textureWidth) /
+          textureWidth;
+        lanes.v[0][0] =
+          max(sprites.srcY[i], 0.0f) / textureHeight;
+        lanes.v[1][0] =
+          min(sprites.srcY[i] + sprites.srcHeight[i],
+            textureHeight) /
+          textureHeight;
+      }
+      writeQuads(lanes, 1, color, vertices + 4 * i);
+    }
+  }
+
+#ifdef DPGE_SSE2
+
+  // Choose between two values by a mask.
+  inline __m128 select(
+    __m128 mask, __m128 first, __m128 second)
+  {
+    return _mm_or_ps(_mm_and_ps(mask, first),
+      _mm_andnot_ps(mask, second));
+  }
+
+  // Generate the quads four by four.
+  size_t generateSSE2(const SpriteArrays &sprites,
+    size_t from, size_t count, float textureWidth,
+    float textureHeight, const SDL_Color &color,
+    SDL_Vertex *vertices)
+  {
+    // The constants of the generation.
+    const __m128  half    = _mm_set1_ps(0.5f);
+    const __m128  zero    = _mm_setzero_ps();
+    const __m128  widths  = _mm_set1_ps(textureWidth);
+    const __m128  heights = _mm_set1_ps(textureHeight);
+    const __m128i horizontal =
+      _mm_set1_epi32(SDL_FLIP_HORIZONTAL);
+    const __m128i vertical =
+      _mm_set1_epi32(SDL_FLIP_VERTICAL);
+    // The quads of a block.
+    QuadLanes lanes;
+    // The rotations of a block.
+    alignas(16) float cosines[4], sines[4];
+    // The index of the next sprite.
+    size_t i = from;
+    for (; i + 4 <= count; i += 4)
+    {
+      for (int lane = 0; lane < 4; lane++)
+        getRotation(
+          sprites, i + lane, cosines[lane], sines[lane]);
+      __m128 x      = _mm_loadu_ps(sprites.x + i);
+      __m128 y      = _mm_loadu_ps(sprites.y + i);
+      __m128 width  = _mm_loadu_ps(sprites.width + i);
+      __m128 height = _mm_loadu_ps(sprites.height + i);
+      __m128 cosine = _mm_load_ps(cosines);
+      __m128 sine   = _mm_load_ps(sines);
+      __m128 centerX = _mm_add_ps(
+        sprites.centerX ? _mm_loadu_ps(sprites.centerX + i)
+                        : _mm_mul_ps(width, half),
+        x);
+      __m128 centerY = _mm_add_ps(
+        sprites.centerY ? _mm_loadu_ps(sprites.centerY + i)
+                        : _mm_mul_ps(height, half),
+        y);
+      __m128 minX = x, maxX = _mm_add_ps(x, width);
+      __m128 minY = y, maxY = _mm_add_ps(y, height);
+      if (sprites.flip)
+      {
+        // The flips of the block, a byte per sprite.
+        Sint32 packed = 0;
+        memcpy(&packed, sprites.flip + i, sizeof(packed));
+        __m128i flips = _mm_cvtsi32_si128(packed);
+        flips         = _mm_unpacklo_epi16(
+          _mm_unpacklo_epi8(flips, _mm_setzero_si128()),
+          _mm_setzero_si128());
+        __m128 flipX = _mm_castsi128_ps(_mm_cmpeq_epi32(
+          _mm_and_si128(flips, horizontal), horizontal));
+        __m128 flipY = _mm_castsi128_ps(_mm_cmpeq_epi32(
+          _mm_and_si128(flips, vertical), vertical));
+        __m128 oldMinX = minX, oldMinY = minY;
+        minX = select(flipX, maxX, minX);
+        maxX = select(flipX, oldMinX, maxX);
+        minY = select(flipY, maxY, minY);
+        maxY = select(flipY, oldMinY, maxY);
+      }
+      // The corners relative to the center.
+      minX = _mm_sub_ps(minX, centerX);
+      maxX = _mm_sub_ps(maxX, centerX);
+      minY = _mm_sub_ps(minY, centerY);
+      maxY = _mm_sub_ps(maxY, centerY);
+      __m128 cornersX[4] = {minX, maxX, maxX, minX};
+      __m128 cornersY[4] = {minY, minY, maxY, maxY};
+      for (int corner = 0; corner < 4; corner++)
+      {
+        _mm_storeu_ps(lanes.x[corner],
+          _mm_add_ps(
+            _mm_sub_ps(_mm_mul_ps(cornersX[corner], cosine),
+              _mm_mul_ps(cornersY[corner], sine)),
+            centerX));
+        _mm_storeu_ps(lanes.y[corner],
+          _mm_add_ps(
+            _mm_add_ps(_mm_mul_ps(cornersX[corner], sine),
+              _mm_mul_ps(cornersY[corner], cosine)),
+            centerY));
+      }
+      if (sprites.srcX)
+      {
+        __m128 srcX = _mm_loadu_ps(sprites.srcX + i);
+        __m128 srcY = _mm_loadu_ps(sprites.srcY + i);
+        _mm_storeu_ps(lanes.u[0],
+          _mm_div_ps(_mm_max_ps(srcX, zero), widths));
+        _mm_storeu_ps(lanes.u[1],
+          _mm_div_ps(
+            _mm_min_ps(
+              _mm_add_ps(
+                srcX, _mm_loadu_ps(sprites.srcWidth + i)),
+              widths),
+            widths));
+        _mm_storeu_ps(lanes.v[0],
+          _mm_div_ps(_mm_max_ps(srcY, zero), heights));
+        _mm_storeu_ps(lanes.v[1],
+          _mm_div_ps(
+            _mm_min_ps(
+              _mm_add_ps(
+                srcY, _mm_loadu_ps(sprites.srcHeight + i)),
+              heights),
+            heights));
+      }
+      else
+      {
+        _mm_storeu_ps(lanes.u[0], zero);
+        _mm_storeu_ps(lanes.u[1], _mm_set1_ps(1));
+        _mm_storeu_ps(lanes.v[0], zero);
+        _mm_storeu_ps(lanes.v[1], _mm_set1_ps(1));
+      }
+      writeQuads(lanes, 4, color, vertices + 4 * i);
+    }
+    return i;
+  }
+
+#if defined(__x86_64__) || defined(__i386__)
+#define DPGE_AVX2 true
+
+  // Generate the quads eight by eight.
+  __attribute__((target("avx2"))) size_t generateAVX2(
+    const SpriteArrays &sprites, size_t from, size_t count,
+    float textureWidth, float textureHeight,
+    const SDL_Color &color, SDL_Vertex *vertices)
+  {
+    // The constants of the generation.
+    const __m256  half    = _mm256_set1_ps(0.5f);
+    const __m256  zero    = _mm256_setzero_ps();
+    const __m256  widths  = _mm256_set1_ps(textureWidth);
+    const __m256  heights = _mm256_set1_ps(textureHeight);
+    const __m256i horizontal =
+      _mm256_set1_epi32(SDL_FLIP_HORIZONTAL);
+    const __m256i vertical =
+      _mm256_set1_epi32(SDL_FLIP_VERTICAL);
+    // The quads of a block.
+    QuadLanes lanes;
+    // The rotations of a block.
+    alignas(32) float cosines[8], sines[8];
+    // The index of the next sprite.
+    size_t i = from;
+    for (; i + 8 <= count; i += 8)
+    {
+      for (int lane = 0; lane < 8; lane++)
+        getRotation(
+          sprites, i + lane, cosines[lane], sines[lane]);
+      __m256 x      = _mm256_loadu_ps(sprites.x + i);
+      __m256 y      = _mm256_loadu_ps(sprites.y + i);
+      __m256 width  = _mm256_loadu_ps(sprites.width + i);
+      __m256 height = _mm256_loadu_ps(sprites.height + i);
+      __m256 cosine = _mm256_load_ps(cosines);
+      __m256 sine   = _mm256_load_ps(sines);
+      __m256 centerX = _mm256_add_ps(
+        sprites.centerX
+          ? _mm256_loadu_ps(sprites.centerX + i)
+          : _mm256_mul_ps(width, half),
+        x);
+      __m256 centerY = _mm256_add_ps(
+        sprites.centerY
+          ? _mm256_loadu_ps(sprites.centerY + i)
+          : _mm256_mul_ps(height, half),
+        y);
+      __m256 minX = x, maxX = _mm256_add_ps(x, width);
+      __m256 minY = y, maxY = _mm256_add_ps(y, height);
+      if (sprites.flip)
+      {
+        // The flips of the block, a byte per sprite.
+        __m256i flips =
+          _mm256_cvtepu8_epi32(_mm_loadl_epi64(
+            reinterpret_cast<const __m128i *>(
+              sprites.flip + i)));
+        __m256 flipX =
+          _mm256_castsi256_ps(_mm256_cmpeq_epi32(
+            _mm256_and_si256(flips, horizontal),
+            horizontal));
+        __m256 flipY =
+          _mm256_castsi256_ps(_mm256_cmpeq_epi32(
+            _mm256_and_si256(flips, vertical), vertical));
+        __m256 oldMinX = minX, oldMinY = minY;
+        minX = _mm256_blendv_ps(minX, maxX, flipX);
+        maxX = _mm256_blendv_ps(maxX, oldMinX, flipX);
+        minY = _mm256_blendv_ps(minY, maxY, flipY);
+        maxY = _mm256_blendv_ps(maxY, oldMinY, flipY);
+      }
+      // The corners relative to the center.
+      minX = _mm256_sub_ps(minX, centerX);
+      maxX = _mm256_sub_ps(maxX, centerX);
+      minY = _mm256_sub_ps(minY, centerY);
+      maxY = _mm256_sub_ps(maxY, centerY);
+      __m256 cornersX[4] = {minX, maxX, maxX, minX};
+      __m256 cornersY[4] = {minY, minY, maxY, maxY};
+      for (int corner = 0; corner < 4; corner++)
+      {
+        _mm256_storeu_ps(lanes.x[corner],
+          _mm256_add_ps(
+            _mm256_sub_ps(
+              _mm256_mul_ps(cornersX[corner], cosine),
+              _mm256_mul_ps(cornersY[corner], sine)),
+            centerX));
+        _mm256_storeu_ps(lanes.y[corner],
+          _mm256_add_ps(
+            _mm256_add_ps(
+              _mm256_mul_ps(cornersX[corner], sine),
+              _mm256_mul_ps(cornersY[corner], cosine)),
+            centerY));
+      }
+      if (sprites.srcX)
+      {
+        __m256 srcX = _mm256_loadu_ps(sprites.srcX + i);
+        __m256 srcY = _mm256_loadu_ps(sprites.srcY + i);
+        _mm256_storeu_ps(lanes.u[0],
+          _mm256_div_ps(_mm256_max_ps(srcX, zero), widths));
+        _mm256_storeu_ps(lanes.u[1],
+          _mm256_div_ps(
+            _mm256_min_ps(
+              _mm256_add_ps(srcX,
+                _mm256_loadu_ps(sprites.srcWidth + i)),
+              widths),
+            widths));
+        _mm256_storeu_ps(lanes.v[0],
+          _mm256_div_ps(
+            _mm256_max_ps(srcY, zero), heights));
+        _mm256_storeu_ps(lanes.v[1],
+          _mm256_div_ps(
+            _mm256_min_ps(
+              _mm256_add_ps(srcY,
+                _mm256_loadu_ps(sprites.srcHeight + i)),
+              heights),
+            heights));
+      }
+      else
+      {
+        _mm256_storeu_ps(lanes.u[0], zero);
+        _mm256_storeu_ps(lanes.u[1], _mm256_set1_ps(1));
+        _mm256_storeu_ps(lanes.v[0], zero);
+        _mm256_storeu_ps(lanes.v[1], _mm256_set1_ps(1));
+      }
+      writeQuads(lanes, 8, color, vertices + 4 * i);
+    }
+    return i;
+  }
+
+#endif
+
+#endif
+
+  // Query if the processor supports AVX2.
+  bool useAVX2()
+  {
+#ifdef DPGE_AVX2
+    static const bool hasAVX2 = SDL_HasAVX2();
+    return hasAVX2;
+#else
+    return false;
+#endif
+  }
+
+} // namespace
+
+// Convert sprites in quads of vertices.
+void DPGE::generateSpriteVertices(
+  const SpriteArrays &sprites, size_t count,
+  int textureWidth, int textureHeight,
+  const SDL_Color &color, SDL_Vertex *vertices)
+{
+  // The size of the texture.
+  float width  = static_cast<float>(textureWidth);
+  float height = static_cast<float>(textureHeight);
+  // The sprites already converted.
+  size_t done = 0;
+#ifdef DPGE_AVX2
+  if (useAVX2())
+    done = generateAVX2(
+      sprites, done, count, width, height, color, vertices);
+#endif
+#ifdef DPGE_SSE2
+  done = generateSSE2(
+    sprites, done, count, width, height, color, vertices);
+#endif
+  generateScalar(
+    sprites, done, count, width, height, color, vertices);
+}
+
+// Write the indices of quads.
+void DPGE::generateQuadIndices(
+  int *indices, size_t from, size_t to)
+{
+  for (size_t quad = from; quad < to; quad++)
+  {
+    // The first vertex of the quad.
+    int first = static_cast<int>(quad * 4);
+    indices[quad * 6]     = first;
+    indices[quad * 6 + 1] = first + 1;
+    indices[quad * 6 + 2] = first + 2;
+    indices[quad * 6 + 3] = first;
+    indices[quad * 6 + 4] = first + 2;
+    indices[quad * 6 + 5] = first + 3;
+  }
+}
+
+// Add a sprite.
+void SpriteBatch::add(const SDL_Rect *src,
+  const SDL_FRect &dest, double spriteAngle,
+  const SDL_FPoint       *center,
+  const SDL_RendererFlip &spriteFlip)
+{
+  if (!src)
+    this->wholeSprites.push_back(this->x.size());
+  this->x.push_back(dest.x);
+  this->y.push_back(dest.y);
+  this->width.push_back(dest.w);
+  this->height.push_back(dest.h);
+  this->angle.push_back(static_cast<float>(spriteAngle));
+  this->centerX.push_back(
+    center ? center->x : dest.w / 2.0f);
+  this->centerY.push_back(
+    center ? center->y : dest.h / 2.0f);
+  this->flip.push_back(static_cast<Uint8>(spriteFlip));
+  this->srcX.push_back(src ? src->x : 0);
+  this->srcY.push_back(src ? src->y : 0);
+  this->srcWidth.push_back(src ? src->w : 0);
+  this->srcHeight.push_back(src ? src->h : 0);
+}
+
+// Remove all the sprites.
+void SpriteBatch::clear()
+{
+  this->x.clear();
+  this->y.clear();
+  this->width.clear();
+  this->height.clear();
+  this->angle.clear();
+  this->centerX.clear();
+  this->centerY.clear();
+  this->flip.clear();
+  this->srcX.clear();
+  this->srcY.clear();
+  this->srcWidth.clear();
+  this->srcHeight.clear();
+  this->wholeSprites.clear();
+}
+
+// Get the number of sprites.
+size_t SpriteBatch::getSize() const
+{
+  return this->x.size();
+}
+
+// Draw the sprites.
+bool SpriteBatch::draw(const string &name)
+{
+  // The texture of the sprites.
+  SDL_Texture *texture =
+    theTextureManager.getModifiableTexture(name);
+  // The size of the texture.
+  int textureWidth = 0, textureHeight = 0;
+  // The color of the vertices.
+  SDL_Color color = {255, 255, 255, 255};
+  // The sprites to convert.
+  SpriteArrays sprites;
+  // The number of quads with indices.
+  size_t indexed = this->indices.size() / 6;
+  if (this->x.empty())
+    return true;
+  if (SDL_QueryTexture(texture, nullptr, nullptr,
+        &textureWidth, &textureHeight) < 0)
+  {
+    SDL_LogError(SDL_LOG_CATEGORY_ERROR,
+      "Can't draw a sprite batch: %s.\n", SDL_GetError());
+    return false;
+  }
+  // The whole texture depends on the drawn texture.
+  for (size_t sprite : this->wholeSprites)
+  {
+    this->srcWidth[sprite] =
+      static_cast<float>(textureWidth);
+    this->srcHeight[sprite] =
+      static_cast<float>(textureHeight);
+  }
+  SDL_GetTextureColorMod(
+    texture, &color.r, &color.g, &color.b);
+  SDL_GetTextureAlphaMod(texture, &color.a);
+  sprites.x         = this->x.data();
+  sprites.y         = this->y.data();
+  sprites.width     = this->width.data();
+  sprites.height    = this->height.data();
+  sprites.angle     = this->angle.data();
+  sprites.centerX   = this->centerX.data();
+  sprites.centerY   = this->centerY.data();
+  sprites.flip      = this->flip.data();
+  sprites.srcX      = this->srcX.data();
+  sprites.srcY      = this->srcY.data();
+  sprites.srcWidth  = this->srcWidth.data();
+  sprites.srcHeight = this->srcHeight.data();
+  this->vertices.resize(this->x.size() * 4);
+  generateSpriteVertices(sprites, this->x.size(),
+    textureWidth, textureHeight, color,
+    this->vertices.data());
+  // The indices only grow.
+  if (indexed < this->x.size())
+  {
+    this->indices.resize(this->x.size() * 6);
+    generateQuadIndices(
+      this->indices.data(), indexed, this->x.size());
+  }
+  return theTextureManager.renderGeometry(name,
+    this->vertices.data(),
+    static_cast<int>(this->vertices.size()),
+    this->indices.data(),
+    static_cast<int>(this->x.size() * 6));
+}
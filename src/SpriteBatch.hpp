@@ -0,0 +1,134 @@
+/// @file SpriteBatch.hpp
+/// @author Duilio Pérez
+/// @brief Sprites of a texture drawn in a single call.
+#ifndef SPRITEBATCH_HPP
+#define SPRITEBATCH_HPP true
+#include <SDL2/SDL.h>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace DPGE
+{
+
+  /// @brief The sprites to convert in vertices, with an
+  /// array for every value.
+  ///
+  /// The optional arrays can be nullptr to use the default
+  /// value for all the sprites.
+  struct SpriteArrays
+  {
+    /// @brief The x coordinates of the destinations.
+    const float *x = nullptr;
+    /// @brief The y coordinates of the destinations.
+    const float *y = nullptr;
+    /// @brief The widths of the destinations.
+    const float *width = nullptr;
+    /// @brief The heights of the destinations.
+    const float *height = nullptr;
+    /// @brief The rotation angles in degrees, clockwise.
+    /// Optional, 0 by default.
+    const float *angle = nullptr;
+    /// @brief The x coordinates of the rotation centers,
+    /// relative to the destinations. Optional, the center
+    /// of the destination by default.
+    const float *centerX = nullptr;
+    /// @brief The y coordinates of the rotation centers.
+    /// Optional, like centerX.
+    const float *centerY = nullptr;
+    /// @brief The flip directions, values of
+    /// SDL_RendererFlip. Optional, no flip by default.
+    const Uint8 *flip = nullptr;
+    /// @brief The x coordinates of the source areas.
+    /// Optional with the other source arrays, the whole
+    /// texture by default.
+    const float *srcX = nullptr;
+    /// @brief The y coordinates of the source areas.
+    const float *srcY = nullptr;
+    /// @brief The widths of the source areas.
+    const float *srcWidth = nullptr;
+    /// @brief The heights of the source areas.
+    const float *srcHeight = nullptr;
+  };
+
+  /// @brief Convert sprites in quads of vertices.
+  /// @param sprites The sprites.
+  /// @param count The number of sprites.
+  /// @param textureWidth The width of the texture.
+  /// @param textureHeight The height of the texture.
+  /// @param color The color of the vertices.
+  /// @param vertices Where to write 4 vertices per sprite,
+  /// the top left, top right, bottom right and bottom left
+  /// corners of the destination.
+  ///
+  /// The quads are the same that SDL_RenderCopyExF() draws
+  /// with the same areas, angle, center and flip. The
+  /// source areas are clipped to the texture.
+  void generateSpriteVertices(const SpriteArrays &sprites,
+    size_t count, int textureWidth, int textureHeight,
+    const SDL_Color &color, SDL_Vertex *vertices);
+  /// @brief Write the indices of quads as two triangles.
+  /// @param indices Where to write 6 indices per quad.
+  /// @param from The first quad.
+  /// @param to The quad after the last one.
+  void generateQuadIndices(int *indices, size_t from,
+    size_t to);
+
+  /// @brief A group of sprites of a texture, drawn with a
+  /// single geometry call.
+  ///
+  /// It's faster than rendering the sprites one by one,
+  /// specially when they are rotated, because the
+  /// vertices are generated several at once. The batch is
+  /// drawn by the renderer, also with the tile rasterizer.
+  class SpriteBatch final
+  {
+  public:
+    /// @brief Add a sprite, with the arguments of
+    /// TextureManager::render().
+    /// @param src The source area, nullptr to use the
+    /// whole texture.
+    /// @param dest The destination area.
+    /// @param angle The rotation angle.
+    /// @param center The rotation center, nullptr to set it
+    /// at the center of the destination.
+    /// @param flip The flip direction.
+    void add(const SDL_Rect *src, const SDL_FRect &dest,
+      double angle = 0, const SDL_FPoint *center = nullptr,
+      const SDL_RendererFlip &flip = SDL_FLIP_NONE);
+    /// @brief Remove all the sprites.
+    void clear();
+    /// @brief Get the number of sprites.
+    /// @return The number of sprites.
+    size_t getSize() const;
+    /// @brief Draw the sprites.
+    /// @param name The name of the texture.
+    /// @return true in success, false otherwise.
+    ///
+    /// The sprites are kept, call clear() to add the next
+    /// ones. The color and alpha modulation of the texture
+    /// are applied.
+    bool draw(const std::string &name);
+
+  private:
+    /// @brief The destination areas.
+    std::vector<float> x, y, width, height;
+    /// @brief The rotation angles.
+    std::vector<float> angle;
+    /// @brief The rotation centers.
+    std::vector<float> centerX, centerY;
+    /// @brief The flip directions.
+    std::vector<Uint8> flip;
+    /// @brief The source areas.
+    std::vector<float> srcX, srcY, srcWidth, srcHeight;
+    /// @brief The sprites that use the whole texture.
+    std::vector<size_t> wholeSprites;
+    /// @brief The generated vertices.
+    std::vector<SDL_Vertex> vertices;
+    /// @brief The indices of the quads.
+    std::vector<int> indices;
+  };
+
+} // namespace DPGE
+
+#endif
@@ -0,0 +1,166 @@
+// File: StatsOverlay.cpp
+// Author: Duilio Pérez
+// Implementation of the statistics overlay.
+#include "StatsOverlay.hpp"
+#include "ShapeRenderer.hpp"
+#include "TextureManager.hpp"
+#include <algorithm>
+#include <cstdio>
+using namespace DPGE;
+using namespace std;
+
+// Default constructor.
+StatsOverlay::StatsOverlay()
+{
+  // The name must be unique for every overlay.
+  char name[64];
+  snprintf(name, sizeof(name), "DPGE::StatsOverlay:%p",
+    static_cast<void *>(this));
+  this->textName = name;
+}
+
+// Constructor.
+StatsOverlay::StatsOverlay(const SDL_Rect &overlayArea)
+: StatsOverlay()
+{
+  this->area = overlayArea;
+}
+
+// Destructor.
+StatsOverlay::~StatsOverlay()
+{
+  if (this->hasText)
+    theTextureManager.erase(this->textName);
+}
+
+// Set the area of the overlay.
+void StatsOverlay::setArea(const SDL_Rect &overlayArea)
+{
+  this->area = overlayArea;
+}
+
+// Get the area of the overlay.
+const SDL_Rect &StatsOverlay::getArea() const
+{
+  return this->area;
+}
+
+// Show or hide the overlay.
+void StatsOverlay::setVisible(bool show)
+{
+  this->visible = show;
+}
+
+// Query if the overlay is shown.
+bool StatsOverlay::isVisible() const
+{
+  return this->visible;
+}
+
+// Render the widget.
+void StatsOverlay::render()
+{
+  // The area of the graphs.
+  SDL_Rect graph = {this->area.x + 2,
+    this->area.y + this->area.h / 3, this->area.w - 4,
+    this->area.h - this->area.h / 3 - 2};
+  // The highest number of copies.
+  Uint32 maxCopies = 1;
+  // The sample to draw.
+  int index = 0;
+  // The horizontal limits of a bar.
+  int left = 0, right = 0;
+  // A bar of the graphs.
+  SDL_FRect bar;
+  // The height where the marks of the copies move.
+  Uint32 markRange = 0;
+  if (!this->visible || graph.w <= 0 || graph.h <= 0)
+    return;
+  markRange = static_cast<Uint32>(max(graph.h - 2, 0));
+  this->sample();
+  if (SDL_GetTicks64() - this->lastTextUpdate >= 500)
+    this->updateText();
+  // Background, the shapes are tracked by the damage mode
+  // unlike the draws of the renderer.
+  theShapeRenderer.fillRect(
+    {static_cast<float>(this->area.x),
+      static_cast<float>(this->area.y),
+      static_cast<float>(this->area.w),
+      static_cast<float>(this->area.h)},
+    {0, 0, 0, 160});
+  for (int i = 0; i < historySize; i++)
+    maxCopies = max(maxCopies, this->copies[i]);
+  for (int i = 0; i < historySize; i++)
+  {
+    index = (this->nextSample + i) % historySize;
+    left  = graph.x + i * graph.w / historySize;
+    right = graph.x + (i + 1) * graph.w / historySize;
+    // Frame times, full height is 30 FPS.
+    bar.x = static_cast<float>(left);
+    bar.w = static_cast<float>(max(1, right - left));
+    bar.h = static_cast<float>(static_cast<int>(
+      min(this->frameTimes[index] / 33.3f, 1.0f) *
+      graph.h));
+    bar.y = graph.y + graph.h - bar.h;
+    theShapeRenderer.fillRect(bar, {64, 200, 64, 200});
+    // Copies, as marks scaled to the highest value.
+    bar.h = 2;
+    bar.y = static_cast<float>(graph.y + graph.h - 2 -
+      static_cast<int>(
+        static_cast<Uint64>(this->copies[index]) *
+        markRange / maxCopies));
+    theShapeRenderer.fillRect(bar, {240, 200, 40, 220});
+  }
+  // Counters.
+  if (this->hasText)
+    theTextureManager.render(
+      this->textName, this->area.x + 4, this->area.y + 2);
+}
+
+// Save the statistics of the last frame.
+void StatsOverlay::sample()
+{
+  // The statistics of the last frame.
+  const RenderStats &stats =
+    theTextureManager.getRenderStats();
+  if (stats.frame == this->lastFrame)
+    return;
+  this->lastFrame                    = stats.frame;
+  this->frameTimes[this->nextSample] = stats.frameTime;
+  this->copies[this->nextSample]     = stats.copies;
+  this->nextSample = (this->nextSample + 1) % historySize;
+}
+
+// Rasterize the text of the counters.
+void StatsOverlay::updateText()
+{
+  // The statistics of the last frame.
+  const RenderStats &stats =
+    theTextureManager.getRenderStats();
+  // The previous text color.
+  SDL_Color color = theTextureManager.getForegroundColor();
+  // The average frame time.
+  float frameTime = 0;
+  // The text to show.
+  char text[160];
+  this->lastTextUpdate = SDL_GetTicks64();
+  if (!theTextureManager.getFont())
+    return;
+  for (float nextTime : this->frameTimes)
+    frameTime += nextTime / historySize;
+  snprintf(text, sizeof(text),
+    "%.1f FPS %.2f ms\n"
+    "copies %u switches %u culled %u occluded %u\n"
+    "text %u textures +%u -%u",
+    frameTime > 0 ? 1000 / frameTime : 0.0f, frameTime,
+    stats.copies, stats.textureSwitches, stats.culledDraws,
+    stats.occludedDraws, stats.textRasterizations,
+    stats.texturesCreated, stats.texturesDestroyed);
+  if (this->hasText)
+    theTextureManager.erase(this->textName);
+  theTextureManager.setForegroundColor(
+    {255, 255, 255, 255});
+  this->hasText =
+    theTextureManager.loadFromText(this->textName, text, 0);
+  theTextureManager.setForegroundColor(color);
+}
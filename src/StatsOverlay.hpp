@@ -0,0 +1,79 @@
+/// @file StatsOverlay.hpp
+/// @author Duilio Pérez
+/// @brief A widget to show the rendering statistics.
+#ifndef STATSOVERLAY_HPP
+#define STATSOVERLAY_HPP true
+#include "Widget.hpp"
+#include <SDL2/SDL.h>
+#include <string>
+
+namespace DPGE
+{
+
+  /// @brief A widget that shows the FPS and the counters of
+  /// the texture manager.
+  ///
+  /// The graphs are drawn with the filled rectangles of the
+  /// shape renderer, and the text is only rasterized twice
+  /// per second. Render it just before presenting the
+  /// scene.
+  class StatsOverlay final : public Widget
+  {
+  public:
+    /// @brief Default constructor.
+    StatsOverlay();
+    /// @brief Constructor.
+    /// @param overlayArea The area of the overlay.
+    explicit StatsOverlay(const SDL_Rect &overlayArea);
+    /// @brief Copy constructor deleted.
+    StatsOverlay(const StatsOverlay &) = delete;
+    /// @brief Destructor.
+    ~StatsOverlay();
+    /// @brief Set the area of the overlay.
+    /// @param overlayArea The area of the overlay.
+    void setArea(const SDL_Rect &overlayArea);
+    /// @brief Get the area of the overlay.
+    /// @return The area of the overlay.
+    const SDL_Rect &getArea() const;
+    /// @brief Show or hide the overlay.
+    /// @param show true to show the overlay.
+    void setVisible(bool show);
+    /// @brief Query if the overlay is shown.
+    /// @return true if the overlay is shown.
+    bool isVisible() const;
+    /// @brief Overriden funtion to render the widget.
+    void render() override;
+    /// @brief Copy operator deleted.
+    const StatsOverlay &operator=(
+      const StatsOverlay &) = delete;
+
+  private:
+    /// @brief The number of frames in the graphs.
+    static constexpr int historySize = 120;
+    /// @brief Save the statistics of the last frame.
+    void sample();
+    /// @brief Rasterize the text of the counters.
+    void updateText();
+    /// @brief The area of the overlay.
+    SDL_Rect area = {8, 8, 240, 80};
+    /// @brief Indicator to know if the overlay is shown.
+    bool visible = true;
+    /// @brief The duration of the last frames.
+    float frameTimes[historySize] = {};
+    /// @brief The copies of the last frames.
+    Uint32 copies[historySize] = {};
+    /// @brief The position of the next sample.
+    int nextSample = 0;
+    /// @brief The number of the last sampled frame.
+    Uint64 lastFrame = 0;
+    /// @brief The time of the last text update.
+    Uint64 lastTextUpdate = 0;
+    /// @brief The name of the texture of the text.
+    std::string textName;
+    /// @brief Indicator to know if the text was loaded.
+    bool hasText = false;
+  };
+
+} // namespace DPGE
+
+#endif
@@ -0,0 +1,133 @@
+// File: StreamingTexture.cpp
+// Author: Duilio Pérez
+// Implementation of the streaming textures.
+#include "StreamingTexture.hpp"
+#include <algorithm>
+using namespace DPGE;
+using namespace std;
+
+// Query if two areas overlap or touch.
+static bool touches(
+  const SDL_Rect &first, const SDL_Rect &second)
+{
+  return first.x <= second.x + second.w &&
+         second.x <= first.x + first.w &&
+         first.y <= second.y + second.h &&
+         second.y <= first.y + first.h;
+}
+
+// Constructor.
+StreamingTexture::StreamingTexture(
+  int textureWidth, int textureHeight)
+: width(max(textureWidth, 0)),
+  height(max(textureHeight, 0)),
+  pixels(static_cast<size_t>(width) * height, 0)
+{
+  this->markDirty();
+}
+
+// Get the width of the texture.
+int StreamingTexture::getWidth() const
+{
+  return this->width;
+}
+
+// Get the height of the texture.
+int StreamingTexture::getHeight() const
+{
+  return this->height;
+}
+
+// Get the pixels to modify them.
+Uint32 *StreamingTexture::getPixels()
+{
+  return this->pixels.data();
+}
+
+// Get the pixels.
+const Uint32 *StreamingTexture::getPixels() const
+{
+  return this->pixels.data();
+}
+
+// Set the color of a pixel.
+void StreamingTexture::setPixel(
+  int x, int y, Uint32 color)
+{
+  if (x < 0 || y < 0 || x >= this->width ||
+      y >= this->height)
+    return;
+  this->pixels[y * this->width + x] = color;
+  this->markDirty({x, y, 1, 1});
+}
+
+// Fill an area with a color.
+void StreamingTexture::fill(
+  const SDL_Rect &area, Uint32 color)
+{
+  // The area inside the texture.
+  SDL_Rect bounds = {0, 0, this->width, this->height};
+  if (!SDL_IntersectRect(&area, &bounds, &bounds))
+    return;
+  for (int y = bounds.y; y < bounds.y + bounds.h; y++)
+    fill_n(
+      this->pixels.begin() + y * this->width + bounds.x,
+      bounds.w, color);
+  this->markDirty(bounds);
+}
+
+// Mark an area as modified.
+void StreamingTexture::markDirty(const SDL_Rect &area)
+{
+  // The area inside the texture, merged with the areas it
+  // touches.
+  SDL_Rect merged = {0, 0, this->width, this->height};
+  if (!SDL_IntersectRect(&area, &merged, &merged))
+    return;
+  for (size_t i = 0; i < this->dirtyAreas.size();)
+    if (touches(this->dirtyAreas[i], merged))
+    {
+      // The bigger area may touch the previous ones.
+      SDL_UnionRect(&this->dirtyAreas[i], &merged, &merged);
+      this->dirtyAreas.erase(this->dirtyAreas.begin() + i);
+      i = 0;
+    }
+    else
+      i++;
+  this->dirtyAreas.push_back(merged);
+  // Too many areas cost more than a bigger copy.
+  if (this->dirtyAreas.size() > maxDirtyAreas)
+  {
+    for (const SDL_Rect &dirtyArea : this->dirtyAreas)
+      SDL_UnionRect(&dirtyArea, &merged, &merged);
+    this->dirtyAreas.assign(1, merged);
+  }
+}
+
+// Mark all the texture as modified.
+void StreamingTexture::markDirty()
+{
+  this->dirtyAreas.clear();
+  if (this->width > 0 && this->height > 0)
+    this->dirtyAreas.push_back(
+      {0, 0, this->width, this->height});
+}
+
+// Query if there are areas to upload.
+bool StreamingTexture::isDirty() const
+{
+  return !this->dirtyAreas.empty();
+}
+
+// Get the modified areas.
+const vector<SDL_Rect> &
+  StreamingTexture::getDirtyAreas() const
+{
+  return this->dirtyAreas;
+}
+
+// Forget the modified areas.
+void StreamingTexture::clearDirtyAreas()
+{
+  this->dirtyAreas.clear();
+}
@@ -0,0 +1,88 @@
+/// @file StreamingTexture.hpp
+/// @author Duilio Pérez
+/// @brief The pixels of a texture modified from the CPU.
+#ifndef STREAMINGTEXTURE_HPP
+#define STREAMINGTEXTURE_HPP true
+#include <SDL2/SDL.h>
+#include <vector>
+
+namespace DPGE
+{
+
+  /// @brief The pixels of a streaming texture, kept in
+  /// memory with the areas changed since the last upload.
+  ///
+  /// Create it with
+  /// TextureManager::createStreamingTexture() and modify it
+  /// with getStreamingTexture(). The texture manager
+  /// uploads only the changed areas before the texture is
+  /// drawn and when the scene is presented.
+  class StreamingTexture final
+  {
+  public:
+    /// @brief Constructor.
+    /// @param textureWidth The width of the texture.
+    /// @param textureHeight The height of the texture.
+    ///
+    /// All the pixels start transparent and dirty.
+    StreamingTexture(int textureWidth, int textureHeight);
+    /// @brief Get the width of the texture.
+    /// @return The width of the texture.
+    int getWidth() const;
+    /// @brief Get the height of the texture.
+    /// @return The height of the texture.
+    int getHeight() const;
+    /// @brief Get the pixels to modify them.
+    /// @return The pixels in ARGB8888, in rows of the width
+    /// of the texture.
+    ///
+    /// Call markDirty() with the modified area.
+    Uint32 *getPixels();
+    /// @brief Get the pixels.
+    /// @return The pixels in ARGB8888, in rows of the width
+    /// of the texture.
+    const Uint32 *getPixels() const;
+    /// @brief Set the color of a pixel.
+    /// @param x The x coordinate of the pixel.
+    /// @param y The y coordinate of the pixel.
+    /// @param color The color in ARGB8888.
+    void setPixel(int x, int y, Uint32 color);
+    /// @brief Fill an area with a color.
+    /// @param area The area to fill.
+    /// @param color The color in ARGB8888.
+    void fill(const SDL_Rect &area, Uint32 color);
+    /// @brief Mark an area as modified.
+    /// @param area The modified area.
+    ///
+    /// The areas that overlap or touch are merged, so the
+    /// upload uses a few large copies.
+    void markDirty(const SDL_Rect &area);
+    /// @brief Mark all the texture as modified.
+    void markDirty();
+    /// @brief Query if there are areas to upload.
+    /// @return true if some area was modified.
+    bool isDirty() const;
+    /// @brief Get the areas modified since the last upload.
+    /// @return The modified areas.
+    const std::vector<SDL_Rect> &getDirtyAreas() const;
+    /// @brief Forget the modified areas, after uploading
+    /// them.
+    void clearDirtyAreas();
+
+  private:
+    /// @brief The most areas kept, they are merged in one
+    /// when there are more.
+    static constexpr size_t maxDirtyAreas = 16;
+    /// @brief The width of the texture.
+    int width;
+    /// @brief The height of the texture.
+    int height;
+    /// @brief The pixels.
+    std::vector<Uint32> pixels;
+    /// @brief The modified areas.
+    std::vector<SDL_Rect> dirtyAreas;
+  };
+
+} // namespace DPGE
+
+#endif
@@ -0,0 +1,330 @@
+// File: TextLayout.cpp
+// Author: Duilio Pérez
+// Implementation of the text layout.
+#include "TextLayout.hpp"
+#include <algorithm>
+using namespace DPGE;
+using namespace std;
+
+// Decode the utf-8 code point at a position.
+Uint32 DPGE::decodeUTF8(
+  const string &text, size_t offset, size_t &next)
+{
+  // The first byte.
+  Uint8 first = static_cast<Uint8>(text[offset]);
+  // The number of continuation bytes.
+  size_t length = 0;
+  // The decoded code point.
+  Uint32 codepoint = 0;
+  // A continuation byte.
+  Uint8 byte = 0;
+  next = offset + 1;
+  if (first < 0x80)
+    return first;
+  if ((first & 0xE0) == 0xC0)
+  {
+    length    = 1;
+    codepoint = first & 0x1F;
+  }
+  else if ((first & 0xF0) == 0xE0)
+  {
+    length    = 2;
+    codepoint = first & 0x0F;
+  }
+  else if ((first & 0xF8) == 0xF0)
+  {
+    length    = 3;
+    codepoint = first & 0x07;
+  }
+  else
+    return 0xFFFD;
+  if (offset + length >= text.size())
+    return 0xFFFD;
+  for (size_t i = 1; i <= length; i++)
+  {
+    byte = static_cast<Uint8>(text[offset + i]);
+    if ((byte & 0xC0) != 0x80)
+      return 0xFFFD;
+    codepoint = (codepoint << 6) | (byte & 0x3F);
+  }
+  next = offset + length + 1;
+  return codepoint;
+}
+
+// Query if a code point is a space where a line can wrap.
+static bool isSpace(Uint32 codepoint)
+{
+  return codepoint == ' ' || codepoint == '\t';
+}
+
+// Set the font.
+void TextLayout::setFont(TTF_Font *font)
+{
+  if (font == this->font)
+    return;
+  this->font = font;
+  this->advances.clear();
+  this->lines.clear();
+  this->glyphs.clear();
+  if (!font)
+    return;
+  this->lineSkip   = TTF_FontLineSkip(font);
+  this->fontHeight = TTF_FontHeight(font);
+  this->kerning    = TTF_GetFontKerning(font) != 0;
+  this->layOut(0);
+}
+
+// Get the font.
+TTF_Font *TextLayout::getFont() const
+{
+  return this->font;
+}
+
+// Set the width of text wrap.
+void TextLayout::setWrapWidth(Uint32 width)
+{
+  if (width == this->wrapWidth)
+    return;
+  this->wrapWidth = width;
+  if (this->font)
+    this->layOut(0);
+}
+
+// Get the width of text wrap.
+Uint32 TextLayout::getWrapWidth() const
+{
+  return this->wrapWidth;
+}
+
+// Set the text.
+void TextLayout::setText(const string &text)
+{
+  // The position of the first different byte.
+  size_t change = 0;
+  // The first line to lay out again.
+  size_t line = 0;
+  if (text == this->text && !this->lines.empty())
+    return;
+  while (change < text.size() &&
+         change < this->text.size() &&
+         text[change] == this->text[change])
+    change++;
+  this->text = text;
+  if (!this->font)
+    return;
+  while (line + 1 < this->lines.size() &&
+         this->lines[line + 1].begin <= change)
+    line++;
+  // The previous line can take the first word of the
+  // changed one.
+  if (line > 0)
+    line--;
+  this->layOut(line);
+}
+
+// Get the text.
+const string &TextLayout::getText() const
+{
+  return this->text;
+}
+
+// Get the lines.
+const vector<TextLine> &TextLayout::getLines() const
+{
+  return this->lines;
+}
+
+// Get the glyphs of all the lines.
+const vector<TextGlyph> &TextLayout::getGlyphs() const
+{
+  return this->glyphs;
+}
+
+// Get the width of the widest line.
+int TextLayout::getWidth() const
+{
+  // The width of the widest line.
+  int width = 0;
+  for (const TextLine &line : this->lines)
+    width = max(width, line.width);
+  return width;
+}
+
+// Get the height of the lines.
+int TextLayout::getHeight() const
+{
+  if (this->lines.empty())
+    return 0;
+  // The last line is drawn with the height of the font.
+  return static_cast<int>(this->lines.size() - 1) *
+           this->lineSkip +
+         max(this->lineSkip, this->fontHeight);
+}
+
+// Lay out the text from a line.
+void TextLayout::layOut(size_t line)
+{
+  // The position of the code point being placed.
+  size_t offset = 0;
+  // The position of the next code point.
+  size_t next = 0;
+  // The code point being placed.
+  Uint32 codepoint = 0;
+  // The code point of the previous glyph of the line.
+  Uint32 previous = 0;
+  // The x coordinate after the last glyph.
+  int x = 0;
+  // The kerning and advance of the glyph.
+  int kern = 0, advance = 0;
+  // The wrap width as a coordinate.
+  int limit = static_cast<int>(this->wrapWidth);
+  // The position and first glyph of the last spaces of
+  // the line.
+  size_t spaceOffset = string::npos, spaceGlyph = 0;
+  // The position and first glyph of the word after them.
+  size_t wordOffset = string::npos, wordGlyph = 0;
+  // The line being laid out.
+  TextLine current;
+  if (line < this->lines.size())
+  {
+    offset = this->lines[line].begin;
+    this->glyphs.resize(this->lines[line].firstGlyph);
+  }
+  else
+  {
+    line = 0;
+    this->glyphs.clear();
+  }
+  this->lines.resize(line);
+  current = {offset, offset, this->glyphs.size(), 0,
+    static_cast<int>(line) * this->lineSkip, 0};
+  while (offset < this->text.size())
+  {
+    codepoint = decodeUTF8(this->text, offset, next);
+    // A carriage return before a newline is ignored.
+    if (codepoint == '\r' && next < this->text.size() &&
+        this->text[next] == '\n')
+    {
+      offset = next;
+      continue;
+    }
+    if (codepoint == '\n')
+    {
+      current.glyphCount =
+        this->glyphs.size() - current.firstGlyph;
+      this->lines.push_back(current);
+      current = {next, next, this->glyphs.size(), 0,
+        current.y + this->lineSkip, 0};
+      previous    = 0;
+      x           = 0;
+      spaceOffset = wordOffset = string::npos;
+      offset                   = next;
+      continue;
+    }
+    // Remember where the line can wrap.
+    if (isSpace(codepoint) && !isSpace(previous) &&
+        previous)
+    {
+      spaceOffset = offset;
+      spaceGlyph  = this->glyphs.size();
+      wordOffset  = string::npos;
+    }
+    else if (!isSpace(codepoint) && isSpace(previous) &&
+             spaceOffset != string::npos)
+    {
+      wordOffset = offset;
+      wordGlyph  = this->glyphs.size();
+    }
+    kern    = this->getKerning(previous, codepoint);
+    advance = this->measure(codepoint);
+    // The spaces can overflow, the words wrap.
+    if (limit > 0 && !isSpace(codepoint) &&
+        x + kern + advance > limit &&
+        wordOffset != string::npos)
+    {
+      current.end        = spaceOffset;
+      current.glyphCount = spaceGlyph - current.firstGlyph;
+      current.width      = this->glyphs[spaceGlyph - 1].x +
+                      this->glyphs[spaceGlyph - 1].advance;
+      this->lines.push_back(current);
+      this->glyphs.erase(this->glyphs.begin() + spaceGlyph,
+        this->glyphs.begin() + wordGlyph);
+      current = {wordOffset, offset, spaceGlyph, 0,
+        current.y + this->lineSkip, 0};
+      x = current.width = this->placeGlyphs(spaceGlyph);
+      previous          = 0;
+      if (this->glyphs.size() > spaceGlyph)
+        previous = this->glyphs.back().codepoint;
+      kern        = this->getKerning(previous, codepoint);
+      spaceOffset = wordOffset = string::npos;
+    }
+    // A word wider than the line is broken.
+    if (limit > 0 && !isSpace(codepoint) &&
+        x + kern + advance > limit &&
+        this->glyphs.size() > current.firstGlyph)
+    {
+      current.glyphCount =
+        this->glyphs.size() - current.firstGlyph;
+      this->lines.push_back(current);
+      current = {offset, offset, this->glyphs.size(), 0,
+        current.y + this->lineSkip, 0};
+      previous    = 0;
+      x           = 0;
+      kern        = 0;
+      spaceOffset = wordOffset = string::npos;
+    }
+    this->glyphs.push_back(
+      {codepoint, offset, x + kern, advance});
+    x += kern + advance;
+    previous      = codepoint;
+    current.end   = next;
+    current.width = x;
+    offset        = next;
+  }
+  current.glyphCount =
+    this->glyphs.size() - current.firstGlyph;
+  this->lines.push_back(current);
+}
+
+// Place the glyphs again from the start of a line.
+int TextLayout::placeGlyphs(size_t first)
+{
+  // The x coordinate after the last glyph.
+  int x = 0;
+  // The code point of the previous glyph.
+  Uint32 previous = 0;
+  for (size_t i = first; i < this->glyphs.size(); i++)
+  {
+    this->glyphs[i].x = x + this->getKerning(previous,
+                              this->glyphs[i].codepoint);
+    x        = this->glyphs[i].x + this->glyphs[i].advance;
+    previous = this->glyphs[i].codepoint;
+  }
+  return x;
+}
+
+// Get the advance of a glyph.
+int TextLayout::measure(Uint32 codepoint)
+{
+  // The measured advance.
+  auto measured = this->advances.find(codepoint);
+  // The advance of the glyph.
+  int advance = 0;
+  if (measured != this->advances.end())
+    return measured->second;
+  if (TTF_GlyphMetrics32(this->font, codepoint, nullptr,
+        nullptr, nullptr, nullptr, &advance) < 0)
+    advance = 0;
+  this->advances[codepoint] = advance;
+  return advance;
+}
+
+// Get the kerning between two glyphs.
+int TextLayout::getKerning(
+  Uint32 previous, Uint32 codepoint)
+{
+  if (!this->kerning || !previous)
+    return 0;
+  return TTF_GetFontKerningSizeGlyphs32(
+    this->font, previous, codepoint);
+}
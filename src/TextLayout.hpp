@@ -0,0 +1,153 @@
+/// @file TextLayout.hpp
+/// @author Duilio Pérez
+/// @brief The positions of the glyphs and lines of a text.
+#ifndef TEXTLAYOUT_HPP
+#define TEXTLAYOUT_HPP true
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_ttf.h>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace DPGE
+{
+
+  /// @brief Decode the utf-8 code point at a position.
+  /// @param text The utf-8 text.
+  /// @param offset The position of the first byte.
+  /// @param next Where the position of the next code point
+  /// is saved.
+  /// @return The code point, or U+FFFD if the bytes aren't
+  /// valid.
+  Uint32 decodeUTF8(
+    const std::string &text, size_t offset, size_t &next);
+
+  /// @brief A glyph placed in a line.
+  struct TextGlyph
+  {
+    /// @brief The unicode code point.
+    Uint32 codepoint;
+    /// @brief The position of its first byte in the text.
+    size_t offset;
+    /// @brief The x coordinate from the start of the line,
+    /// with the kerning applied.
+    int x;
+    /// @brief The advance of the glyph.
+    int advance;
+  };
+
+  /// @brief A line of a text.
+  struct TextLine
+  {
+    /// @brief The position of the first byte in the text.
+    size_t begin;
+    /// @brief The position after the last byte in the text,
+    /// without the newline and the spaces of a wrap.
+    size_t end;
+    /// @brief The index of the first glyph.
+    size_t firstGlyph;
+    /// @brief The number of glyphs.
+    size_t glyphCount;
+    /// @brief The y coordinate of the line.
+    int y;
+    /// @brief The width of the line.
+    int width;
+  };
+
+  /// @brief The layout of a utf-8 text with a font.
+  ///
+  /// The glyph advances and the kerning are measured and
+  /// the lines are broken once, when the text, the font or
+  /// the wrap width change, so the layout can be kept and
+  /// rasterized again without measuring the text. When the
+  /// text changes, only the lines from the one before the
+  /// first change are laid out again. The lines are broken
+  /// at newlines, and at spaces when they are wider than
+  /// the wrap width, or between glyphs if a word doesn't
+  /// fit in a line.
+  class TextLayout final
+  {
+  public:
+    /// @brief Set the font.
+    /// @param font The font, nullptr to forget the
+    /// measures of the current one.
+    ///
+    /// Setting the same font does nothing, so set it to
+    /// nullptr before setting it again when its size
+    /// changes or it's closed.
+    void setFont(TTF_Font *font);
+    /// @brief Get the font.
+    /// @return The font, or nullptr if there isn't.
+    TTF_Font *getFont() const;
+    /// @brief Set the width of text wrap.
+    /// @param width The width in pixels, 0 to wrap only at
+    /// newlines.
+    void setWrapWidth(Uint32 width);
+    /// @brief Get the width of text wrap.
+    /// @return The width in pixels, 0 if it wraps only at
+    /// newlines.
+    Uint32 getWrapWidth() const;
+    /// @brief Set the text.
+    /// @param text The utf-8 text.
+    void setText(const std::string &text);
+    /// @brief Get the text.
+    /// @return The utf-8 text.
+    const std::string &getText() const;
+    /// @brief Get the lines.
+    /// @return The lines, there is at least one if there is
+    /// a font.
+    const std::vector<TextLine> &getLines() const;
+    /// @brief Get the glyphs of all the lines.
+    /// @return The glyphs, in order.
+    const std::vector<TextGlyph> &getGlyphs() const;
+    /// @brief Get the width of the widest line.
+    /// @return The width in pixels.
+    int getWidth() const;
+    /// @brief Get the height of the lines.
+    /// @return The height in pixels, the last line is as
+    /// tall as the font.
+    int getHeight() const;
+
+  private:
+    /// @brief Lay out the text from a line.
+    /// @param line The index of the first line to lay out.
+    void layOut(size_t line);
+    /// @brief Place the glyphs again from the start of a
+    /// line.
+    /// @param first The index of the first glyph of the
+    /// line.
+    /// @return The x coordinate after the last glyph.
+    int placeGlyphs(size_t first);
+    /// @brief Get the advance of a glyph.
+    /// @param codepoint The code point of the glyph.
+    /// @return The advance in pixels.
+    int measure(Uint32 codepoint);
+    /// @brief Get the kerning between two glyphs.
+    /// @param previous The code point of the previous
+    /// glyph, 0 if there isn't.
+    /// @param codepoint The code point of the glyph.
+    /// @return The kerning in pixels.
+    int getKerning(Uint32 previous, Uint32 codepoint);
+    /// @brief The font.
+    TTF_Font *font = nullptr;
+    /// @brief The width of text wrap.
+    Uint32 wrapWidth = 0;
+    /// @brief The height of a line.
+    int lineSkip = 0;
+    /// @brief The height of the glyphs.
+    int fontHeight = 0;
+    /// @brief Indicator to know if the font has kerning.
+    bool kerning = false;
+    /// @brief The text.
+    std::string text;
+    /// @brief The lines.
+    std::vector<TextLine> lines;
+    /// @brief The glyphs.
+    std::vector<TextGlyph> glyphs;
+    /// @brief The advances of the measured glyphs.
+    std::unordered_map<Uint32, int> advances;
+  };
+
+} // namespace DPGE
+
+#endif
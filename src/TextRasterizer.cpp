@@ -0,0 +1,288 @@
+// File: TextRasterizer.cpp
+// Author: Duilio Pérez
+// Implementation of the text rasterizer.
+#include "TextRasterizer.hpp"
+#include <algorithm>
+using namespace DPGE;
+using namespace std;
+
+// Define the instance of the text rasterizer.
+TextRasterizer &DPGE::theTextRasterizer =
+  TextRasterizer::getInstance();
+
+// Rasterize a line of text.
+SDL_Surface *TextRasterizer::rasterizeLine(TTF_Font *font,
+  const char *text, TextQuality quality,
+  const SDL_Color &foreground, const SDL_Color &background)
+{
+  // The rasterized line.
+  SDL_Surface *loadedLine = nullptr;
+  switch (quality)
+  {
+  case TextQuality::BLENDED:
+    loadedLine =
+      TTF_RenderUTF8_Blended(font, text, foreground);
+    break;
+  case TextQuality::LCD:
+    loadedLine = TTF_RenderUTF8_LCD(
+      font, text, foreground, background);
+    break;
+  case TextQuality::SHADED:
+    loadedLine = TTF_RenderUTF8_Shaded(
+      font, text, foreground, background);
+    break;
+  case TextQuality::SOLID:
+    loadedLine =
+      TTF_RenderUTF8_Solid(font, text, foreground);
+    break;
+  }
+  return loadedLine;
+}
+
+// Rasterize a laid out text.
+SDL_Surface *TextRasterizer::rasterize(
+  const TextLayout &layout, TextQuality quality,
+  const SDL_Color &foreground, const SDL_Color &background)
+{
+  // The rasterized text.
+  SDL_Surface *loadedText = nullptr;
+  // A rasterized line.
+  SDL_Surface *loadedLine = nullptr;
+  // The text of a line.
+  string lineText;
+  // The area of a line.
+  SDL_Rect lineRect;
+  // The color of the areas without glyphs.
+  Uint32 emptyColor = 0;
+  if (!layout.getFont() || layout.getWidth() <= 0)
+  {
+    SDL_SetError("Text has zero width");
+    return nullptr;
+  }
+  loadedText = SDL_CreateRGBSurfaceWithFormat(0,
+    layout.getWidth(), layout.getHeight(), 32,
+    SDL_PIXELFORMAT_ARGB8888);
+  if (!loadedText)
+    return nullptr;
+  // The shaded texts have background.
+  if (quality == TextQuality::SHADED ||
+      quality == TextQuality::LCD)
+    emptyColor = SDL_MapRGBA(loadedText->format,
+      background.r, background.g, background.b,
+      background.a);
+  SDL_FillRect(loadedText, nullptr, emptyColor);
+  for (const TextLine &line : layout.getLines())
+  {
+    if (line.end == line.begin)
+      continue;
+    lineText.assign(
+      layout.getText(), line.begin, line.end - line.begin);
+    loadedLine = rasterizeLine(layout.getFont(),
+      lineText.c_str(), quality, foreground, background);
+    if (!loadedLine)
+    {
+      SDL_FreeSurface(loadedText);
+      return nullptr;
+    }
+    lineRect = {0, line.y, loadedLine->w, loadedLine->h};
+    SDL_SetSurfaceBlendMode(loadedLine, SDL_BLENDMODE_NONE);
+    SDL_BlitSurface(
+      loadedLine, nullptr, loadedText, &lineRect);
+    SDL_FreeSurface(loadedLine);
+  }
+  return loadedText;
+}
+
+// Queue a text to rasterize.
+void TextRasterizer::request(const string &name,
+  const string &text, Uint32 width, const string &fontPath,
+  int fontSize, TextQuality quality,
+  const SDL_Color &foreground, const SDL_Color &background)
+{
+  // The number of threads.
+  int threads = 0;
+  {
+    lock_guard<mutex> lock(this->jobsMutex);
+    this->lastRequests[name] = this->nextSequence;
+    this->pendingJobs.push_back({name, text, width,
+      fontPath, fontSize, this->fontGeneration, quality,
+      foreground, background, this->nextSequence++,
+      nullptr});
+  }
+  // The threads are started by the first text, they leave
+  // cores for the game loop and the renderer.
+  if (this->workers.empty())
+  {
+    threads = clamp(SDL_GetCPUCount() / 2, 1, 4);
+    for (int i = 0; i < threads; i++)
+      this->workers.emplace_back(
+        &TextRasterizer::work, this);
+  }
+  this->jobsQueued.notify_one();
+}
+
+// Take a rasterized text.
+bool TextRasterizer::take(
+  string &name, SDL_Surface *&surface)
+{
+  // The last request of the texture.
+  map<string, Uint64>::iterator last;
+  lock_guard<mutex> lock(this->jobsMutex);
+  while (!this->finishedJobs.empty())
+  {
+    Job &job = this->finishedJobs.front();
+    last     = this->lastRequests.find(job.name);
+    // The texts requested again or canceled are dropped.
+    if (last != this->lastRequests.end() &&
+        last->second == job.sequence)
+    {
+      this->lastRequests.erase(last);
+      name    = move(job.name);
+      surface = job.surface;
+      this->finishedJobs.pop_front();
+      return true;
+    }
+    SDL_FreeSurface(job.surface);
+    this->finishedJobs.pop_front();
+  }
+  return false;
+}
+
+// Discard the text of a texture.
+void TextRasterizer::cancel(const string &name)
+{
+  lock_guard<mutex> lock(this->jobsMutex);
+  this->lastRequests.erase(name);
+}
+
+// Discard all the texts.
+void TextRasterizer::cancelAll()
+{
+  lock_guard<mutex> lock(this->jobsMutex);
+  this->lastRequests.clear();
+}
+
+// Query if the text of a texture is being rasterized.
+bool TextRasterizer::isPending(const string &name)
+{
+  lock_guard<mutex> lock(this->jobsMutex);
+  return this->lastRequests.find(name) !=
+         this->lastRequests.end();
+}
+
+// Open the fonts again in the next texts.
+void TextRasterizer::reloadFonts()
+{
+  lock_guard<mutex> lock(this->jobsMutex);
+  this->fontGeneration++;
+}
+
+// Open a font while no thread opens or closes another one.
+TTF_Font *TextRasterizer::openFont(
+  const string &path, int size)
+{
+  lock_guard<mutex> fontLock(this->fontMutex);
+  return TTF_OpenFont(path.c_str(), size);
+}
+
+// Close a font while no thread opens or closes another one.
+void TextRasterizer::closeFont(TTF_Font *font)
+{
+  lock_guard<mutex> fontLock(this->fontMutex);
+  if (font)
+    TTF_CloseFont(font);
+}
+
+// Discard the texts and stop the threads.
+void TextRasterizer::stop()
+{
+  {
+    lock_guard<mutex> lock(this->jobsMutex);
+    this->stopping = true;
+    this->pendingJobs.clear();
+    this->lastRequests.clear();
+  }
+  this->jobsQueued.notify_all();
+  for (thread &worker : this->workers)
+    worker.join();
+  this->workers.clear();
+  for (Job &job : this->finishedJobs)
+    SDL_FreeSurface(job.surface);
+  this->finishedJobs.clear();
+  this->stopping = false;
+}
+
+// Get the instance of the class.
+TextRasterizer &TextRasterizer::getInstance()
+{
+  static TextRasterizer theInstance;
+  return theInstance;
+}
+
+// Destructor.
+TextRasterizer::~TextRasterizer()
+{
+  this->stop();
+}
+
+// The loop of a worker thread.
+void TextRasterizer::work()
+{
+  // The text being rasterized.
+  Job job;
+  // The font of the thread.
+  TTF_Font *font = nullptr;
+  // The path, size and generation of the font.
+  string fontPath;
+  int    fontSize       = 0;
+  Uint64 fontGeneration = 0;
+  // The layout of the text.
+  TextLayout layout;
+  // The last request of the texture.
+  map<string, Uint64>::iterator last;
+  unique_lock<mutex> lock(this->jobsMutex);
+  while (true)
+  {
+    this->jobsQueued.wait(lock, [this] {
+      return this->stopping || !this->pendingJobs.empty();
+    });
+    if (this->stopping)
+      break;
+    job = move(this->pendingJobs.front());
+    this->pendingJobs.pop_front();
+    last = this->lastRequests.find(job.name);
+    if (last == this->lastRequests.end() ||
+        last->second != job.sequence)
+      continue;
+    lock.unlock();
+    if (!font || job.fontPath != fontPath ||
+        job.fontSize != fontSize ||
+        job.fontGeneration != fontGeneration)
+    {
+      // The new font can get the address of the old one.
+      layout.setFont(nullptr);
+      this->closeFont(font);
+      font = this->openFont(job.fontPath, job.fontSize);
+      fontPath       = job.fontPath;
+      fontSize       = job.fontSize;
+      fontGeneration = job.fontGeneration;
+    }
+    if (font)
+    {
+      layout.setFont(font);
+      layout.setWrapWidth(job.width);
+      layout.setText(job.text);
+      job.surface = rasterize(layout, job.quality,
+        job.foreground, job.background);
+    }
+    if (!job.surface)
+      SDL_LogError(SDL_LOG_CATEGORY_ERROR,
+        "Error rendering a text: %s.\n", TTF_GetError());
+    lock.lock();
+    this->finishedJobs.push_back(move(job));
+    job.surface = nullptr;
+  }
+  lock.unlock();
+  layout.setFont(nullptr);
+  this->closeFont(font);
+}
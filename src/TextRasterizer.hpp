@@ -0,0 +1,190 @@
+/// @file TextRasterizer.hpp
+/// @author Duilio Pérez
+/// @brief Rasterization of texts in background threads.
+#ifndef TEXTRASTERIZER_HPP
+#define TEXTRASTERIZER_HPP true
+#include "TextLayout.hpp"
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_ttf.h>
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace DPGE
+{
+
+  /// @brief Quality to render text.
+  enum struct TextQuality : unsigned
+  {
+    /// @brief High quality.
+    BLENDED,
+    /// @brief High quality text, with background.
+    LCD,
+    /// @brief Medium text, but with background.
+    SHADED,
+    /// @brief Low quality.
+    SOLID
+  };
+
+  /// @brief A rasterizer of texts in background threads.
+  ///
+  /// The texture manager queues the texts loaded with
+  /// loadFromTextAsync() and uploads the rasterized ones
+  /// when the scene is presented. Every thread opens its
+  /// own instance of the font, because a font can't be
+  /// used by two threads at the same time. When a text is
+  /// requested again before it's finished, only the last
+  /// request is kept.
+  class TextRasterizer final
+  {
+  public:
+    /// @brief Copy constructor deleted.
+    TextRasterizer(const TextRasterizer &) = delete;
+    /// @brief Rasterize a line of text.
+    /// @param font The font.
+    /// @param text The utf-8 text.
+    /// @param quality The quality of the text.
+    /// @param foreground The color of the text.
+    /// @param background The color of the background, for
+    /// the qualities with background.
+    /// @return The rasterized line, or nullptr in error.
+    static SDL_Surface *rasterizeLine(TTF_Font *font,
+      const char *text, TextQuality quality,
+      const SDL_Color &foreground,
+      const SDL_Color &background);
+    /// @brief Rasterize a laid out text.
+    /// @param layout The layout of the text.
+    /// @param quality The quality of the text.
+    /// @param foreground The color of the text.
+    /// @param background The color of the background, for
+    /// the qualities with background.
+    /// @return The rasterized text, or nullptr in error.
+    ///
+    /// Every line is rasterized without measuring it again
+    /// and copied at its position.
+    static SDL_Surface *rasterize(const TextLayout &layout,
+      TextQuality quality, const SDL_Color &foreground,
+      const SDL_Color &background);
+    /// @brief Queue a text to rasterize.
+    /// @param name The name of the texture of the text.
+    /// @param text The utf-8 text.
+    /// @param width The width of text wrap, 0 to wrap only
+    /// at newlines.
+    /// @param fontPath The path of the font.
+    /// @param fontSize The size of the font in points.
+    /// @param quality The quality of the text.
+    /// @param foreground The color of the text.
+    /// @param background The color of the background.
+    void request(const std::string &name,
+      const std::string &text, Uint32 width,
+      const std::string &fontPath, int fontSize,
+      TextQuality quality, const SDL_Color &foreground,
+      const SDL_Color &background);
+    /// @brief Take a rasterized text.
+    /// @param name Where the name of the texture is saved.
+    /// @param surface Where the rasterized text is saved,
+    /// nullptr if it failed. It must be freed.
+    /// @return true if a text was taken, false if none is
+    /// finished.
+    bool take(std::string &name, SDL_Surface *&surface);
+    /// @brief Discard the text of a texture.
+    /// @param name The name of the texture.
+    void cancel(const std::string &name);
+    /// @brief Discard all the texts.
+    void cancelAll();
+    /// @brief Query if the text of a texture is being
+    /// rasterized.
+    /// @param name The name of the texture.
+    /// @return true if it isn't finished or taken yet.
+    bool isPending(const std::string &name);
+    /// @brief Open the fonts again from their files in the
+    /// next texts.
+    void reloadFonts();
+    /// @brief Open a font while no thread opens or closes
+    /// another one.
+    /// @param path The path of the font.
+    /// @param size The size of the font in points.
+    /// @return The font, or nullptr in error.
+    ///
+    /// The fonts share the FreeType library, so the fonts
+    /// used with the threads running must be opened and
+    /// closed with these functions.
+    TTF_Font *openFont(const std::string &path, int size);
+    /// @brief Close a font while no thread opens or closes
+    /// another one.
+    /// @param font The font, it can be nullptr.
+    void closeFont(TTF_Font *font);
+    /// @brief Discard the texts and stop the threads.
+    void stop();
+    /// @brief Get the instance of the class.
+    static TextRasterizer &getInstance();
+    /// @brief Copy operator deleted.
+    const TextRasterizer &operator=(
+      const TextRasterizer &) = delete;
+
+  private:
+    /// @brief A text to rasterize.
+    struct Job
+    {
+      /// @brief The name of the texture.
+      std::string name;
+      /// @brief The utf-8 text.
+      std::string text;
+      /// @brief The width of text wrap.
+      Uint32 width;
+      /// @brief The path of the font.
+      std::string fontPath;
+      /// @brief The size of the font.
+      int fontSize;
+      /// @brief The generation of the font files.
+      Uint64 fontGeneration;
+      /// @brief The quality of the text.
+      TextQuality quality;
+      /// @brief The color of the text.
+      SDL_Color foreground;
+      /// @brief The color of the background.
+      SDL_Color background;
+      /// @brief The number of the request.
+      Uint64 sequence;
+      /// @brief The rasterized text.
+      SDL_Surface *surface;
+    };
+    /// @brief Default constructor.
+    TextRasterizer() = default;
+    /// @brief Destructor, it stops the threads.
+    ~TextRasterizer();
+    /// @brief The loop of a worker thread.
+    void work();
+    /// @brief The worker threads.
+    std::vector<std::thread> workers;
+    /// @brief The texts waiting to be rasterized.
+    std::deque<Job> pendingJobs;
+    /// @brief The rasterized texts.
+    std::deque<Job> finishedJobs;
+    /// @brief The last request of every texture.
+    std::map<std::string, Uint64> lastRequests;
+    /// @brief The number of the next request.
+    Uint64 nextSequence = 1;
+    /// @brief The generation of the font files.
+    Uint64 fontGeneration = 0;
+    /// @brief Mutex of the jobs.
+    std::mutex jobsMutex;
+    /// @brief Mutex to open and close the fonts, which
+    /// share the FreeType library.
+    std::mutex fontMutex;
+    /// @brief Condition to wake the workers.
+    std::condition_variable jobsQueued;
+    /// @brief Indicator to know if the workers must finish.
+    bool stopping = false;
+  };
+
+  /// @brief The text rasterizer instance.
+  extern TextRasterizer &theTextRasterizer;
+
+} // namespace DPGE
+
+#endif
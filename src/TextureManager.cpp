@@ -2,10 +2,15 @@
 // Author: Duilio Pérez
 // Implementation of the texture manager.
 #include "TextureManager.hpp"
+#include "AssetWatcher.hpp"
+#include "FrameCapture.hpp"
 #include "Game.hpp"
+#include "RenderQueue.hpp"
+#include "ShapeRenderer.hpp"
 #include <SDL2/SDL.h>
 #include <SDL2/SDL_image.h>
 #include <SDL2/SDL_ttf.h>
+#include <cstring>
 using namespace DPGE;
 using namespace std;
 
@@ -13,17 +18,29 @@ using namespace std;
 TextureManager &DPGE::theTextureManager =
   TextureManager::getInstance();
 
+// Get the blend mode of the premultiplied colors.
+static SDL_BlendMode premultipliedBlendMode()
+{
+  return SDL_ComposeCustomBlendMode(SDL_BLENDFACTOR_ONE,
+    SDL_BLENDFACTOR_ONE_MINUS_SRC_ALPHA,
+    SDL_BLENDOPERATION_ADD, SDL_BLENDFACTOR_ONE,
+    SDL_BLENDFACTOR_ONE_MINUS_SRC_ALPHA,
+    SDL_BLENDOPERATION_ADD);
+}
+
 // Load the font to render text.
 bool TextureManager::openFont(const string &path, int size)
 {
   // Close the current font if there is one.
   if (this->font)
   {
-    TTF_CloseFont(this->font);
+    this->textLayouts.clear();
+    theTextRasterizer.closeFont(this->font);
     this->font = nullptr;
+    this->fontGeneration++;
   }
-  // Load the font.
-  this->font = TTF_OpenFont(path.c_str(), size);
+  // Load the font, the threads can be opening theirs.
+  this->font = theTextRasterizer.openFont(path, size);
   if (!this->font)
   {
     SDL_ShowSimpleMessageBox(SDL_MESSAGEBOX_ERROR,
@@ -33,6 +50,11 @@ bool TextureManager::openFont(const string &path, int size)
       "Can't load the game's font: %s.\n", TTF_GetError());
     return false;
   }
+  this->fontGeneration++;
+  // Remember the file to reload it when it changes.
+  this->fontPath = path;
+  this->fontSize = size;
+  theAssetWatcher.watch(path, AssetType::FONT, "");
   return true;
 }
 
@@ -40,23 +62,112 @@ bool TextureManager::openFont(const string &path, int size)
 bool TextureManager::loadFromFile(
   const string &name, const string &path)
 {
-  // The texture to loadx
-  SDL_Texture *textureToLoad = nullptr;
+  return this->loadFromFile(name, path, this->imageOptions);
+}
+
+// Load a texture from a file preprocessing the image.
+bool TextureManager::loadFromFile(const string &name,
+  const string &path, const ImageOptions &options)
+{
   // If the texture exists, don't load.
   if (this->textures.find(name) != this->textures.end())
     return false;
-  textureToLoad =
-    IMG_LoadTexture(theGame.getRenderer(), path.c_str());
-  if (!textureToLoad)
+  if (!this->loadImage(name, path, options, true))
+    return false;
+  // Remember the file to reload it when it changes.
+  this->imageSources[name] = {path, options};
+  theAssetWatcher.watch(path, AssetType::TEXTURE, name);
+  return true;
+}
+
+// Load a file in a texture.
+bool TextureManager::loadImage(const string &name,
+  const string &path, const ImageOptions &options,
+  bool showErrors)
+{
+  // The loaded image.
+  SDL_Surface *loadedImage = nullptr;
+  // The half resolution image.
+  SDL_Surface *halfImage = nullptr;
+  // The texture to loadx
+  SDL_Texture *textureToLoad = nullptr;
+  // The half resolution texture.
+  SDL_Texture *halfTexture = nullptr;
+  // The blend mode of the texture.
+  SDL_BlendMode blendMode = SDL_BLENDMODE_NONE;
+  // The size of the image.
+  int width = 0, height = 0;
+  // Indicator to know if the colors were premultiplied.
+  bool premultiplied = false;
+  // Indicator to know if all the pixels are opaque.
+  bool opaque = false;
+  loadedImage = IMG_Load(path.c_str());
+  if (!loadedImage)
   {
-    SDL_ShowSimpleMessageBox(SDL_MESSAGEBOX_ERROR,
-      "Error loading a texture", IMG_GetError(),
-      theGame.getWindow());
+    if (showErrors)
+      SDL_ShowSimpleMessageBox(SDL_MESSAGEBOX_ERROR,
+        "Error loading a texture", IMG_GetError(),
+        theGame.getWindow());
     SDL_LogError(SDL_LOG_CATEGORY_ERROR,
       "Error loading a texture: %s.\n", IMG_GetError());
     return false;
   }
+  // Prepare the image before uploading it.
+  loadedImage =
+    this->prepareImage(loadedImage, options, premultiplied);
+  if (!loadedImage)
+  {
+    if (showErrors)
+      SDL_ShowSimpleMessageBox(SDL_MESSAGEBOX_ERROR,
+        "Error converting an image", SDL_GetError(),
+        theGame.getWindow());
+    SDL_LogError(SDL_LOG_CATEGORY_ERROR,
+      "Error converting an image: %s.\n", SDL_GetError());
+    return false;
+  }
+  opaque        = DPGE::isOpaque(loadedImage);
+  width         = loadedImage->w;
+  height        = loadedImage->h;
+  textureToLoad = this->createTexture(loadedImage);
+  if (textureToLoad && options.halfResolution)
+    halfImage = halveSurface(loadedImage);
+  SDL_FreeSurface(loadedImage);
+  if (!textureToLoad)
+  {
+    SDL_FreeSurface(halfImage);
+    if (showErrors)
+      SDL_ShowSimpleMessageBox(SDL_MESSAGEBOX_ERROR,
+        "Error creating a texture", SDL_GetError(),
+        theGame.getWindow());
+    SDL_LogError(SDL_LOG_CATEGORY_ERROR,
+      "Error creating a texture: %s.\n", SDL_GetError());
+    return false;
+  }
+  if (premultiplied)
+    SDL_SetTextureBlendMode(
+      textureToLoad, premultipliedBlendMode());
   this->textures[name] = textureToLoad;
+  // The layers that missed it must be recorded again.
+  this->invalidateDependents(name);
+  this->markTextureChanged(name);
+  // The opaque textures can hide the draws under them.
+  if (opaque)
+    this->opaqueTextures.insert(textureToLoad);
+  // Upload the half resolution variant.
+  if (halfImage)
+  {
+    halfTexture = this->createTexture(halfImage);
+    if (halfTexture)
+    {
+      SDL_GetTextureBlendMode(textureToLoad, &blendMode);
+      SDL_SetTextureBlendMode(halfTexture, blendMode);
+      if (opaque)
+        this->opaqueTextures.insert(halfTexture);
+      this->halfTextures[name] = {
+        halfTexture, width, height};
+    }
+    SDL_FreeSurface(halfImage);
+  }
   return true;
 }
 
@@ -72,27 +183,7 @@ bool TextureManager::loadFromText(
   if (this->textures.find(name) != this->textures.end())
     return false;
   // Load the text.
-  switch (this->textRenderingQuality)
-  {
-  case TextQuality::BLENDED:
-    loadedText = TTF_RenderUTF8_Blended(
-      this->font, text.c_str(), this->getForegroundColor());
-    break;
-  case TextQuality::LCD:
-    loadedText = TTF_RenderUTF8_LCD(this->font,
-      text.c_str(), this->getForegroundColor(),
-      this->getBackgroundColor());
-    break;
-  case TextQuality::SHADED:
-    loadedText = TTF_RenderUTF8_Shaded(this->font,
-      text.c_str(), this->getForegroundColor(),
-      this->getBackgroundColor());
-    break;
-  case TextQuality::SOLID:
-    loadedText = TTF_RenderUTF8_Solid(
-      this->font, text.c_str(), this->getForegroundColor());
-    break;
-  }
+  loadedText = this->rasterizeText(text);
   if (!loadedText)
   {
     SDL_ShowSimpleMessageBox(SDL_MESSAGEBOX_ERROR,
@@ -103,8 +194,7 @@ bool TextureManager::loadFromText(
     return false;
   }
   // Convert to texture.
-  convertedText = SDL_CreateTextureFromSurface(
-    theGame.getRenderer(), loadedText);
+  convertedText = this->createTexture(loadedText);
   // Free the surfacec
   SDL_FreeSurface(loadedText);
   // If the texture wasn't created, return false.
@@ -118,12 +208,146 @@ bool TextureManager::loadFromText(
     return false;
   }
   this->textures[name] = convertedText;
+  this->textTextures.insert(name);
+  // The layers that missed it must be recorded again.
+  this->invalidateDependents(name);
+  this->markTextureChanged(name);
+  return true;
+}
+
+// Rasterize a text again in the texture of a name.
+bool TextureManager::reloadFromText(const string &name,
+  const string &text, int &width, int &height)
+{
+  // The current texture of the name.
+  auto texture = this->textures.find(name);
+  // The rasterized text.
+  SDL_Surface *loadedText = nullptr;
+  // The pixels of the whole texture.
+  SDL_Surface *pixels = nullptr;
+  // The new texture, if the current one can't be used.
+  SDL_Texture *convertedText = nullptr;
+  // The format and size of the current texture.
+  Uint32 format        = SDL_PIXELFORMAT_UNKNOWN;
+  int    textureWidth  = 0;
+  int    textureHeight = 0;
+  // A text being rasterized isn't loaded later.
+  theTextRasterizer.cancel(name);
+  loadedText = this->rasterizeText(text);
+  if (!loadedText)
+  {
+    SDL_LogError(SDL_LOG_CATEGORY_ERROR,
+      "Error rendering a text: %s.\n", TTF_GetError());
+    return false;
+  }
+  width  = loadedText->w;
+  height = loadedText->h;
+  // Only the textures of texts are used again, the images
+  // can have premultiplied colors or a file to reload.
+  if (texture != this->textures.end() &&
+      this->textTextures.count(name))
+    SDL_QueryTexture(texture->second, &format, nullptr,
+      &textureWidth, &textureHeight);
+  if (format == SDL_PIXELFORMAT_ARGB8888 &&
+      textureWidth >= width && textureHeight >= height)
+  {
+    // The rest of the texture is transparent.
+    pixels = SDL_CreateRGBSurfaceWithFormat(0, textureWidth,
+      textureHeight, 32, SDL_PIXELFORMAT_ARGB8888);
+    if (pixels)
+    {
+      SDL_FillRect(pixels, nullptr, 0);
+      SDL_SetSurfaceBlendMode(
+        loadedText, SDL_BLENDMODE_NONE);
+      SDL_BlitSurface(loadedText, nullptr, pixels, nullptr);
+    }
+    SDL_FreeSurface(loadedText);
+    if (!pixels ||
+        SDL_UpdateTexture(texture->second, nullptr,
+          pixels->pixels, pixels->pitch) < 0)
+    {
+      SDL_LogError(SDL_LOG_CATEGORY_ERROR,
+        "Error updating a texture: %s.\n", SDL_GetError());
+      SDL_FreeSurface(pixels);
+      return false;
+    }
+    if (this->rasterizer)
+      this->rasterizer->updateTexture(texture->second,
+        static_cast<const Uint32 *>(pixels->pixels),
+        textureWidth, textureHeight,
+        {0, 0, textureWidth, textureHeight});
+    if (DPGE::isOpaque(pixels))
+      this->opaqueTextures.insert(texture->second);
+    else
+      this->opaqueTextures.erase(texture->second);
+    SDL_FreeSurface(pixels);
+    if (this->damageTracker)
+      this->damageTracker->changeTexture(texture->second);
+  }
+  else
+  {
+    // The texture grows, keeping the state of the old one.
+    convertedText = this->createTexture(loadedText);
+    SDL_FreeSurface(loadedText);
+    if (!convertedText)
+    {
+      SDL_LogError(SDL_LOG_CATEGORY_ERROR,
+        "Error creating a texture: %s.\n", SDL_GetError());
+      return false;
+    }
+    if (texture != this->textures.end())
+      this->copyTextureState(
+        texture->second, convertedText);
+    this->erase(name);
+    this->textures[name] = convertedText;
+    this->textTextures.insert(name);
+  }
+  this->invalidateDependents(name);
+  this->markTextureChanged(name);
   return true;
 }
 
 // Load a texture from a wrapped text.
 bool TextureManager::loadFromText(
   const string &name, const string &text, Uint32 width)
+{
+  return this->loadFromText(
+    name, this->layOutText(text, width));
+}
+
+// Rasterize a text in the background and load it.
+bool TextureManager::loadFromTextAsync(
+  const string &name, const string &text, Uint32 width)
+{
+  if (!this->font)
+  {
+    SDL_LogError(SDL_LOG_CATEGORY_ERROR,
+      "Can't render a text without font.\n");
+    return false;
+  }
+  theTextRasterizer.request(name, text, width,
+    this->fontPath, this->fontSize,
+    this->textRenderingQuality, this->foregroundTextColor,
+    this->backgroundTextColor);
+  return true;
+}
+
+// Set the time to upload texts in every frame.
+void TextureManager::setTextUploadBudget(
+  Uint32 microseconds)
+{
+  this->textUploadBudget = microseconds;
+}
+
+// Get the time to upload texts in every frame.
+Uint32 TextureManager::getTextUploadBudget() const
+{
+  return this->textUploadBudget;
+}
+
+// Load a texture from a laid out text.
+bool TextureManager::loadFromText(
+  const string &name, const TextLayout &layout)
 {
   // Hold the text temporary.
   SDL_Surface *loadedText = nullptr;
@@ -133,27 +357,7 @@ bool TextureManager::loadFromText(
   if (this->textures.find(name) != this->textures.end())
     return false;
   // Load the text.
-  switch (this->textRenderingQuality)
-  {
-  case TextQuality::BLENDED:
-    loadedText = TTF_RenderUTF8_Blended_Wrapped(this->font,
-      text.c_str(), this->getForegroundColor(), width);
-    break;
-  case TextQuality::LCD:
-    loadedText = TTF_RenderUTF8_LCD_Wrapped(this->font,
-      text.c_str(), this->getForegroundColor(),
-      this->getBackgroundColor(), width);
-    break;
-  case TextQuality::SHADED:
-    loadedText = TTF_RenderUTF8_Shaded_Wrapped(this->font,
-      text.c_str(), this->getForegroundColor(),
-      this->getBackgroundColor(), width);
-    break;
-  case TextQuality::SOLID:
-    loadedText = TTF_RenderUTF8_Solid_Wrapped(this->font,
-      text.c_str(), this->getForegroundColor(), width);
-    break;
-  }
+  loadedText = this->rasterizeText(layout);
   if (!loadedText)
   {
     SDL_ShowSimpleMessageBox(SDL_MESSAGEBOX_ERROR,
@@ -162,8 +366,7 @@ bool TextureManager::loadFromText(
     return false;
   }
   // Convert to texture.
-  convertedText = SDL_CreateTextureFromSurface(
-    theGame.getRenderer(), loadedText);
+  convertedText = this->createTexture(loadedText);
   // Free the surfacec
   SDL_FreeSurface(loadedText);
   // If the texture wasn't created, return false.
@@ -177,6 +380,121 @@ bool TextureManager::loadFromText(
     return false;
   }
   this->textures[name] = convertedText;
+  this->textTextures.insert(name);
+  // The layers that missed it must be recorded again.
+  this->invalidateDependents(name);
+  this->markTextureChanged(name);
+  return true;
+}
+
+// Create a streaming texture.
+bool TextureManager::createStreamingTexture(
+  const string &name, int width, int height)
+{
+  // The created texture.
+  SDL_Texture *texture = nullptr;
+  // If the texture exists, don't create a new one.
+  if (this->textures.find(name) != this->textures.end())
+    return false;
+  texture = SDL_CreateTexture(theGame.getRenderer(),
+    SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STREAMING,
+    width, height);
+  if (!texture)
+  {
+    SDL_ShowSimpleMessageBox(SDL_MESSAGEBOX_ERROR,
+      "Error creating a streaming texture", SDL_GetError(),
+      theGame.getWindow());
+    SDL_LogError(SDL_LOG_CATEGORY_ERROR,
+      "Error creating a streaming texture: %s.\n",
+      SDL_GetError());
+    return false;
+  }
+  this->currentStats.texturesCreated++;
+  SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+  this->textures[name] = texture;
+  // The layers that missed it must be recorded again.
+  this->invalidateDependents(name);
+  this->markTextureChanged(name);
+  this->streamingTextures.emplace(
+    name, StreamingTexture(width, height));
+  return true;
+}
+
+// Get the pixels of a streaming texture.
+StreamingTexture *TextureManager::getStreamingTexture(
+  const string &name)
+{
+  // The pixels of the texture.
+  auto stream = this->streamingTextures.find(name);
+  if (stream == this->streamingTextures.end())
+    return nullptr;
+  return &stream->second;
+}
+
+// Reload a texture from its file.
+bool TextureManager::reload(const string &name)
+{
+  // The file of the texture.
+  auto source = this->imageSources.find(name);
+  // The current texture, kept if the file can't be loaded.
+  SDL_Texture *oldTexture = nullptr;
+  // The current half resolution variant.
+  HalfTexture oldHalf = {nullptr, 0, 0};
+  // The new half resolution variant.
+  auto half = this->halfTextures.end();
+  if (source == this->imageSources.end())
+    return false;
+  oldTexture = this->textures[name];
+  this->textures.erase(name);
+  if (this->halfTextures.count(name))
+  {
+    oldHalf = this->halfTextures[name];
+    this->halfTextures.erase(name);
+  }
+  // A file being written can fail, it's reloaded when
+  // the write finishes.
+  if (!this->loadImage(name, source->second.path,
+        source->second.options, false))
+  {
+    this->textures[name] = oldTexture;
+    if (oldHalf.texture)
+      this->halfTextures[name] = oldHalf;
+    return false;
+  }
+  // The modulation and blend mode of the game are kept.
+  this->copyTextureState(oldTexture, this->textures[name]);
+  half = this->halfTextures.find(name);
+  if (half != this->halfTextures.end())
+    this->copyTextureState(
+      oldTexture, half->second.texture);
+  this->destroyTexture(oldTexture);
+  if (oldHalf.texture)
+    this->destroyTexture(oldHalf.texture);
+  this->invalidateDependents(name);
+  return true;
+}
+
+// Reload the font from its file.
+bool TextureManager::reloadFont()
+{
+  // The reloaded font.
+  TTF_Font *reloadedFont = nullptr;
+  if (!this->font)
+    return false;
+  reloadedFont = theTextRasterizer.openFont(
+    this->fontPath, this->fontSize);
+  if (!reloadedFont)
+  {
+    SDL_LogError(SDL_LOG_CATEGORY_ERROR,
+      "Can't reload the game's font: %s.\n",
+      TTF_GetError());
+    return false;
+  }
+  this->textLayouts.clear();
+  theTextRasterizer.closeFont(this->font);
+  this->font = reloadedFont;
+  this->fontGeneration++;
+  theTextRasterizer.reloadFonts();
   return true;
 }
 
@@ -185,32 +503,26 @@ bool TextureManager::render(const string &name,
   const SDL_Rect *src, const SDL_Rect *dest, double angle,
   const SDL_Point *center, const SDL_RendererFlip &flip)
 {
+  // The source area of a half resolution texture.
+  SDL_Rect halfSrc;
+  // The texture to render.
+  SDL_Texture *texture = this->findTexture(name);
+  if (!texture)
+    return false;
+  if (dest)
+    texture = this->selectResolution(
+      name, texture, src, halfSrc, dest->w, dest->h);
   // Render the texture.
-  if (this->textures.find(name) != this->textures.cend())
-  {
-    if (SDL_RenderCopyEx(theGame.getRenderer(),
-          this->textures[name], src, dest, angle, center,
-          flip) < 0)
-    {
-      SDL_ShowSimpleMessageBox(SDL_MESSAGEBOX_ERROR,
-        "Error copying a texture in the game's renderer",
-        SDL_GetError(), theGame.getWindow());
-      SDL_LogError(SDL_LOG_CATEGORY_ERROR,
-        "Error copying a texture in the game's renderer: "
-        "%s.\n",
-        SDL_GetError());
-      return false;
-    }
-  }
-  else
+  this->countCopy(texture);
+  if (!this->copy(texture, src, dest, angle, center, flip))
   {
     SDL_ShowSimpleMessageBox(SDL_MESSAGEBOX_ERROR,
-      "Can't render",
-      "The texture to render doesn't exists.",
-      theGame.getWindow());
+      "Error copying a texture in the game's renderer",
+      SDL_GetError(), theGame.getWindow());
     SDL_LogError(SDL_LOG_CATEGORY_ERROR,
-      "Can't render: The texture "
-      "to render doesn't exists.\n");
+      "Error copying a texture in the game's renderer: "
+      "%s.\n",
+      SDL_GetError());
     return false;
   }
   return true;
@@ -220,31 +532,53 @@ bool TextureManager::render(const string &name,
 bool TextureManager::render(const string &name,
   const SDL_Rect &src, const SDL_Rect &dest)
 {
+  // The source area.
+  const SDL_Rect *source = &src;
+  // The source area of a half resolution texture.
+  SDL_Rect halfSrc;
+  // The texture to render.
+  SDL_Texture *texture = this->findTexture(name);
+  if (!texture)
+    return false;
+  texture = this->selectResolution(
+    name, texture, source, halfSrc, dest.w, dest.h);
   // Render the texture.
-  if (this->textures.find(name) != this->textures.cend())
+  this->countCopy(texture);
+  if (!this->copy(texture, source, &dest))
   {
-    if (SDL_RenderCopy(theGame.getRenderer(),
-          this->textures[name], &src, &dest) < 0)
-    {
-      SDL_ShowSimpleMessageBox(SDL_MESSAGEBOX_ERROR,
-        "Error copying a texture in the game's renderer",
-        SDL_GetError(), theGame.getWindow());
-      SDL_LogError(SDL_LOG_CATEGORY_ERROR,
-        "Error copying a texture in the game's renderer: "
-        "%s.\n",
-        SDL_GetError());
-      return false;
-    }
+    SDL_ShowSimpleMessageBox(SDL_MESSAGEBOX_ERROR,
+      "Error copying a texture in the game's renderer",
+      SDL_GetError(), theGame.getWindow());
+    SDL_LogError(SDL_LOG_CATEGORY_ERROR,
+      "Error copying a texture in the game's renderer: "
+      "%s.\n",
+      SDL_GetError());
+    return false;
   }
-  else
+  return true;
+}
+
+// Render a texture found before by its name.
+bool TextureManager::render(const string &name,
+  SDL_Texture *texture, const SDL_Rect &src,
+  const SDL_Rect &dest)
+{
+  // The streaming textures and the half resolution
+  // variants need the name to be drawn.
+  if ((!this->streamingTextures.empty() &&
+        this->streamingTextures.count(name)) ||
+      (!this->halfTextures.empty() &&
+        this->halfTextures.count(name)))
+    return this->render(name, src, dest);
+  this->addDependency(name);
+  // Render the texture.
+  this->countCopy(texture);
+  if (!this->copy(texture, &src, &dest))
   {
-    SDL_ShowSimpleMessageBox(SDL_MESSAGEBOX_ERROR,
-      "Can't render",
-      "The texture to render doesn't exists.",
-      theGame.getWindow());
     SDL_LogError(SDL_LOG_CATEGORY_ERROR,
-      "Can't render: The texture "
-      "to render doesn't exists.\n");
+      "Error copying a texture in the game's renderer: "
+      "%s.\n",
+      SDL_GetError());
     return false;
   }
   return true;
@@ -254,31 +588,27 @@ bool TextureManager::render(const string &name,
 bool TextureManager::render(
   const string &name, const SDL_Rect &dest)
 {
+  // The source area.
+  const SDL_Rect *source = nullptr;
+  // The source area of a half resolution texture.
+  SDL_Rect halfSrc;
+  // The texture to render.
+  SDL_Texture *texture = this->findTexture(name);
+  if (!texture)
+    return false;
+  texture = this->selectResolution(
+    name, texture, source, halfSrc, dest.w, dest.h);
   // Render the texture.
-  if (this->textures.find(name) != this->textures.cend())
-  {
-    if (SDL_RenderCopy(theGame.getRenderer(),
-          this->textures[name], nullptr, &dest) < 0)
-    {
-      SDL_ShowSimpleMessageBox(SDL_MESSAGEBOX_ERROR,
-        "Error copying a texture in the game's renderer",
-        SDL_GetError(), theGame.getWindow());
-      SDL_LogError(SDL_LOG_CATEGORY_ERROR,
-        "Error copying a texture in the game's renderer: "
-        "%s.\n",
-        SDL_GetError());
-      return false;
-    }
-  }
-  else
+  this->countCopy(texture);
+  if (!this->copy(texture, source, &dest))
   {
     SDL_ShowSimpleMessageBox(SDL_MESSAGEBOX_ERROR,
-      "Can't render",
-      "The texture to render doesn't exists.",
-      theGame.getWindow());
+      "Error copying a texture in the game's renderer",
+      SDL_GetError(), theGame.getWindow());
     SDL_LogError(SDL_LOG_CATEGORY_ERROR,
-      "Can't render: The texture "
-      "to render doesn't exist.\n");
+      "Error copying a texture in the game's renderer: "
+      "%s.\n",
+      SDL_GetError());
     return false;
   }
   return true;
@@ -290,34 +620,24 @@ bool TextureManager::render(
 {
   // Destination area.
   SDL_Rect dest = {x, y, 0, 0};
-  if (this->textures.find(name) != this->textures.cend())
-  {
-    // Get the dimensions of the texture.
-    SDL_QueryTexture(this->textures.at(name), nullptr,
-      nullptr, &dest.w, &dest.h);
-    // Render the texture.
-    if (SDL_RenderCopy(theGame.getRenderer(),
-          this->textures[name], nullptr, &dest) < 0)
-    {
-      SDL_ShowSimpleMessageBox(SDL_MESSAGEBOX_ERROR,
-        "Error copying a texture in the game's renderer",
-        SDL_GetError(), theGame.getWindow());
-      SDL_LogError(SDL_LOG_CATEGORY_ERROR,
-        "Error copying a texture in the game's renderer: "
-        "%s.\n",
-        SDL_GetError());
-      return false;
-    }
-  }
-  else
+  // The texture to render.
+  SDL_Texture *texture = this->findTexture(name);
+  if (!texture)
+    return false;
+  // Get the dimensions of the texture.
+  SDL_QueryTexture(
+    texture, nullptr, nullptr, &dest.w, &dest.h);
+  // Render the texture.
+  this->countCopy(texture);
+  if (!this->copy(texture, nullptr, &dest))
   {
     SDL_ShowSimpleMessageBox(SDL_MESSAGEBOX_ERROR,
-      "Can't render",
-      "The texture to render doesn't exists.",
-      theGame.getWindow());
+      "Error copying a texture in the game's renderer",
+      SDL_GetError(), theGame.getWindow());
     SDL_LogError(SDL_LOG_CATEGORY_ERROR,
-      "Can't render: The texture to render doesn't "
-      "exists.\n");
+      "Error copying a texture in the game's renderer: "
+      "%s.\n",
+      SDL_GetError());
     return false;
   }
   return true;
@@ -328,32 +648,26 @@ bool TextureManager::render(const string &name,
   const SDL_Rect *src, const SDL_FRect *dest, double angle,
   const SDL_FPoint *center, const SDL_RendererFlip &flip)
 {
+  // The source area of a half resolution texture.
+  SDL_Rect halfSrc;
+  // The texture to render.
+  SDL_Texture *texture = this->findTexture(name);
+  if (!texture)
+    return false;
+  if (dest)
+    texture = this->selectResolution(
+      name, texture, src, halfSrc, dest->w, dest->h);
   // Render the texture.
-  if (this->textures.find(name) != this->textures.cend())
-  {
-    if (SDL_RenderCopyExF(theGame.getRenderer(),
-          this->textures[name], src, dest, angle, center,
-          flip) < 0)
-    {
-      SDL_ShowSimpleMessageBox(SDL_MESSAGEBOX_ERROR,
-        "Error copying a texture in the game's renderer",
-        SDL_GetError(), theGame.getWindow());
-      SDL_LogError(SDL_LOG_CATEGORY_ERROR,
-        "Error copying a texture in the game's renderer: "
-        "%s.\n",
-        SDL_GetError());
-      return false;
-    }
-  }
-  else
+  this->countCopy(texture);
+  if (!this->copy(texture, src, dest, angle, center, flip))
   {
     SDL_ShowSimpleMessageBox(SDL_MESSAGEBOX_ERROR,
-      "Can't render",
-      "The texture to render doesn't exists.",
-      theGame.getWindow());
+      "Error copying a texture in the game's renderer",
+      SDL_GetError(), theGame.getWindow());
     SDL_LogError(SDL_LOG_CATEGORY_ERROR,
-      "Can't render: The texture "
-      "to render doesn't exists.\n");
+      "Error copying a texture in the game's renderer: "
+      "%s.\n",
+      SDL_GetError());
     return false;
   }
   return true;
@@ -363,31 +677,27 @@ bool TextureManager::render(const string &name,
 bool TextureManager::render(const string &name,
   const SDL_Rect &src, const SDL_FRect &dest)
 {
+  // The source area.
+  const SDL_Rect *source = &src;
+  // The source area of a half resolution texture.
+  SDL_Rect halfSrc;
+  // The texture to render.
+  SDL_Texture *texture = this->findTexture(name);
+  if (!texture)
+    return false;
+  texture = this->selectResolution(
+    name, texture, source, halfSrc, dest.w, dest.h);
   // Render the texture.
-  if (this->textures.find(name) != this->textures.cend())
-  {
-    if (SDL_RenderCopyF(theGame.getRenderer(),
-          this->textures[name], &src, &dest) < 0)
-    {
-      SDL_ShowSimpleMessageBox(SDL_MESSAGEBOX_ERROR,
-        "Error copying a texture in the game's renderer",
-        SDL_GetError(), theGame.getWindow());
-      SDL_LogError(SDL_LOG_CATEGORY_ERROR,
-        "Error copying a texture in the game's renderer: "
-        "%s.\n",
-        SDL_GetError());
-      return false;
-    }
-  }
-  else
+  this->countCopy(texture);
+  if (!this->copy(texture, source, &dest))
   {
     SDL_ShowSimpleMessageBox(SDL_MESSAGEBOX_ERROR,
-      "Can't render",
-      "The texture to render doesn't exists.",
-      theGame.getWindow());
+      "Error copying a texture in the game's renderer",
+      SDL_GetError(), theGame.getWindow());
     SDL_LogError(SDL_LOG_CATEGORY_ERROR,
-      "Can't render: The texture "
-      "to render doesn't exists.\n");
+      "Error copying a texture in the game's renderer: "
+      "%s.\n",
+      SDL_GetError());
     return false;
   }
   return true;
@@ -397,31 +707,27 @@ bool TextureManager::render(const string &name,
 bool TextureManager::render(
   const string &name, const SDL_FRect &dest)
 {
+  // The source area.
+  const SDL_Rect *source = nullptr;
+  // The source area of a half resolution texture.
+  SDL_Rect halfSrc;
+  // The texture to render.
+  SDL_Texture *texture = this->findTexture(name);
+  if (!texture)
+    return false;
+  texture = this->selectResolution(
+    name, texture, source, halfSrc, dest.w, dest.h);
   // Render the texture.
-  if (this->textures.find(name) != this->textures.cend())
-  {
-    if (SDL_RenderCopyF(theGame.getRenderer(),
-          this->textures[name], nullptr, &dest) < 0)
-    {
-      SDL_ShowSimpleMessageBox(SDL_MESSAGEBOX_ERROR,
-        "Error copying a texture in the game's renderer",
-        SDL_GetError(), theGame.getWindow());
-      SDL_LogError(SDL_LOG_CATEGORY_ERROR,
-        "Error copying a texture in the game's renderer: "
-        "%s.\n",
-        SDL_GetError());
-      return false;
-    }
-  }
-  else
+  this->countCopy(texture);
+  if (!this->copy(texture, source, &dest))
   {
     SDL_ShowSimpleMessageBox(SDL_MESSAGEBOX_ERROR,
-      "Can't render",
-      "The texture to render doesn't exists.",
-      theGame.getWindow());
+      "Error copying a texture in the game's renderer",
+      SDL_GetError(), theGame.getWindow());
     SDL_LogError(SDL_LOG_CATEGORY_ERROR,
-      "Can't render: The texture "
-      "to render doesn't exist.\n");
+      "Error copying a texture in the game's renderer: "
+      "%s.\n",
+      SDL_GetError());
     return false;
   }
   return true;
@@ -439,27 +745,7 @@ bool TextureManager::renderText(const string &text,
   // Destination area.
   SDL_Rect destRect = {dest.x, dest.y, 0, 0};
   // Load the text.
-  switch (this->textRenderingQuality)
-  {
-  case TextQuality::BLENDED:
-    loadedText = TTF_RenderUTF8_Blended(
-      this->font, text.c_str(), this->getForegroundColor());
-    break;
-  case TextQuality::LCD:
-    loadedText = TTF_RenderUTF8_LCD(this->font,
-      text.c_str(), this->getForegroundColor(),
-      this->getBackgroundColor());
-    break;
-  case TextQuality::SHADED:
-    loadedText = TTF_RenderUTF8_Shaded(this->font,
-      text.c_str(), this->getForegroundColor(),
-      this->getBackgroundColor());
-    break;
-  case TextQuality::SOLID:
-    loadedText = TTF_RenderUTF8_Solid(
-      this->font, text.c_str(), this->getForegroundColor());
-    break;
-  }
+  loadedText = this->rasterizeText(text);
   // Verify if the text was loaded.
   if (!loadedText)
   {
@@ -471,8 +757,7 @@ bool TextureManager::renderText(const string &text,
     return false;
   }
   // Convert the surface into texture.
-  convertedText = SDL_CreateTextureFromSurface(
-    theGame.getRenderer(), loadedText);
+  convertedText = this->createTexture(loadedText);
   // Free the surface.
   SDL_FreeSurface(loadedText);
   // Verify if the texture was created.
@@ -489,10 +774,11 @@ bool TextureManager::renderText(const string &text,
   SDL_QueryTexture(convertedText, nullptr, nullptr,
     &destRect.w, &destRect.h);
   // Show the texture.
-  if (SDL_RenderCopyEx(theGame.getRenderer(), convertedText,
-        nullptr, &destRect, angle, center, flip) < 0)
+  this->countCopy(convertedText);
+  if (!this->copy(convertedText, nullptr, &destRect, angle,
+        center, flip))
   {
-    SDL_DestroyTexture(convertedText);
+    this->destroyTexture(convertedText);
     SDL_ShowSimpleMessageBox(SDL_MESSAGEBOX_ERROR,
       "Error copying a texture", SDL_GetError(),
       theGame.getWindow());
@@ -500,7 +786,7 @@ bool TextureManager::renderText(const string &text,
       "Error copying a texture: %s.\n", SDL_GetError());
     return false;
   }
-  SDL_DestroyTexture(convertedText);
+  this->destroyTexture(convertedText);
   return true;
 }
 
@@ -520,27 +806,7 @@ bool TextureManager::renderText(const string &text,
   // Text's texture's height.
   int textureHeight = 0;
   // Load the text.
-  switch (this->textRenderingQuality)
-  {
-  case TextQuality::BLENDED:
-    loadedText = TTF_RenderUTF8_Blended(
-      this->font, text.c_str(), this->getForegroundColor());
-    break;
-  case TextQuality::LCD:
-    loadedText = TTF_RenderUTF8_LCD(this->font,
-      text.c_str(), this->getForegroundColor(),
-      this->getBackgroundColor());
-    break;
-  case TextQuality::SHADED:
-    loadedText = TTF_RenderUTF8_Shaded(this->font,
-      text.c_str(), this->getForegroundColor(),
-      this->getBackgroundColor());
-    break;
-  case TextQuality::SOLID:
-    loadedText = TTF_RenderUTF8_Solid(
-      this->font, text.c_str(), this->getForegroundColor());
-    break;
-  }
+  loadedText = this->rasterizeText(text);
   // Verify if the text was loaded.
   if (!loadedText)
   {
@@ -552,8 +818,7 @@ bool TextureManager::renderText(const string &text,
     return false;
   }
   // Convert the surface into texture.
-  convertedText = SDL_CreateTextureFromSurface(
-    theGame.getRenderer(), loadedText);
+  convertedText = this->createTexture(loadedText);
   // Free the surface.
   SDL_FreeSurface(loadedText);
   // Verify if the texture was created.
@@ -572,11 +837,11 @@ bool TextureManager::renderText(const string &text,
   destRect.w = textureWidth;
   destRect.h = textureHeight;
   // Show the texture.
-  if (SDL_RenderCopyExF(theGame.getRenderer(),
-        convertedText, nullptr, &destRect, angle, center,
-        flip) < 0)
+  this->countCopy(convertedText);
+  if (!this->copy(convertedText, nullptr, &destRect, angle,
+        center, flip))
   {
-    SDL_DestroyTexture(convertedText);
+    this->destroyTexture(convertedText);
     SDL_ShowSimpleMessageBox(SDL_MESSAGEBOX_ERROR,
       "Error copying a texture", SDL_GetError(),
       theGame.getWindow());
@@ -584,7 +849,7 @@ bool TextureManager::renderText(const string &text,
       "Error copying a texture: %s.\n", SDL_GetError());
     return false;
   }
-  SDL_DestroyTexture(convertedText);
+  this->destroyTexture(convertedText);
   return true;
 }
 
@@ -599,27 +864,7 @@ bool TextureManager::renderText(
   // Destination area.
   SDL_Rect destRect = {x, y, 0, 0};
   // Load the text.
-  switch (this->textRenderingQuality)
-  {
-  case TextQuality::BLENDED:
-    loadedText = TTF_RenderUTF8_Blended(
-      this->font, text.c_str(), this->getForegroundColor());
-    break;
-  case TextQuality::LCD:
-    loadedText = TTF_RenderUTF8_LCD(this->font,
-      text.c_str(), this->getForegroundColor(),
-      this->getBackgroundColor());
-    break;
-  case TextQuality::SHADED:
-    loadedText = TTF_RenderUTF8_Shaded(this->font,
-      text.c_str(), this->getForegroundColor(),
-      this->getBackgroundColor());
-    break;
-  case TextQuality::SOLID:
-    loadedText = TTF_RenderUTF8_Solid(
-      this->font, text.c_str(), this->getForegroundColor());
-    break;
-  }
+  loadedText = this->rasterizeText(text);
   // Verify if the text was loaded.
   if (!loadedText)
   {
@@ -631,8 +876,7 @@ bool TextureManager::renderText(
     return false;
   }
   // Convert the surface into texture.
-  convertedText = SDL_CreateTextureFromSurface(
-    theGame.getRenderer(), loadedText);
+  convertedText = this->createTexture(loadedText);
   // Free the surface.
   SDL_FreeSurface(loadedText);
   // Verify if the texture was created.
@@ -649,10 +893,10 @@ bool TextureManager::renderText(
   SDL_QueryTexture(convertedText, nullptr, nullptr,
     &destRect.w, &destRect.h);
   // Show the texture.
-  if (SDL_RenderCopy(theGame.getRenderer(), convertedText,
-        nullptr, &destRect) < 0)
+  this->countCopy(convertedText);
+  if (!this->copy(convertedText, nullptr, &destRect))
   {
-    SDL_DestroyTexture(convertedText);
+    this->destroyTexture(convertedText);
     SDL_ShowSimpleMessageBox(SDL_MESSAGEBOX_ERROR,
       "Error copying a texture", SDL_GetError(),
       theGame.getWindow());
@@ -660,13 +904,21 @@ bool TextureManager::renderText(
       "Error copying a texture: %s.\n", SDL_GetError());
     return false;
   }
-  SDL_DestroyTexture(convertedText);
+  this->destroyTexture(convertedText);
   return true;
 }
 
-// Render a text.
+// Render a wrapped text.
 bool TextureManager::renderText(
   const string &text, int x, int y, Uint32 width)
+{
+  return this->renderText(
+    this->layOutText(text, width), x, y);
+}
+
+// Render a laid out text.
+bool TextureManager::renderText(
+  const TextLayout &layout, int x, int y)
 {
   // The loaded text.
   SDL_Surface *loadedText = nullptr;
@@ -675,27 +927,7 @@ bool TextureManager::renderText(
   // Destination area.
   SDL_Rect destRect = {x, y, 0, 0};
   // Load the text.
-  switch (this->textRenderingQuality)
-  {
-  case TextQuality::BLENDED:
-    loadedText = TTF_RenderUTF8_Blended_Wrapped(this->font,
-      text.c_str(), this->getForegroundColor(), width);
-    break;
-  case TextQuality::LCD:
-    loadedText = TTF_RenderUTF8_LCD_Wrapped(this->font,
-      text.c_str(), this->getForegroundColor(),
-      this->getBackgroundColor(), width);
-    break;
-  case TextQuality::SHADED:
-    loadedText = TTF_RenderUTF8_Shaded_Wrapped(this->font,
-      text.c_str(), this->getForegroundColor(),
-      this->getBackgroundColor(), width);
-    break;
-  case TextQuality::SOLID:
-    loadedText = TTF_RenderUTF8_Solid_Wrapped(this->font,
-      text.c_str(), this->getForegroundColor(), width);
-    break;
-  }
+  loadedText = this->rasterizeText(layout);
   // Verify if the text was loaded.
   if (!loadedText)
   {
@@ -707,8 +939,7 @@ bool TextureManager::renderText(
     return false;
   }
   // Convert the surface into texture.
-  convertedText = SDL_CreateTextureFromSurface(
-    theGame.getRenderer(), loadedText);
+  convertedText = this->createTexture(loadedText);
   // Free the surface.
   SDL_FreeSurface(loadedText);
   // Verify if the texture was created.
@@ -725,10 +956,10 @@ bool TextureManager::renderText(
   SDL_QueryTexture(convertedText, nullptr, nullptr,
     &destRect.w, &destRect.h);
   // Show the texture.
-  if (SDL_RenderCopy(theGame.getRenderer(), convertedText,
-        nullptr, &destRect) < 0)
+  this->countCopy(convertedText);
+  if (!this->copy(convertedText, nullptr, &destRect))
   {
-    SDL_DestroyTexture(convertedText);
+    this->destroyTexture(convertedText);
     SDL_ShowSimpleMessageBox(SDL_MESSAGEBOX_ERROR,
       "Error copying a texture", SDL_GetError(),
       theGame.getWindow());
@@ -737,17 +968,349 @@ bool TextureManager::renderText(
     return false;
   }
   // Destroy the texture.
-  SDL_DestroyTexture(convertedText);
+  this->destroyTexture(convertedText);
   return true;
 }
 
-// Present the current scene.
-void TextureManager::present()
+// Copy a texture.
+bool TextureManager::copy(SDL_Texture *texture,
+  const SDL_Rect *src, const SDL_FRect *dest, double angle,
+  const SDL_FPoint *center, const SDL_RendererFlip &flip)
 {
-  SDL_RenderPresent(theGame.getRenderer());
+  // The shapes added before are drawn under the texture.
+  theShapeRenderer.flush();
+  // The layers are recorded by the renderer.
+  if (this->damageTracker && this->recordingLayers.empty())
+  {
+    this->damageTracker->copy(
+      texture, src, dest, angle, center, flip);
+    return true;
+  }
+  if (this->rasterizer && this->recordingLayers.empty() &&
+      this->rasterizer->copy(
+        texture, src, dest, angle, center, flip))
+    return true;
+  // The renderer draws over the copies recorded before.
+  this->flushRasterizer();
+  return SDL_RenderCopyExF(theGame.getRenderer(), texture,
+           src, dest, angle, center, flip) == 0;
 }
 
-// Change the font used to render text.
+// Render triangles with a texture.
+bool TextureManager::renderGeometry(const string &name,
+  const SDL_Vertex *vertices, int vertexCount,
+  const int *indices, int indexCount)
+{
+  // The texture of the triangles.
+  SDL_Texture *texture = nullptr;
+  // The shapes added before are drawn under the triangles.
+  theShapeRenderer.flush();
+  if (!name.empty())
+  {
+    texture = this->findTexture(name);
+    if (!texture)
+      return false;
+  }
+  this->countCopy(texture);
+  if (this->damageTracker && this->recordingLayers.empty())
+  {
+    this->damageTracker->geometry(texture, vertices,
+      vertexCount, indices, indexCount);
+    return true;
+  }
+  // The renderer draws over the copies recorded before.
+  this->flushRasterizer();
+  if (SDL_RenderGeometry(theGame.getRenderer(), texture,
+        vertices, vertexCount, indices, indexCount) < 0)
+  {
+    SDL_LogError(SDL_LOG_CATEGORY_ERROR,
+      "Error rendering geometry in the game's renderer: "
+      "%s.\n",
+      SDL_GetError());
+    return false;
+  }
+  return true;
+}
+
+// Set the color modulation of a texture.
+bool TextureManager::setColorMod(
+  const string &name, Uint8 red, Uint8 green, Uint8 blue)
+{
+  // The texture to modify.
+  auto texture = this->textures.find(name);
+  // The half resolution variant.
+  auto half = this->halfTextures.find(name);
+  if (texture == this->textures.end())
+  {
+    SDL_LogError(SDL_LOG_CATEGORY_ERROR,
+      "Can't modify a texture: The texture doesn't "
+      "exist.\n");
+    return false;
+  }
+  if (half != this->halfTextures.end())
+    this->setColorMod(
+      half->second.texture, red, green, blue);
+  return this->setColorMod(
+    texture->second, red, green, blue);
+}
+
+// Set the color modulation of a texture.
+bool TextureManager::setColorMod(
+  SDL_Texture *texture, Uint8 red, Uint8 green, Uint8 blue)
+{
+  // The known state of the texture.
+  TextureState &state = this->getTextureState(texture);
+  if (state.red == red && state.green == green &&
+      state.blue == blue)
+    return true;
+  state.red   = red;
+  state.green = green;
+  state.blue  = blue;
+  return this->sendColorMod(texture, state);
+}
+
+// Set the alpha modulation of a texture.
+bool TextureManager::setAlphaMod(
+  const string &name, Uint8 alpha)
+{
+  // The texture to modify.
+  auto texture = this->textures.find(name);
+  // The half resolution variant.
+  auto half = this->halfTextures.find(name);
+  if (texture == this->textures.end())
+  {
+    SDL_LogError(SDL_LOG_CATEGORY_ERROR,
+      "Can't modify a texture: The texture doesn't "
+      "exist.\n");
+    return false;
+  }
+  if (half != this->halfTextures.end())
+    this->setAlphaMod(half->second.texture, alpha);
+  return this->setAlphaMod(texture->second, alpha);
+}
+
+// Set the alpha modulation of a texture.
+bool TextureManager::setAlphaMod(
+  SDL_Texture *texture, Uint8 alpha)
+{
+  // The known state of the texture.
+  TextureState &state = this->getTextureState(texture);
+  if (state.alpha == alpha)
+    return true;
+  if (SDL_SetTextureAlphaMod(texture, alpha) < 0)
+  {
+    SDL_LogError(SDL_LOG_CATEGORY_ERROR,
+      "Can't modify a texture: %s.\n", SDL_GetError());
+    return false;
+  }
+  state.alpha = alpha;
+  // The premultiplied colors are faded by the color mod.
+  if (state.blendMode == premultipliedBlendMode())
+    return this->sendColorMod(texture, state);
+  return true;
+}
+
+// Set the blend mode of a texture.
+bool TextureManager::setBlendMode(
+  const string &name, SDL_BlendMode mode)
+{
+  // The texture to modify.
+  auto texture = this->textures.find(name);
+  // The half resolution variant.
+  auto half = this->halfTextures.find(name);
+  if (texture == this->textures.end())
+  {
+    SDL_LogError(SDL_LOG_CATEGORY_ERROR,
+      "Can't modify a texture: The texture doesn't "
+      "exist.\n");
+    return false;
+  }
+  if (half != this->halfTextures.end())
+    this->setBlendMode(half->second.texture, mode);
+  return this->setBlendMode(texture->second, mode);
+}
+
+// Set the blend mode of a texture.
+bool TextureManager::setBlendMode(
+  SDL_Texture *texture, SDL_BlendMode mode)
+{
+  // The known state of the texture.
+  TextureState &state = this->getTextureState(texture);
+  if (state.blendMode == mode)
+    return true;
+  if (SDL_SetTextureBlendMode(texture, mode) < 0)
+  {
+    SDL_LogError(SDL_LOG_CATEGORY_ERROR,
+      "Can't modify a texture: %s.\n", SDL_GetError());
+    return false;
+  }
+  state.blendMode = mode;
+  // The color mod depends on the alpha if premultiplied.
+  if (state.alpha != 255)
+    return this->sendColorMod(texture, state);
+  return true;
+}
+
+// Get the blend mode of a texture.
+SDL_BlendMode TextureManager::getBlendMode(
+  SDL_Texture *texture)
+{
+  return this->getTextureState(texture).blendMode;
+}
+
+// Set the color to draw primitives.
+bool TextureManager::setDrawColor(const SDL_Color &color)
+{
+  // The known draw color.
+  SDL_Color &current = this->renderState.drawColor;
+  if (this->renderState.drawColorKnown &&
+      current.r == color.r && current.g == color.g &&
+      current.b == color.b && current.a == color.a)
+    return true;
+  if (SDL_SetRenderDrawColor(theGame.getRenderer(), color.r,
+        color.g, color.b, color.a) < 0)
+  {
+    SDL_LogError(SDL_LOG_CATEGORY_ERROR,
+      "Can't set the draw color: %s.\n", SDL_GetError());
+    return false;
+  }
+  current                          = color;
+  this->renderState.drawColorKnown = true;
+  return true;
+}
+
+// Set the clip area of the renderer.
+bool TextureManager::setClipRect(const SDL_Rect *area)
+{
+  // The known clip area.
+  SDL_Rect &current = this->renderState.clipRect;
+  if (this->renderState.clipKnown &&
+      this->renderState.clipEnabled == (area != nullptr) &&
+      (!area || SDL_RectEquals(area, &current)))
+    return true;
+  if (SDL_RenderSetClipRect(
+        theGame.getRenderer(), area) < 0)
+  {
+    SDL_LogError(SDL_LOG_CATEGORY_ERROR,
+      "Can't set the clip area: %s.\n", SDL_GetError());
+    return false;
+  }
+  current = area ? *area : SDL_Rect{0, 0, 0, 0};
+  this->renderState.clipEnabled = area != nullptr;
+  this->renderState.clipKnown   = true;
+  return true;
+}
+
+// Forget the copy of the renderer's state.
+void TextureManager::resetRenderState()
+{
+  this->renderState = RenderState();
+}
+
+// Present the current scene.
+void TextureManager::present()
+{
+  // The current time.
+  Uint64 now = 0;
+  // Indicator to know if the frame is presented.
+  bool presented = true;
+  // Upload the streaming textures not drawn yet.
+  for (auto &stream : this->streamingTextures)
+    if (stream.second.isDirty())
+      this->upload(stream.first,
+        this->textures[stream.first], stream.second);
+  // Draw the commands recorded by the threads.
+  theRenderQueue.flush();
+  for (SDL_Texture *texture : this->retiredTextures)
+    SDL_DestroyTexture(texture);
+  this->retiredTextures.clear();
+  if (this->rasterizer)
+    this->rasterizer->present();
+  // The shapes added after the last texture.
+  theShapeRenderer.flush();
+  // Only the areas that changed are drawn again.
+  if (this->damageTracker)
+  {
+    presented = this->damageTracker->present();
+    // The frames that didn't change are drawn again to
+    // read them.
+    if (!presented && theFrameCapture.isCapturing())
+      presented = this->damageTracker->drawScene();
+    this->resetRenderState();
+  }
+  // The frame is read before it's presented, the recording
+  // counts every frame.
+  theFrameCapture.capture();
+  if (presented)
+    SDL_RenderPresent(theGame.getRenderer());
+  // The browser calls the loop once per frame, and waiting
+  // would block its thread.
+#ifndef __EMSCRIPTEN__
+  else
+    this->damageTracker->wait();
+#endif
+  // The texts are ready for the next frame.
+  this->uploadTexts();
+  // Finish the statistics of the frame.
+  now = SDL_GetPerformanceCounter();
+  if (this->frameStart)
+    this->currentStats.frameTime =
+      static_cast<float>(now - this->frameStart) * 1000 /
+      SDL_GetPerformanceFrequency();
+  this->frameStart         = now;
+  this->currentStats.frame = this->lastStats.frame + 1;
+  this->lastStats          = this->currentStats;
+  this->currentStats       = RenderStats();
+  this->lastCopiedTexture  = nullptr;
+}
+
+// Use the tile rasterizer.
+void TextureManager::setTileRasterizer(bool enable)
+{
+  if (!enable)
+    this->rasterizer.reset();
+  else if (!this->rasterizer)
+    this->rasterizer.reset(new TileRasterizer);
+}
+
+// Query if the tile rasterizer is used.
+bool TextureManager::hasTileRasterizer()
+{
+  return this->rasterizer != nullptr;
+}
+
+// Use the damage mode.
+void TextureManager::setDamageMode(
+  bool enable, const SDL_Color &background)
+{
+  if (!enable)
+    this->damageTracker.reset();
+  else
+  {
+    if (!this->damageTracker)
+      this->damageTracker.reset(new DamageTracker);
+    this->damageTracker->setBackground(background);
+  }
+}
+
+// Query if the damage mode is used.
+bool TextureManager::hasDamageMode()
+{
+  return this->damageTracker != nullptr;
+}
+
+// Mark an area to be drawn again.
+void TextureManager::addDamage(const SDL_Rect *area)
+{
+  if (!this->damageTracker)
+    return;
+  if (area)
+    this->damageTracker->addDamage(*area);
+  else
+    this->damageTracker->addFullDamage();
+}
+
+// Change the font used to render text.
 bool TextureManager::changeFont(
   const string &path, int size)
 {
@@ -761,6 +1324,10 @@ bool TextureManager::changeFontSize(int size)
   {
     if (TTF_SetFontSize(this->font, size) < 0)
       return false;
+    this->fontSize = size;
+    this->fontGeneration++;
+    // The glyphs must be measured again.
+    this->textLayouts.clear();
     return true;
   }
   return false;
@@ -769,21 +1336,64 @@ bool TextureManager::changeFontSize(int size)
 // Destroy and erase a texture.
 void TextureManager::erase(const string &name)
 {
+  // The layer being recorded is the target.
+  if (this->layers.count(name) &&
+      this->layers[name].recording)
+  {
+    SDL_LogError(SDL_LOG_CATEGORY_ERROR,
+      "Can't erase a texture: The layer is being "
+      "recorded.\n");
+    return;
+  }
+  // A text being rasterized isn't loaded later.
+  theTextRasterizer.cancel(name);
   if (this->textures.find(name) != this->textures.cend())
   {
-    SDL_DestroyTexture(this->textures[name]);
+    this->destroyTexture(this->textures[name]);
     this->textures.erase(name);
+    if (this->halfTextures.find(name) !=
+        this->halfTextures.cend())
+    {
+      this->destroyTexture(
+        this->halfTextures[name].texture);
+      this->halfTextures.erase(name);
+    }
+    this->streamingTextures.erase(name);
+    this->layers.erase(name);
+    this->textTextures.erase(name);
+    if (this->imageSources.erase(name))
+      theAssetWatcher.unwatch(AssetType::TEXTURE, name);
+    this->invalidateDependents(name);
+    // A new texture can get the same address.
+    this->textureGeneration++;
+    this->textureGenerations.erase(name);
   }
 }
 
 // Destroy and erase all the textures.
 void TextureManager::clear()
 {
-  for (auto &item : this->textures)
+  if (!this->recordingLayers.empty())
   {
-    SDL_DestroyTexture(item.second);
-    this->textures.erase(item.first);
+    SDL_LogError(SDL_LOG_CATEGORY_ERROR,
+      "Can't erase the textures: A layer is being "
+      "recorded.\n");
+    return;
   }
+  theTextRasterizer.cancelAll();
+  for (auto &item : this->textures)
+    this->destroyTexture(item.second);
+  for (auto &item : this->halfTextures)
+    this->destroyTexture(item.second.texture);
+  this->textures.clear();
+  this->halfTextures.clear();
+  this->streamingTextures.clear();
+  this->layers.clear();
+  this->textTextures.clear();
+  this->imageSources.clear();
+  this->textureGeneration++;
+  this->textureGenerations.clear();
+  theAssetWatcher.unwatchAll(AssetType::TEXTURE);
 }
 
 // Set the text rendering quality.
@@ -799,6 +1409,19 @@ const TextQuality &TextureManager::getTextQuality()
   return this->textRenderingQuality;
 }
 
+// Set the preprocessing of the loaded images.
+void TextureManager::setImageOptions(
+  const ImageOptions &options)
+{
+  this->imageOptions = options;
+}
+
+// Get the preprocessing of the loaded images.
+const ImageOptions &TextureManager::getImageOptions()
+{
+  return this->imageOptions;
+}
+
 // Set the foreground rendering color.
 void TextureManager::setForegroundColor(
   const SDL_Color &color)
@@ -829,20 +1452,635 @@ const SDL_Color &TextureManager::getBackgroundColor()
 const SDL_Texture *TextureManager::getTexture(
   const string &name)
 {
+  this->addDependency(name);
   if (this->textures.find(name) != this->textures.cend())
     return this->textures[name];
   return nullptr;
 }
 
+// Get the font used to render text.
+TTF_Font *TextureManager::getFont()
+{
+  return this->font;
+}
+
+// Get the generation of the font.
+Uint64 TextureManager::getFontGeneration()
+{
+  return this->fontGeneration;
+}
+
 // Get a modifiable texture.
 SDL_Texture *TextureManager::getModifiableTexture(
   const string &name)
 {
+  this->addDependency(name);
   if (this->textures.find(name) != this->textures.cend())
     return this->textures[name];
   return nullptr;
 }
 
+// Get the generation of all the textures with name.
+Uint64 TextureManager::getTextureGeneration()
+{
+  return this->textureGeneration;
+}
+
+// Get the generation of the texture of a name.
+Uint64 TextureManager::getTextureGeneration(
+  const string &name)
+{
+  // The generation of the texture.
+  auto generation = this->textureGenerations.find(name);
+  if (generation == this->textureGenerations.end())
+    return 0;
+  return generation->second;
+}
+
+// Get the statistics of the last frame.
+const RenderStats &TextureManager::getRenderStats()
+{
+  return this->lastStats;
+}
+
+// Count a copy of a texture.
+void TextureManager::countCopy(const SDL_Texture *texture)
+{
+  this->currentStats.copies++;
+  if (texture != this->lastCopiedTexture)
+  {
+    this->currentStats.textureSwitches++;
+    this->lastCopiedTexture = texture;
+  }
+}
+
+// Count draws discarded before reaching the renderer.
+void TextureManager::countCulledDraws(Uint32 count)
+{
+  this->currentStats.culledDraws += count;
+}
+
+// Count the draws hidden by opaque draws.
+void TextureManager::countOccludedDraws(Uint32 count)
+{
+  this->currentStats.occludedDraws += count;
+}
+
+// Query if all the pixels of a texture are opaque.
+bool TextureManager::isOpaque(const SDL_Texture *texture)
+{
+  return this->opaqueTextures.count(texture);
+}
+
+// Create a layer.
+bool TextureManager::createLayer(
+  const string &name, int width, int height)
+{
+  // The texture of the layer.
+  SDL_Texture *layerTexture = nullptr;
+  // If the texture exists, don't create a new one.
+  if (this->textures.find(name) != this->textures.end())
+    return false;
+  if (!SDL_RenderTargetSupported(theGame.getRenderer()))
+  {
+    SDL_LogError(SDL_LOG_CATEGORY_ERROR,
+      "Error creating a layer: The renderer doesn't "
+      "support render targets.\n");
+    return false;
+  }
+  layerTexture = SDL_CreateTexture(theGame.getRenderer(),
+    SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET,
+    width, height);
+  if (!layerTexture)
+  {
+    SDL_ShowSimpleMessageBox(SDL_MESSAGEBOX_ERROR,
+      "Error creating a layer", SDL_GetError(),
+      theGame.getWindow());
+    SDL_LogError(SDL_LOG_CATEGORY_ERROR,
+      "Error creating a layer: %s.\n", SDL_GetError());
+    return false;
+  }
+  this->currentStats.texturesCreated++;
+  // The draws are blended over a transparent layer, so its
+  // colors are premultiplied. The software renderer can't
+  // blend them, and the layer is drawn a bit darker there.
+  if (SDL_SetTextureBlendMode(
+        layerTexture, premultipliedBlendMode()) < 0)
+    SDL_SetTextureBlendMode(
+      layerTexture, SDL_BLENDMODE_BLEND);
+  this->textures[name] = layerTexture;
+  // The layers that missed it must be recorded again.
+  this->invalidateDependents(name);
+  this->markTextureChanged(name);
+  this->layers[name]   = Layer();
+  return true;
+}
+
+// Start recording a layer.
+bool TextureManager::beginLayer(
+  const string &name, Uint64 inputs)
+{
+  // The previous draw color.
+  Uint8 red = 0, green = 0, blue = 0, alpha = 0;
+  // The layer to record.
+  auto layer = this->layers.find(name);
+  if (layer == this->layers.end())
+  {
+    SDL_LogError(SDL_LOG_CATEGORY_ERROR,
+      "Can't record a layer: The layer doesn't exist.\n");
+    return false;
+  }
+  // The layer becomes dirty if its inputs changed.
+  if (layer->second.inputs != inputs)
+  {
+    layer->second.inputs = inputs;
+    layer->second.dirty  = true;
+  }
+  if (!layer->second.dirty)
+    return false;
+  // The shapes added before go to the previous target.
+  theShapeRenderer.flush();
+  // Draw into the layer.
+  // The targets have their own clip area.
+  this->renderState.clipKnown = false;
+  if (SDL_SetRenderTarget(
+        theGame.getRenderer(), this->textures[name]) < 0)
+  {
+    SDL_LogError(SDL_LOG_CATEGORY_ERROR,
+      "Can't record a layer: %s.\n", SDL_GetError());
+    return false;
+  }
+  // Clear the layer with a transparent color.
+  SDL_GetRenderDrawColor(
+    theGame.getRenderer(), &red, &green, &blue, &alpha);
+  SDL_SetRenderDrawColor(theGame.getRenderer(), 0, 0, 0, 0);
+  SDL_RenderClear(theGame.getRenderer());
+  SDL_SetRenderDrawColor(
+    theGame.getRenderer(), red, green, blue, alpha);
+  layer->second.dependencies.clear();
+  layer->second.recording = true;
+  this->recordingLayers.push(name);
+  return true;
+}
+
+// Finish recording a layer.
+void TextureManager::endLayer()
+{
+  // The name of the recorded layer.
+  string name;
+  if (this->recordingLayers.empty())
+    return;
+  // The shapes added inside the layer are drawn in it.
+  theShapeRenderer.flush();
+  name = this->recordingLayers.top();
+  this->recordingLayers.pop();
+  this->layers[name].recording = false;
+  // The rasterizer needs the pixels of the layer.
+  if (this->rasterizer)
+    this->rasterizer->readTarget(this->textures[name]);
+  // Go back to the previous target.
+  this->renderState.clipKnown = false;
+  if (this->recordingLayers.empty())
+    SDL_SetRenderTarget(theGame.getRenderer(), nullptr);
+  else
+    SDL_SetRenderTarget(theGame.getRenderer(),
+      this->textures[this->recordingLayers.top()]);
+  // The layers that draw this one must be recorded again,
+  // and the widgets see new pixels.
+  this->invalidateDependents(name);
+  this->markTextureChanged(name);
+  this->layers[name].dirty = false;
+  if (this->damageTracker)
+    this->damageTracker->changeTexture(
+      this->textures[name]);
+}
+
+// Mark a layer as dirty.
+void TextureManager::markLayerDirty(const string &name)
+{
+  if (this->layers.find(name) != this->layers.cend())
+  {
+    this->layers[name].dirty = true;
+    this->invalidateDependents(name);
+  }
+}
+
+// Mark all the layers as dirty.
+void TextureManager::markLayersDirty()
+{
+  for (auto &layer : this->layers)
+    layer.second.dirty = true;
+}
+
+// Convert a loaded image as requested.
+SDL_Surface *TextureManager::prepareImage(
+  SDL_Surface *image, const ImageOptions &options,
+  bool &premultiplied)
+{
+  // Information of the renderer.
+  SDL_RendererInfo info = {};
+  // Indicator to know if the information was queried.
+  bool queried = false;
+  // The format to convert the image.
+  Uint32 format = 0;
+  // A format supported by the renderer.
+  Uint32 candidate = 0;
+  // The converted image.
+  SDL_Surface *converted = nullptr;
+  // Indicator to know if the image has transparency.
+  bool hasAlpha =
+    image->format->Amask || SDL_HasColorKey(image);
+  // Indicator to know if the image has 32 bits pixels.
+  bool hasWords = image->format->BytesPerPixel == 4 &&
+                  !image->format->palette;
+  premultiplied = false;
+  queried       =
+    SDL_GetRendererInfo(theGame.getRenderer(), &info) == 0;
+  if (!queried)
+    info = {};
+  // Choose the first format of the renderer that keeps the
+  // transparency.
+  for (Uint32 i = 0; i < info.num_texture_formats; i++)
+  {
+    candidate = info.texture_formats[i];
+    if (!SDL_ISPIXELFORMAT_FOURCC(candidate) &&
+        SDL_BYTESPERPIXEL(candidate) == 4 &&
+        (!hasAlpha || SDL_ISPIXELFORMAT_ALPHA(candidate)))
+    {
+      format = candidate;
+      break;
+    }
+  }
+  if (!format)
+    format = hasAlpha ? SDL_PIXELFORMAT_ARGB8888
+                      : SDL_PIXELFORMAT_RGB888;
+  // The other steps need pixels of 32 bits.
+  if ((options.convertToNative &&
+        image->format->format != format) ||
+      (!hasWords && (options.premultiplyAlpha ||
+                      options.halfResolution)))
+  {
+    converted = convertSurface(image, format);
+    SDL_FreeSurface(image);
+    if (!converted)
+      return nullptr;
+    image = converted;
+  }
+  // The software renderer can't blend premultiplied
+  // colors, and an unknown renderer could be software.
+  if (options.premultiplyAlpha && image->format->Amask &&
+      queried && !(info.flags & SDL_RENDERER_SOFTWARE))
+  {
+    for (int y = 0; y < image->h; y++)
+      premultiplyAlpha(
+        reinterpret_cast<Uint32 *>(
+          static_cast<Uint8 *>(image->pixels) +
+          y * image->pitch),
+        image->w, *image->format);
+    premultiplied = true;
+  }
+  return image;
+}
+
+// Choose the half resolution variant of a texture.
+SDL_Texture *TextureManager::selectResolution(
+  const string &name, SDL_Texture *texture,
+  const SDL_Rect *&src, SDL_Rect &halfSrc, float destWidth,
+  float destHeight)
+{
+  if (this->halfTextures.empty())
+    return texture;
+  // The variant of the texture.
+  auto half = this->halfTextures.find(name);
+  if (half == this->halfTextures.end())
+    return texture;
+  // The size of the drawn area.
+  int width  = src ? src->w : half->second.width;
+  int height = src ? src->h : half->second.height;
+  if (destWidth * 2 > width || destHeight * 2 > height)
+    return texture;
+  if (src)
+  {
+    halfSrc = {
+      src->x / 2, src->y / 2, src->w / 2, src->h / 2};
+    src = &halfSrc;
+  }
+  return half->second.texture;
+}
+
+// Rasterize a text.
+SDL_Surface *TextureManager::rasterizeText(
+  const string &text)
+{
+  this->currentStats.textRasterizations++;
+  return TextRasterizer::rasterizeLine(this->font,
+    text.c_str(), this->textRenderingQuality,
+    this->foregroundTextColor, this->backgroundTextColor);
+}
+
+// Rasterize a laid out text.
+SDL_Surface *TextureManager::rasterizeText(
+  const TextLayout &layout)
+{
+  this->currentStats.textRasterizations++;
+  return TextRasterizer::rasterize(layout,
+    this->textRenderingQuality, this->foregroundTextColor,
+    this->backgroundTextColor);
+}
+
+// Upload the texts rasterized in the background.
+void TextureManager::uploadTexts()
+{
+  // The time when the uploads started.
+  Uint64 start = SDL_GetPerformanceCounter();
+  // The budget in ticks of the performance counter.
+  Uint64 budget = static_cast<Uint64>(
+    this->textUploadBudget) *
+    SDL_GetPerformanceFrequency() / 1000000;
+  // The name of the texture of a text.
+  string name;
+  // A rasterized text.
+  SDL_Surface *loadedText = nullptr;
+  // The text converted into texture.
+  SDL_Texture *convertedText = nullptr;
+  // The previous texture of the text.
+  auto previous = this->textures.end();
+  // Indicator to know if all the pixels are opaque.
+  bool opaque = false;
+  // At least a text is uploaded in every frame.
+  while (theTextRasterizer.take(name, loadedText))
+  {
+    // The errors were logged by the threads.
+    if (!loadedText)
+      continue;
+    opaque        = DPGE::isOpaque(loadedText);
+    convertedText = this->createTexture(loadedText);
+    SDL_FreeSurface(loadedText);
+    if (!convertedText)
+      SDL_LogError(SDL_LOG_CATEGORY_ERROR,
+        "Error creating a texture: %s.\n", SDL_GetError());
+    else
+    {
+      // The shaded texts can hide the draws under them.
+      if (opaque)
+        this->opaqueTextures.insert(convertedText);
+      // Like in a reload, the new texture keeps the
+      // modulation and blend mode of the previous one,
+      // which is shown until now.
+      previous = this->textures.find(name);
+      if (previous != this->textures.end())
+        this->copyTextureState(
+          previous->second, convertedText);
+      this->erase(name);
+      this->textures[name] = convertedText;
+      this->textTextures.insert(name);
+      this->invalidateDependents(name);
+      this->markTextureChanged(name);
+    }
+    if (SDL_GetPerformanceCounter() - start >= budget)
+      break;
+  }
+}
+
+// Copy a texture with integer coordinates.
+bool TextureManager::copy(SDL_Texture *texture,
+  const SDL_Rect *src, const SDL_Rect *dest, double angle,
+  const SDL_Point *center, const SDL_RendererFlip &flip)
+{
+  // The areas with floating precision.
+  SDL_FRect  destF;
+  SDL_FPoint centerF;
+  // The shapes added before are drawn under the texture.
+  theShapeRenderer.flush();
+  if ((!this->rasterizer && !this->damageTracker) ||
+      !this->recordingLayers.empty())
+    return SDL_RenderCopyEx(theGame.getRenderer(), texture,
+             src, dest, angle, center, flip) == 0;
+  if (dest)
+    destF = {static_cast<float>(dest->x),
+      static_cast<float>(dest->y),
+      static_cast<float>(dest->w),
+      static_cast<float>(dest->h)};
+  if (center)
+    centerF = {static_cast<float>(center->x),
+      static_cast<float>(center->y)};
+  return this->copy(texture, src, dest ? &destF : nullptr,
+    angle, center ? &centerF : nullptr, flip);
+}
+
+// Get the layout of a wrapped text.
+const TextLayout &TextureManager::layOutText(
+  const string &text, Uint32 width)
+{
+  // The layout of the text.
+  auto layout = this->textLayouts.begin();
+  for (; layout != this->textLayouts.end(); layout++)
+    if (layout->getFont() == this->font &&
+        layout->getWrapWidth() == width &&
+        layout->getText() == text)
+      break;
+  // The least recently used layout is laid out again.
+  if (layout == this->textLayouts.end())
+  {
+    if (this->textLayouts.size() < textLayoutCount)
+      this->textLayouts.emplace_back();
+    layout = prev(this->textLayouts.end());
+    layout->setFont(this->font);
+    layout->setWrapWidth(width);
+    layout->setText(text);
+  }
+  this->textLayouts.splice(this->textLayouts.begin(),
+    this->textLayouts, layout);
+  return *layout;
+}
+
+// Composite the copies recorded by the tile rasterizer.
+void TextureManager::flushRasterizer()
+{
+  // The layers are recorded with the renderer.
+  if (this->rasterizer && this->recordingLayers.empty())
+    this->rasterizer->present();
+}
+
+// Create a texture from a surface.
+SDL_Texture *TextureManager::createTexture(
+  SDL_Surface *surface)
+{
+  // The created texture.
+  SDL_Texture *texture = SDL_CreateTextureFromSurface(
+    theGame.getRenderer(), surface);
+  if (texture)
+    this->currentStats.texturesCreated++;
+  if (texture && this->rasterizer)
+    this->rasterizer->addTexture(texture, surface);
+  return texture;
+}
+
+// Destroy a texture.
+void TextureManager::destroyTexture(SDL_Texture *texture)
+{
+  if (this->rasterizer)
+    this->rasterizer->removeTexture(texture);
+  this->opaqueTextures.erase(texture);
+  this->textureStates.erase(texture);
+  // A texture drawn in the frame is kept until it's
+  // presented, and its queued commands are skipped.
+  theRenderQueue.forget(texture);
+  if (!this->damageTracker ||
+      !this->damageTracker->keepTexture(texture))
+    this->retiredTextures.push_back(texture);
+  this->currentStats.texturesDestroyed++;
+  if (texture == this->lastCopiedTexture)
+    this->lastCopiedTexture = nullptr;
+}
+
+// Upload the dirty areas of a streaming texture.
+void TextureManager::upload(const string &name,
+  SDL_Texture *texture, StreamingTexture &stream)
+{
+  // The pixels of the texture.
+  const Uint32 *pixels = stream.getPixels();
+  // The locked pixels.
+  void *locked = nullptr;
+  int   pitch  = 0;
+  for (const SDL_Rect &area : stream.getDirtyAreas())
+  {
+    if (SDL_LockTexture(
+          texture, &area, &locked, &pitch) < 0)
+    {
+      SDL_LogError(SDL_LOG_CATEGORY_ERROR,
+        "Error uploading a streaming texture: %s.\n",
+        SDL_GetError());
+      break;
+    }
+    for (int y = 0; y < area.h; y++)
+      memcpy(static_cast<Uint8 *>(locked) + y * pitch,
+        pixels + (area.y + y) * stream.getWidth() + area.x,
+        area.w * sizeof(Uint32));
+    SDL_UnlockTexture(texture);
+    if (this->rasterizer)
+      this->rasterizer->updateTexture(texture, pixels,
+        stream.getWidth(), stream.getHeight(), area);
+  }
+  stream.clearDirtyAreas();
+  if (this->damageTracker)
+    this->damageTracker->changeTexture(texture);
+  // The layers that draw the texture must be recorded
+  // again, and the widgets see new pixels.
+  this->invalidateDependents(name);
+  this->markTextureChanged(name);
+}
+
+// Find a texture to render.
+SDL_Texture *TextureManager::findTexture(const string &name)
+{
+  // The texture to find.
+  auto texture = this->textures.find(name);
+  // A missing texture can be loaded later.
+  this->addDependency(name);
+  if (texture == this->textures.cend())
+  {
+    SDL_ShowSimpleMessageBox(SDL_MESSAGEBOX_ERROR,
+      "Can't render",
+      "The texture to render doesn't exists.",
+      theGame.getWindow());
+    SDL_LogError(SDL_LOG_CATEGORY_ERROR,
+      "Can't render: The texture "
+      "to render doesn't exists.\n");
+    return nullptr;
+  }
+  // Streaming textures are uploaded before being drawn.
+  if (!this->streamingTextures.empty())
+  {
+    auto stream = this->streamingTextures.find(name);
+    if (stream != this->streamingTextures.end() &&
+        stream->second.isDirty())
+      this->upload(
+        name, texture->second, stream->second);
+  }
+  return texture->second;
+}
+
+// Remember what the recording layer depends on.
+void TextureManager::addDependency(const string &name)
+{
+  if (!this->recordingLayers.empty())
+    this->layers[this->recordingLayers.top()]
+      .dependencies.insert(name);
+}
+
+// Give a new generation to the texture of a name.
+void TextureManager::markTextureChanged(const string &name)
+{
+  this->textureGeneration++;
+  this->textureGenerations[name] = this->textureGeneration;
+}
+
+// Mark as dirty the layers that draw a texture.
+void TextureManager::invalidateDependents(
+  const string &name)
+{
+  for (auto &layer : this->layers)
+    if (!layer.second.dirty &&
+        layer.second.dependencies.count(name))
+    {
+      layer.second.dirty = true;
+      this->invalidateDependents(layer.first);
+    }
+}
+
+// Send the color modulation of a texture to SDL.
+bool TextureManager::sendColorMod(
+  SDL_Texture *texture, const TextureState &state)
+{
+  // The alpha that fades the colors.
+  Uint32 alpha = 255;
+  // SDL only applies the alpha mod to the alpha channel,
+  // but the premultiplied colors must be faded too.
+  if (state.blendMode == premultipliedBlendMode())
+    alpha = state.alpha;
+  if (SDL_SetTextureColorMod(texture,
+        (state.red * alpha + 127) / 255,
+        (state.green * alpha + 127) / 255,
+        (state.blue * alpha + 127) / 255) < 0)
+  {
+    SDL_LogError(SDL_LOG_CATEGORY_ERROR,
+      "Can't modify a texture: %s.\n", SDL_GetError());
+    return false;
+  }
+  return true;
+}
+
+// Give a texture the state of another one.
+void TextureManager::copyTextureState(
+  SDL_Texture *from, SDL_Texture *to)
+{
+  // The state to copy.
+  TextureState state = this->getTextureState(from);
+  // The blend mode goes first, it changes the color mod.
+  this->setBlendMode(to, state.blendMode);
+  this->setAlphaMod(to, state.alpha);
+  this->setColorMod(
+    to, state.red, state.green, state.blue);
+}
+
+// Get the known state of a texture.
+TextureManager::TextureState &
+  TextureManager::getTextureState(SDL_Texture *texture)
+{
+  // The state of the texture.
+  auto state = this->textureStates.find(texture);
+  if (state != this->textureStates.end())
+    return state->second;
+  // The texture was never modified by the setters.
+  TextureState &read = this->textureStates[texture];
+  SDL_GetTextureColorMod(
+    texture, &read.red, &read.green, &read.blue);
+  SDL_GetTextureAlphaMod(texture, &read.alpha);
+  SDL_GetTextureBlendMode(texture, &read.blendMode);
+  return read;
+}
+
 // Get the instance of the class.
 TextureManager &TextureManager::getInstance()
 {
@@ -3,27 +3,25 @@
 /// @brief A class to render textures.
 #ifndef TEXTUREMANAGER_HPP
 #define TEXTUREMANAGER_HPP true
+#include "DamageTracker.hpp"
+#include "ImageProcessing.hpp"
+#include "StreamingTexture.hpp"
+#include "TextLayout.hpp"
+#include "TextRasterizer.hpp"
+#include "TileRasterizer.hpp"
 #include <SDL2/SDL.h>
 #include <SDL2/SDL_ttf.h>
+#include <list>
 #include <map>
+#include <memory>
+#include <set>
+#include <stack>
 #include <string>
+#include <vector>
 
 namespace DPGE
 {
 
-  /// @brief Quality to render text.
-  enum struct TextQuality : unsigned
-  {
-    /// @brief High quality.
-    BLENDED,
-    /// @brief High quality text, with background.
-    LCD,
-    /// @brief Medium text, but with background.
-    SHADED,
-    /// @brief Low quality.
-    SOLID
-  };
-
   /// @brief An structure to hold the information of a
   /// texture.
   struct TextureInfo
@@ -48,6 +46,31 @@ namespace DPGE
     SDL_FRect *dest;
   };
 
+  /// @brief The rendering statistics of a frame.
+  struct RenderStats
+  {
+    /// @brief The number of the frame.
+    Uint64 frame = 0;
+    /// @brief The duration of the frame in miliseconds.
+    float frameTime = 0;
+    /// @brief The textures copied in the renderer.
+    Uint32 copies = 0;
+    /// @brief The times the copied texture changed.
+    Uint32 textureSwitches = 0;
+    /// @brief The texts rasterized.
+    Uint32 textRasterizations = 0;
+    /// @brief The textures created.
+    Uint32 texturesCreated = 0;
+    /// @brief The textures destroyed.
+    Uint32 texturesDestroyed = 0;
+    /// @brief The draws discarded because they weren't
+    /// visible.
+    Uint32 culledDraws = 0;
+    /// @brief The draws discarded because later opaque
+    /// draws covered them.
+    Uint32 occludedDraws = 0;
+  };
+
   /// @brief The texture manager of the game.
   class TextureManager final
   {
@@ -65,6 +88,14 @@ namespace DPGE
     /// @return true in success, false otherwise.
     bool loadFromFile(
       const std::string &name, const std::string &path);
+    /// @brief Load a texture from a file preprocessing the
+    /// image.
+    /// @param name The name or id of the texture.
+    /// @param path The path of the file.
+    /// @param options The preprocessing of the image.
+    /// @return true in success, false otherwise.
+    bool loadFromFile(const std::string &name,
+      const std::string &path, const ImageOptions &options);
     /// @brief Load a texture from a utf-8 text.
     /// @param name The id of the texture.
     /// @param text The text to render.
@@ -79,6 +110,86 @@ namespace DPGE
     /// @return true in success, false otherwise.
     bool loadFromText(const std::string &name,
       const std::string &text, Uint32 width);
+    /// @brief Rasterize a text again in the texture of a
+    /// name, or load it if there isn't.
+    /// @param name The name of the texture.
+    /// @param text The utf-8 text.
+    /// @param width Where the width of the text is saved.
+    /// @param height Where the height of the text is saved.
+    /// @return true in success, false otherwise.
+    ///
+    /// The texture is used again if it was loaded from a
+    /// text and the new one fits in it, at its top left
+    /// corner and transparent around, so draw the area of
+    /// the text. It's replaced by a new one otherwise, with
+    /// the same modulation and blend mode.
+    bool reloadFromText(const std::string &name,
+      const std::string &text, int &width, int &height);
+    /// @brief Create a texture from a laid out text.
+    /// @param name The name of the texture.
+    /// @param layout The layout of the text, rasterized
+    /// with its font and the current quality and colors.
+    /// @return true in success, false otherwise.
+    bool loadFromText(
+      const std::string &name, const TextLayout &layout);
+    /// @brief Rasterize a text in a background thread and
+    /// load it in a texture.
+    /// @param name The name of the texture.
+    /// @param text The text to render.
+    /// @param width The width of text wrap, 0 to wrap only
+    /// at newlines.
+    /// @return true if the text was queued, false if there
+    /// isn't a font.
+    ///
+    /// The text is rasterized with the current font,
+    /// quality and colors, and it's uploaded when a scene
+    /// is presented, within the upload budget. If the
+    /// texture exists, it's shown until it's replaced.
+    bool loadFromTextAsync(const std::string &name,
+      const std::string &text, Uint32 width = 0);
+    /// @brief Set the time to upload the texts rasterized
+    /// in the background in every frame.
+    /// @param microseconds The time, at least a text is
+    /// uploaded in every frame.
+    void setTextUploadBudget(Uint32 microseconds);
+    /// @brief Get the time to upload the texts rasterized
+    /// in the background in every frame.
+    /// @return The time in microseconds.
+    Uint32 getTextUploadBudget() const;
+    /// @brief Create a streaming texture, modified from the
+    /// CPU.
+    /// @param name The name of the texture.
+    /// @param width The width of the texture.
+    /// @param height The height of the texture.
+    /// @return true in success, false otherwise.
+    ///
+    /// Its pixels are kept in memory, and only the areas
+    /// marked as dirty are uploaded before the texture is
+    /// drawn or the scene is presented.
+    bool createStreamingTexture(
+      const std::string &name, int width, int height);
+    /// @brief Get the pixels of a streaming texture.
+    /// @param name The name of the texture.
+    /// @return The pixels, or nullptr if the texture isn't
+    /// a streaming texture.
+    StreamingTexture *getStreamingTexture(
+      const std::string &name);
+    /// @brief Load again a texture from its file, keeping
+    /// its name.
+    /// @param name The name of the texture.
+    /// @return true in success, false if it wasn't loaded
+    /// from a file or the file can't be loaded.
+    ///
+    /// The old texture is kept if the file can't be
+    /// loaded. The new one keeps its modulation and blend
+    /// mode. The layers that draw it are recorded again.
+    bool reload(const std::string &name);
+    /// @brief Open again the font from its file, with the
+    /// current size.
+    /// @return true in success, false otherwise.
+    ///
+    /// The textures created from texts keep the old font.
+    bool reloadFont();
     /// @brief Render a texture.
     /// @param name The id of the texture.
     /// @param src The source area.
@@ -100,6 +211,17 @@ namespace DPGE
     /// @return true in success, false otherwise.
     bool render(const std::string &name,
       const SDL_Rect &src, const SDL_Rect &dest);
+    /// @brief Render a texture found before by its name,
+    /// without looking it up again.
+    /// @param name The name of the texture.
+    /// @param texture The texture of the name, valid while
+    /// the generation of the name doesn't change.
+    /// @param src The source rectangle.
+    /// @param dest The destination rectangle.
+    /// @return true in success, false otherwise.
+    bool render(const std::string &name,
+      SDL_Texture *texture, const SDL_Rect &src,
+      const SDL_Rect &dest);
     /// @brief Render a texture using a destination
     /// rectangle.
     /// @param name The name of the texture.
@@ -181,8 +303,158 @@ namespace DPGE
     /// @return true in success or false otherwise.
     bool renderText(
       const std::string &text, int x, int y, Uint32 width);
+    /// @brief Render a laid out text.
+    /// @param layout The layout of the text, rasterized
+    /// with its font and the current quality and colors.
+    /// @param x The x coordinate.
+    /// @param y The y coordinate.
+    /// @return true in success or false otherwise.
+    bool renderText(const TextLayout &layout, int x, int y);
+    /// @brief Render triangles with a texture.
+    /// @param name The name of the texture, empty to draw
+    /// the triangles without texture.
+    /// @param vertices The vertices of the triangles.
+    /// @param vertexCount The number of vertices.
+    /// @param indices The vertices of every triangle,
+    /// nullptr to take them in order.
+    /// @param indexCount The number of indices.
+    /// @return true in success, false otherwise.
+    ///
+    /// The triangles are always drawn by the renderer, also
+    /// with the tile rasterizer. The color modulation of
+    /// the texture isn't applied, use the color of the
+    /// vertices.
+    bool renderGeometry(const std::string &name,
+      const SDL_Vertex *vertices, int vertexCount,
+      const int *indices, int indexCount);
+    /// @brief Copy a texture in the renderer, or record it
+    /// in the tile rasterizer if it's used.
+    /// @param texture The texture to copy.
+    /// @param src The source area.
+    /// @param dest The destination area.
+    /// @param angle The rotation angle.
+    /// @param center The rotation center of the texture,
+    /// nullptr to set it at the center of the texture.
+    /// @param flip The flip direction.
+    /// @return true in success, false otherwise.
+    bool copy(SDL_Texture *texture, const SDL_Rect *src,
+      const SDL_FRect *dest, double angle = 0,
+      const SDL_FPoint       *center = nullptr,
+      const SDL_RendererFlip &flip   = SDL_FLIP_NONE);
+    /// @brief Set the color modulation of a texture.
+    /// @param name The name of the texture.
+    /// @param red The red modulation.
+    /// @param green The green modulation.
+    /// @param blue The blue modulation.
+    /// @return true in success, false otherwise.
+    ///
+    /// The state setters keep a copy of the state, and only
+    /// the changes are sent to SDL.
+    bool setColorMod(const std::string &name, Uint8 red,
+      Uint8 green, Uint8 blue);
+    /// @brief Set the color modulation of a texture.
+    /// @param texture The texture.
+    /// @param red The red modulation.
+    /// @param green The green modulation.
+    /// @param blue The blue modulation.
+    /// @return true in success, false otherwise.
+    bool setColorMod(SDL_Texture *texture, Uint8 red,
+      Uint8 green, Uint8 blue);
+    /// @brief Set the alpha modulation of a texture.
+    /// @param name The name of the texture.
+    /// @param alpha The alpha modulation.
+    /// @return true in success, false otherwise.
+    ///
+    /// The colors of the premultiplied textures and the
+    /// layers are faded too, through their color mod.
+    bool setAlphaMod(const std::string &name, Uint8 alpha);
+    /// @brief Set the alpha modulation of a texture.
+    /// @param texture The texture.
+    /// @param alpha The alpha modulation.
+    /// @return true in success, false otherwise.
+    bool setAlphaMod(SDL_Texture *texture, Uint8 alpha);
+    /// @brief Set the blend mode of a texture.
+    /// @param name The name of the texture.
+    /// @param mode The blend mode.
+    /// @return true in success, false otherwise.
+    bool setBlendMode(
+      const std::string &name, SDL_BlendMode mode);
+    /// @brief Set the blend mode of a texture.
+    /// @param texture The texture.
+    /// @param mode The blend mode.
+    /// @return true in success, false otherwise.
+    bool setBlendMode(
+      SDL_Texture *texture, SDL_BlendMode mode);
+    /// @brief Get the blend mode of a texture.
+    /// @param texture The texture.
+    /// @return The known blend mode.
+    SDL_BlendMode getBlendMode(SDL_Texture *texture);
+    /// @brief Set the color to draw primitives and clear.
+    /// @param color The color.
+    /// @return true in success, false otherwise.
+    bool setDrawColor(const SDL_Color &color);
+    /// @brief Set the clip area of the renderer.
+    /// @param area The clip area, nullptr to disable it.
+    /// @return true in success, false otherwise.
+    bool setClipRect(const SDL_Rect *area);
+    /// @brief Forget the copy of the renderer's state.
+    ///
+    /// Call it after changing the draw color or the clip
+    /// area without the state setters.
+    void resetRenderState();
     /// @brief Present in the window the scene.
+    ///
+    /// The commands of the render queue are drawn before,
+    /// and the shapes added after the last texture over
+    /// them.
     void present();
+    /// @brief Use the tile rasterizer to draw the textures.
+    /// @param enable true to use it, false to draw with the
+    /// renderer.
+    ///
+    /// The rasterizer draws the textures on the CPU with
+    /// all the cores, which is faster than the software
+    /// renderer. Enable it before loading the textures,
+    /// because it needs a copy of their pixels, the others
+    /// are drawn with the renderer. The recorded copies are
+    /// composited before every draw of the renderer made by
+    /// the texture manager, like the triangles, the shapes
+    /// or those textures, so the order is kept, but every
+    /// composition reads the scene back. The layers are
+    /// recorded with the renderer.
+    void setTileRasterizer(bool enable);
+    /// @brief Query if the tile rasterizer is used.
+    /// @return true if it's used.
+    bool hasTileRasterizer();
+    /// @brief Draw only the areas of the scene that
+    /// changed.
+    /// @param enable true to use the damage mode, false to
+    /// draw all the scene every frame.
+    /// @param background The color of the areas without
+    /// textures.
+    ///
+    /// The draws of a frame are recorded and compared with
+    /// the ones of the previous frame when it's presented.
+    /// Only the areas of the different draws are drawn
+    /// again, and the frame isn't presented if there are
+    /// none, so a static menu barely uses the CPU. The
+    /// scene must be drawn through the texture manager,
+    /// the draws made directly with the renderer are
+    /// covered, and the viewport and the scale of the
+    /// renderer must be the default ones. The tile
+    /// rasterizer isn't used in this mode.
+    void setDamageMode(bool enable,
+      const SDL_Color &background = {0, 0, 0, 255});
+    /// @brief Query if the damage mode is used.
+    /// @return true if it's used.
+    bool hasDamageMode();
+    /// @brief Mark an area to be drawn again in the damage
+    /// mode.
+    /// @param area The area, nullptr for all the window.
+    ///
+    /// Call it after changing the pixels of a texture
+    /// obtained by getModifiableTexture().
+    void addDamage(const SDL_Rect *area);
     /// @brief Change the font used to render text.
     /// @param path The path of the font.
     /// @param size The size of the font in dots.
@@ -193,9 +465,11 @@ namespace DPGE
     /// @return true in success, false otherwise.
     bool changeFontSize(int size);
     /// @brief Erase a texture.
-    /// @param name The id of the texture.
+    /// @param name The id of the texture, not a layer being
+    /// recorded.
     void erase(const std::string &name);
-    /// @brief Delete all the textures.
+    /// @brief Delete all the textures, not while a layer is
+    /// being recorded.
     void clear();
     /// @brief Set the text rendering quality.
     /// @param quality The quality of the text.
@@ -203,6 +477,12 @@ namespace DPGE
     /// @brief Get the text rendering quality.
     /// @return The current text rendering quality.
     const TextQuality &getTextQuality();
+    /// @brief Set the preprocessing of the loaded images.
+    /// @param options The preprocessing of the images.
+    void setImageOptions(const ImageOptions &options);
+    /// @brief Get the preprocessing of the loaded images.
+    /// @return The current preprocessing of the images.
+    const ImageOptions &getImageOptions();
     /// @brief Set the foreground color.
     /// @param color The new foreground color.
     void setForegroundColor(const SDL_Color &color);
@@ -217,11 +497,105 @@ namespace DPGE
     const SDL_Color &getBackgroundColor();
     /// @brief Get a texture.
     /// @param name The name of the texture.
+    ///
+    /// The layer being recorded depends on the texture, and
+    /// is recorded again when it's loaded or changed.
     const SDL_Texture *getTexture(const std::string &name);
+    /// @brief Get the font used to render text.
+    /// @return The font, or nullptr if there is no font.
+    TTF_Font *getFont();
+    /// @brief Get the generation of the font.
+    /// @return A value that changes when the font or its
+    /// size changes.
+    ///
+    /// Unlike the address, it isn't reused by a new font.
+    Uint64 getFontGeneration();
     /// @brief Get a texture to modify it.
     /// @param name The id of the texture.
+    ///
+    /// The layer being recorded depends on the texture.
     SDL_Texture *getModifiableTexture(
       const std::string &name);
+    /// @brief Get the generation of all the textures with
+    /// name.
+    /// @return A value that changes when any of them is
+    /// loaded, replaced, erased or changes its pixels.
+    ///
+    /// The textures obtained by getModifiableTexture() stay
+    /// valid while it doesn't change. Check the generation
+    /// of every name only when it changes.
+    Uint64 getTextureGeneration();
+    /// @brief Get the generation of the texture of a name.
+    /// @param name The name of the texture.
+    /// @return A value that changes when the texture of
+    /// the name is replaced or erased, or when its pixels
+    /// change without replacing it, like after uploading a
+    /// streaming texture or recording a layer. It's 0 if
+    /// there isn't texture.
+    ///
+    /// Unlike the address, it isn't reused by a new
+    /// texture.
+    Uint64 getTextureGeneration(const std::string &name);
+    /// @brief Get the rendering statistics of the last
+    /// presented frame.
+    /// @return The statistics.
+    const RenderStats &getRenderStats();
+    /// @brief Count a copy of a texture made outside the
+    /// texture manager.
+    /// @param texture The copied texture.
+    void countCopy(const SDL_Texture *texture);
+    /// @brief Count draws discarded because they weren't
+    /// visible.
+    /// @param count The number of draws.
+    void countCulledDraws(Uint32 count = 1);
+    /// @brief Count draws discarded because later opaque
+    /// draws covered them.
+    /// @param count The number of draws.
+    void countOccludedDraws(Uint32 count = 1);
+    /// @brief Query if all the pixels of a texture are
+    /// opaque.
+    /// @param texture The texture.
+    /// @return true if the texture was loaded from a file
+    /// without transparent pixels.
+    ///
+    /// The images are scanned when they are loaded.
+    bool isOpaque(const SDL_Texture *texture);
+    /// @brief Create a layer.
+    /// @param name The name of the layer's texture.
+    /// @param width The width of the layer.
+    /// @param height The height of the layer.
+    /// @return true in success, false otherwise.
+    ///
+    /// A layer is a texture where a group of draws is
+    /// recorded once and replayed as a single copy, using
+    /// the render functions with the layer's name. It's
+    /// useful for backgrounds and HUD frames that rarely
+    /// change. Its colors are premultiplied by alpha, so it
+    /// has a premultiplied blend mode.
+    bool createLayer(
+      const std::string &name, int width, int height);
+    /// @brief Start recording a layer if it's dirty.
+    /// @param name The name of the layer.
+    /// @param inputs A value that identifies the inputs of
+    /// the layer, the layer becomes dirty when it changes.
+    /// @return true if the layer must be recorded, false if
+    /// its content is still valid or in error.
+    ///
+    /// If it returns true, every render call draws into
+    /// the layer until endLayer() is called. A layer also
+    /// becomes dirty when a texture drawn in it is erased
+    /// or redrawn.
+    bool beginLayer(
+      const std::string &name, Uint64 inputs = 0);
+    /// @brief Finish recording the current layer.
+    void endLayer();
+    /// @brief Mark a layer as dirty to record it again.
+    /// @param name The name of the layer.
+    void markLayerDirty(const std::string &name);
+    /// @brief Mark all the layers as dirty.
+    ///
+    /// Call it when the renderer's targets are reset.
+    void markLayersDirty();
     /// @brief Get the instance of the class.
     static TextureManager &getInstance();
     /// @brief Copy operator deleted.
@@ -229,18 +603,252 @@ namespace DPGE
       const TextureManager &) = delete;
 
   private:
+    /// @brief The state of a layer.
+    struct Layer
+    {
+      /// @brief Indicator to know if the layer must be
+      /// recorded again.
+      bool dirty = true;
+      /// @brief The value of the inputs of the last
+      /// record.
+      Uint64 inputs = 0;
+      /// @brief The textures drawn in the layer.
+      std::set<std::string> dependencies;
+      /// @brief Indicator to know if the layer is being
+      /// recorded.
+      bool recording = false;
+    };
+    /// @brief The state of a texture known by SDL.
+    struct TextureState
+    {
+      /// @brief The color modulation.
+      Uint8 red, green, blue;
+      /// @brief The alpha modulation.
+      Uint8 alpha;
+      /// @brief The blend mode.
+      SDL_BlendMode blendMode;
+    };
+    /// @brief The state of the renderer known by SDL.
+    struct RenderState
+    {
+      /// @brief The draw color.
+      SDL_Color drawColor = {0, 0, 0, 0};
+      /// @brief The clip area.
+      SDL_Rect clipRect = {0, 0, 0, 0};
+      /// @brief Indicator to know if the clip is enabled.
+      bool clipEnabled = false;
+      /// @brief Indicator to know if the draw color is
+      /// known.
+      bool drawColorKnown = false;
+      /// @brief Indicator to know if the clip is known.
+      bool clipKnown = false;
+    };
+    /// @brief A half resolution variant of a texture.
+    struct HalfTexture
+    {
+      /// @brief The reduced texture.
+      SDL_Texture *texture;
+      /// @brief The width of the full texture.
+      int width;
+      /// @brief The height of the full texture.
+      int height;
+    };
     /// @brief Default constructor.
     TextureManager() = default;
+    /// @brief The file of a texture.
+    struct ImageSource
+    {
+      /// @brief The path of the file.
+      std::string path;
+      /// @brief The preprocessing of the image.
+      ImageOptions options;
+    };
+    /// @brief Load a file in a texture.
+    /// @param name The name of the texture.
+    /// @param path The path of the file.
+    /// @param options The preprocessing of the image.
+    /// @param showErrors true to show the errors in a
+    /// message box.
+    /// @return true in success, false otherwise.
+    bool loadImage(const std::string &name,
+      const std::string &path, const ImageOptions &options,
+      bool showErrors);
+    /// @brief Convert a loaded image as requested.
+    /// @param image The image, it's freed if replaced.
+    /// @param options The preprocessing of the image.
+    /// @param premultiplied Set to true if the colors were
+    /// premultiplied.
+    /// @return The prepared image, or nullptr in error.
+    SDL_Surface *prepareImage(SDL_Surface *image,
+      const ImageOptions &options, bool &premultiplied);
+    /// @brief Choose the half resolution variant of a
+    /// texture if it's drawn at half its size or less.
+    /// @param name The name of the texture.
+    /// @param texture The full texture.
+    /// @param src The source area, it's replaced if the
+    /// variant is chosen.
+    /// @param halfSrc Storage for the reduced source area.
+    /// @param destWidth The width of the destination.
+    /// @param destHeight The height of the destination.
+    /// @return The texture to draw.
+    SDL_Texture *selectResolution(const std::string &name,
+      SDL_Texture *texture, const SDL_Rect *&src,
+      SDL_Rect &halfSrc, float destWidth, float destHeight);
+    /// @brief Rasterize a text with the current quality.
+    /// @param text The text to rasterize.
+    /// @return The rasterized text, or nullptr in error.
+    SDL_Surface *rasterizeText(const std::string &text);
+    /// @brief Rasterize a laid out text with the current
+    /// quality.
+    /// @param layout The layout of the text.
+    /// @return The rasterized text, or nullptr in error.
+    SDL_Surface *rasterizeText(const TextLayout &layout);
+    /// @brief Upload the texts rasterized in the
+    /// background, within the upload budget.
+    void uploadTexts();
+    /// @brief Copy a texture with integer coordinates.
+    /// @param texture The texture to copy.
+    /// @param src The source area.
+    /// @param dest The destination area.
+    /// @param angle The rotation angle.
+    /// @param center The rotation center of the texture.
+    /// @param flip The flip direction.
+    /// @return true in success, false otherwise.
+    bool copy(SDL_Texture *texture, const SDL_Rect *src,
+      const SDL_Rect *dest, double angle = 0,
+      const SDL_Point        *center = nullptr,
+      const SDL_RendererFlip &flip   = SDL_FLIP_NONE);
+    /// @brief Get the layout of a wrapped text with the
+    /// current font.
+    /// @param text The text.
+    /// @param width The width of text wrap.
+    /// @return The layout, kept until other texts are laid
+    /// out.
+    ///
+    /// The layouts of the last texts are kept, so drawing
+    /// several wrapped texts every frame doesn't measure
+    /// them again.
+    const TextLayout &layOutText(
+      const std::string &text, Uint32 width);
+    /// @brief Composite the copies recorded by the tile
+    /// rasterizer before drawing with the renderer, so the
+    /// order of the draws is kept.
+    void flushRasterizer();
+    /// @brief Create a texture from a surface.
+    /// @param surface The surface to convert.
+    /// @return The texture, or nullptr in error.
+    SDL_Texture *createTexture(SDL_Surface *surface);
+    /// @brief Destroy a texture.
+    /// @param texture The texture to destroy.
+    void destroyTexture(SDL_Texture *texture);
+    /// @brief Upload the dirty areas of a streaming
+    /// texture.
+    /// @param name The name of the texture.
+    /// @param texture The texture.
+    /// @param stream The pixels of the texture.
+    void upload(const std::string &name,
+      SDL_Texture *texture, StreamingTexture &stream);
+    /// @brief Find a texture to render.
+    /// @param name The name of the texture.
+    /// @return The texture, or nullptr in error.
+    SDL_Texture *findTexture(const std::string &name);
+    /// @brief Remember that the layer being recorded draws
+    /// a texture, even if it doesn't exist yet.
+    /// @param name The name of the texture.
+    void addDependency(const std::string &name);
+    /// @brief Give a new generation to the texture of a
+    /// name.
+    /// @param name The name of the texture.
+    void markTextureChanged(const std::string &name);
+    /// @brief Mark as dirty the layers that draw a texture.
+    /// @param name The name of the texture.
+    void invalidateDependents(const std::string &name);
+    /// @brief Send the color modulation of a texture to
+    /// SDL, faded by the alpha modulation if the texture is
+    /// premultiplied.
+    /// @param texture The texture.
+    /// @param state The state of the texture.
+    /// @return true in success, false otherwise.
+    bool sendColorMod(
+      SDL_Texture *texture, const TextureState &state);
+    /// @brief Get the known state of a texture, reading it
+    /// from SDL the first time.
+    /// @param texture The texture.
+    /// @return The state of the texture.
+    TextureState &getTextureState(SDL_Texture *texture);
+    /// @brief Give a texture the modulation and blend mode
+    /// of another one.
+    /// @param from The texture to copy the state from.
+    /// @param to The texture to modify.
+    void copyTextureState(
+      SDL_Texture *from, SDL_Texture *to);
     /// @brief The textures.
     std::map<const std::string, SDL_Texture *> textures;
+    /// @brief The half resolution variants of the
+    /// textures.
+    std::map<const std::string, HalfTexture> halfTextures;
+    /// @brief The files of the textures loaded from files.
+    std::map<const std::string, ImageSource> imageSources;
+    /// @brief The pixels of the streaming textures.
+    std::map<const std::string, StreamingTexture>
+      streamingTextures;
+    /// @brief The state of the textures set by the state
+    /// setters.
+    std::map<const SDL_Texture *, TextureState>
+      textureStates;
+    /// @brief The state of the renderer.
+    RenderState renderState;
+    /// @brief The textures without transparent pixels.
+    std::set<const SDL_Texture *> opaqueTextures;
+    /// @brief The names of the textures of texts.
+    std::set<std::string> textTextures;
+    /// @brief The textures destroyed in the frame, kept
+    /// until the render queue is flushed.
+    std::vector<SDL_Texture *> retiredTextures;
+    /// @brief The layers.
+    std::map<const std::string, Layer> layers;
+    /// @brief The layers being recorded.
+    std::stack<std::string> recordingLayers;
+    /// @brief The statistics of the current frame.
+    RenderStats currentStats;
+    /// @brief The statistics of the last frame.
+    RenderStats lastStats;
+    /// @brief The start time of the current frame.
+    Uint64 frameStart = 0;
+    /// @brief The last copied texture.
+    const SDL_Texture *lastCopiedTexture = nullptr;
+    /// @brief The number of destroyed textures.
+    Uint64 textureGeneration = 0;
+    /// @brief The generations of the textures by name.
+    std::map<std::string, Uint64> textureGenerations;
     /// @brief The font to render text.
     TTF_Font *font = nullptr;
+    /// @brief The path of the font.
+    std::string fontPath;
+    /// @brief The size of the font in points.
+    int fontSize = 0;
+    /// @brief The number of changes of the font.
+    Uint64 fontGeneration = 0;
+    /// @brief The number of wrapped texts kept laid out.
+    static constexpr size_t textLayoutCount = 16;
+    /// @brief The layouts of the last wrapped texts, the
+    /// most recently used first.
+    std::list<TextLayout> textLayouts;
+    /// @brief The microseconds to upload texts in a frame.
+    Uint32 textUploadBudget = 2000;
     /// @brief Current rendering text quality.
     TextQuality textRenderingQuality = TextQuality::SOLID;
     /// @brief Foreground text color.
     SDL_Color foregroundTextColor = {0, 0, 0, 255};
     /// @brief Background text color.
     SDL_Color backgroundTextColor = {255, 255, 255, 255};
+    /// @brief The preprocessing of the loaded images.
+    ImageOptions imageOptions;
+    /// @brief The tile rasterizer, if it's used.
+    std::unique_ptr<TileRasterizer> rasterizer;
+    /// @brief The damage tracker, if the damage mode is
+    /// used.
+    std::unique_ptr<DamageTracker> damageTracker;
   };
 
   /// @brief The texture manager instance.
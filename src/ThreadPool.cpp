@@ -0,0 +1,113 @@
+// File: ThreadPool.cpp
+// Author: Duilio Pérez
+// Implementation of the thread pool.
+#include "ThreadPool.hpp"
+#include <SDL2/SDL.h>
+using namespace DPGE;
+using namespace std;
+
+// Define the instance of the thread pool.
+ThreadPool &DPGE::theThreadPool = ThreadPool::getInstance();
+
+// Stop the threads.
+ThreadPool::~ThreadPool()
+{
+  {
+    lock_guard<mutex> lock(this->stateMutex);
+    this->stopping = true;
+  }
+  this->wake.notify_all();
+  for (thread &worker : this->workers)
+    worker.join();
+}
+
+// Run the iterations of a loop in parallel.
+void ThreadPool::run(int count, Task task, void *data)
+{
+  // Only one loop runs at time.
+  lock_guard<mutex> runLock(this->runMutex);
+  if (count <= 0)
+    return;
+  this->start();
+  // Small loops don't need to wake the workers.
+  if (this->workers.empty() || count == 1)
+  {
+    for (int i = 0; i < count; i++)
+      task(i, data);
+    return;
+  }
+  {
+    lock_guard<mutex> lock(this->stateMutex);
+    this->task  = task;
+    this->data  = data;
+    this->count = count;
+    this->next  = 0;
+    this->busyWorkers =
+      static_cast<int>(this->workers.size());
+    this->loop++;
+  }
+  this->wake.notify_all();
+  this->execute();
+  // Wait until the last iterations finish.
+  unique_lock<mutex> lock(this->stateMutex);
+  this->finished.wait(
+    lock, [this] { return this->busyWorkers == 0; });
+}
+
+// Get the number of threads of a loop.
+int ThreadPool::getThreadCount()
+{
+  lock_guard<mutex> runLock(this->runMutex);
+  this->start();
+  return static_cast<int>(this->workers.size()) + 1;
+}
+
+// Start the threads.
+void ThreadPool::start()
+{
+  // The number of worker threads.
+  int threads = SDL_GetCPUCount() - 1;
+  if (this->started)
+    return;
+  this->started = true;
+  for (int i = 0; i < threads; i++)
+    this->workers.emplace_back(&ThreadPool::work, this);
+}
+
+// The loop of a worker thread.
+void ThreadPool::work()
+{
+  // The last loop run by the thread.
+  Uint64 lastLoop = 0;
+  unique_lock<mutex> lock(this->stateMutex);
+  while (true)
+  {
+    this->wake.wait(lock, [this, lastLoop] {
+      return this->stopping || this->loop != lastLoop;
+    });
+    if (this->stopping)
+      return;
+    lastLoop = this->loop;
+    lock.unlock();
+    this->execute();
+    lock.lock();
+    if (--this->busyWorkers == 0)
+      this->finished.notify_one();
+  }
+}
+
+// Run iterations until all are taken.
+void ThreadPool::execute()
+{
+  // The iteration to run.
+  int index = 0;
+  while ((index = this->next.fetch_add(1)) < this->count)
+    this->task(index, this->data);
+}
+
+// Get the instance of the class.
+ThreadPool &ThreadPool::getInstance()
+{
+  static ThreadPool theInstance;
+  return theInstance;
+}
@@ -0,0 +1,95 @@
+/// @file ThreadPool.hpp
+/// @author Duilio Pérez
+/// @brief A pool of threads to split work across cores.
+#ifndef THREADPOOL_HPP
+#define THREADPOOL_HPP true
+#include <SDL2/SDL.h>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace DPGE
+{
+
+  /// @brief A pool of threads that runs the iterations of a
+  /// loop in parallel.
+  ///
+  /// The threads are started the first time the pool is
+  /// used, one less than the cores, because the calling
+  /// thread also works.
+  class ThreadPool final
+  {
+  public:
+    /// @brief A function to run for every iteration.
+    /// @param index The number of the iteration.
+    /// @param data The data given to run().
+    typedef void (*Task)(int index, void *data);
+    /// @brief Copy constructor deleted.
+    ThreadPool(const ThreadPool &) = delete;
+    /// @brief Run the iterations of a loop in parallel.
+    /// @param count The number of iterations.
+    /// @param task The function to run for every iteration.
+    /// @param data The data for the function.
+    ///
+    /// It returns when all the iterations finished. The
+    /// iterations can run in any order, and a task can't
+    /// call this function.
+    void run(int count, Task task, void *data);
+    /// @brief Get the number of threads that work in a
+    /// loop, including the calling thread.
+    /// @return The number of threads.
+    int getThreadCount();
+    /// @brief Get the instance of the class.
+    static ThreadPool &getInstance();
+    /// @brief Copy operator deleted.
+    const ThreadPool &operator=(
+      const ThreadPool &) = delete;
+
+  private:
+    /// @brief Default constructor.
+    ThreadPool() = default;
+    /// @brief Destructor, it stops the threads.
+    ~ThreadPool();
+    /// @brief Start the threads if they aren't running.
+    void start();
+    /// @brief The loop of a worker thread.
+    void work();
+    /// @brief Run iterations until all are taken.
+    void execute();
+    /// @brief The worker threads.
+    std::vector<std::thread> workers;
+    /// @brief Indicator to know if the threads were
+    /// started.
+    bool started = false;
+    /// @brief Mutex to run a single loop at time.
+    std::mutex runMutex;
+    /// @brief Mutex of the state of the loop.
+    std::mutex stateMutex;
+    /// @brief Condition to wake the workers.
+    std::condition_variable wake;
+    /// @brief Condition to know when the workers finished.
+    std::condition_variable finished;
+    /// @brief The function of the current loop.
+    Task task = nullptr;
+    /// @brief The data of the current loop.
+    void *data = nullptr;
+    /// @brief The iterations of the current loop.
+    int count = 0;
+    /// @brief The next iteration to run.
+    std::atomic<int> next{0};
+    /// @brief The workers still running the loop.
+    int busyWorkers = 0;
+    /// @brief The number of the current loop.
+    Uint64 loop = 0;
+    /// @brief Indicator to stop the workers.
+    bool stopping = false;
+  };
+
+  /// @brief The thread pool instance.
+  extern ThreadPool &theThreadPool;
+
+} // namespace DPGE
+
+#endif
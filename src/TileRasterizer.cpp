@@ -0,0 +1,879 @@
+// File: TileRasterizer.cpp
+// Author: Duilio Pérez
+// Implementation of the tile rasterizer.
+#include "TileRasterizer.hpp"
+#include "Game.hpp"
+#include "ImageProcessing.hpp"
+#include "ThreadPool.hpp"
+#include <SDL2/SDL.h>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#if defined(__GNUC__) && defined(__SSE2__)
+#define DPGE_SSE2 true
+#include <immintrin.h>
+#endif
+using namespace DPGE;
+using namespace std;
+
+namespace
+{
+
+  // The blend modes of the copies.
+  enum Blend
+  {
+    BLEND_NONE,
+    BLEND_ALPHA,
+    BLEND_ADD,
+    BLEND_MOD,
+    BLEND_MUL,
+    BLEND_PREMULTIPLIED
+  };
+
+  // The modulation that doesn't change the pixels.
+  constexpr Uint32 noModulation = 0xFFFFFFFF;
+
+  // Get the blend mode of a copy.
+  int getBlend(SDL_BlendMode mode)
+  {
+    // The blend mode of the premultiplied textures.
+    static const SDL_BlendMode premultiplied =
+      SDL_ComposeCustomBlendMode(SDL_BLENDFACTOR_ONE,
+        SDL_BLENDFACTOR_ONE_MINUS_SRC_ALPHA,
+        SDL_BLENDOPERATION_ADD, SDL_BLENDFACTOR_ONE,
+        SDL_BLENDFACTOR_ONE_MINUS_SRC_ALPHA,
+        SDL_BLENDOPERATION_ADD);
+    if (mode == premultiplied)
+      return BLEND_PREMULTIPLIED;
+    switch (mode)
+    {
+    case SDL_BLENDMODE_NONE:
+      return BLEND_NONE;
+    case SDL_BLENDMODE_ADD:
+      return BLEND_ADD;
+    case SDL_BLENDMODE_MOD:
+      return BLEND_MOD;
+    case SDL_BLENDMODE_MUL:
+      return BLEND_MUL;
+    default:
+      return BLEND_ALPHA;
+    }
+  }
+
+  // Divide by 255 rounding to the nearest value, exact for
+  // values up to 255 * 255.
+  inline Uint32 divide255(Uint32 value)
+  {
+    value += 128;
+    return (value + (value >> 8)) >> 8;
+  }
+
+  // Multiply the channels of two pixels.
+  inline Uint32 modulate(Uint32 pixel, Uint32 modulation)
+  {
+    // The modulated pixel.
+    Uint32 result = 0;
+    for (int shift = 0; shift < 32; shift += 8)
+      result |= divide255((pixel >> shift & 0xFF) *
+                          (modulation >> shift & 0xFF))
+                << shift;
+    return result;
+  }
+
+  // Blend a pixel like the renderers of SDL2.
+  inline Uint32 blendPixel(
+    Uint32 dest, Uint32 src, Uint32 modulation, int blend)
+  {
+    // The blended pixel.
+    Uint32 result = 0;
+    // The channels of the pixels.
+    Uint32 s = 0, d = 0;
+    // The alpha of the source and its complement.
+    Uint32 alpha = 0, inverse = 0;
+    if (modulation != noModulation)
+      src = modulate(src, modulation);
+    alpha   = src >> 24;
+    inverse = 255 - alpha;
+    if (blend == BLEND_NONE)
+      return src;
+    // The color and the alpha blend in different ways.
+    for (int shift = 0; shift < 32; shift += 8)
+    {
+      s = src >> shift & 0xFF;
+      d = dest >> shift & 0xFF;
+      if (shift == 24 && blend != BLEND_ALPHA &&
+          blend != BLEND_PREMULTIPLIED)
+        s = d;
+      else if (blend == BLEND_ALPHA)
+        s = divide255((shift == 24 ? 255 : s) * alpha +
+                      d * inverse);
+      else if (blend == BLEND_ADD)
+        s = min(d + divide255(s * alpha), 255u);
+      else if (blend == BLEND_MOD)
+        s = divide255(s * d);
+      else if (blend == BLEND_MUL)
+        s = min(divide255(s * d) + divide255(d * inverse),
+          255u);
+      else
+        s = min(s + divide255(d * inverse), 255u);
+      result |= s << shift;
+    }
+    return result;
+  }
+
+  // Blend pixels one by one.
+  void blendScalar(Uint32 *dest, const Uint32 *src,
+    int count, Uint32 modulation, int blend)
+  {
+    for (int i = 0; i < count; i++)
+      dest[i] =
+        blendPixel(dest[i], src[i], modulation, blend);
+  }
+
+  // Sample a row with the nearest pixel, the position is
+  // in fixed point of 16 bits.
+  void sampleScalar(const Uint32 *row, Sint64 start,
+    Sint64 step, int from, int count, int last, bool flip,
+    Uint32 *samples)
+  {
+    // The pixel to sample.
+    int x = 0;
+    for (int i = from; i < count; i++)
+    {
+      x = static_cast<int>(
+        min<Sint64>((start + i * step) >> 16, last));
+      samples[i] = row[flip ? last - x : x];
+    }
+  }
+
+#ifdef DPGE_SSE2
+
+  // Divide eight values of 16 bits by 255.
+  inline __m128i divide255SSE2(__m128i values)
+  {
+    values = _mm_add_epi16(values, _mm_set1_epi16(128));
+    return _mm_srli_epi16(
+      _mm_add_epi16(values, _mm_srli_epi16(values, 8)), 8);
+  }
+
+  // Blend two pixels unpacked to 16 bits.
+  template <int blend>
+  inline __m128i blendUnpacked(__m128i src, __m128i dest)
+  {
+    // The lanes of the alpha.
+    const __m128i alphaLanes =
+      _mm_set_epi16(255, 0, 0, 0, 255, 0, 0, 0);
+    const __m128i full = _mm_set1_epi16(255);
+    // The alpha of the source and its complement.
+    __m128i alpha = _mm_shufflehi_epi16(
+      _mm_shufflelo_epi16(src, _MM_SHUFFLE(3, 3, 3, 3)),
+      _MM_SHUFFLE(3, 3, 3, 3));
+    __m128i inverse = _mm_sub_epi16(full, alpha);
+    switch (blend)
+    {
+    case BLEND_ALPHA:
+      return divide255SSE2(_mm_add_epi16(
+        _mm_mullo_epi16(
+          _mm_or_si128(src, alphaLanes), alpha),
+        _mm_mullo_epi16(dest, inverse)));
+    case BLEND_ADD:
+      return _mm_min_epi16(
+        _mm_add_epi16(dest,
+          divide255SSE2(_mm_mullo_epi16(
+            _mm_andnot_si128(alphaLanes, src), alpha))),
+        full);
+    case BLEND_PREMULTIPLIED:
+      return _mm_min_epi16(
+        _mm_add_epi16(src,
+          divide255SSE2(_mm_mullo_epi16(dest, inverse))),
+        full);
+    default:
+      return src;
+    }
+  }
+
+  // Blend pixels four by four.
+  template <int blend>
+  int blendSSE2(Uint32 *dest, const Uint32 *src, int count,
+    Uint32 modulation)
+  {
+    const __m128i zero = _mm_setzero_si128();
+    // The modulation unpacked to 16 bits.
+    const __m128i factors = _mm_unpacklo_epi8(
+      _mm_set1_epi32(static_cast<int>(modulation)), zero);
+    // The index of the next pixel.
+    int i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+      __m128i s = _mm_loadu_si128(
+        reinterpret_cast<const __m128i *>(src + i));
+      __m128i d = _mm_loadu_si128(
+        reinterpret_cast<const __m128i *>(dest + i));
+      __m128i low  = _mm_unpacklo_epi8(s, zero);
+      __m128i high = _mm_unpackhi_epi8(s, zero);
+      if (modulation != noModulation)
+      {
+        low = divide255SSE2(_mm_mullo_epi16(low, factors));
+        high =
+          divide255SSE2(_mm_mullo_epi16(high, factors));
+      }
+      low  = blendUnpacked<blend>(
+        low, _mm_unpacklo_epi8(d, zero));
+      high = blendUnpacked<blend>(
+        high, _mm_unpackhi_epi8(d, zero));
+      _mm_storeu_si128(
+        reinterpret_cast<__m128i *>(dest + i),
+        _mm_packus_epi16(low, high));
+    }
+    return i;
+  }
+
+#if defined(__x86_64__) || defined(__i386__)
+#define DPGE_AVX2 true
+
+  // Divide sixteen values of 16 bits by 255.
+  __attribute__((target("avx2"))) inline __m256i
+    divide255AVX2(__m256i values)
+  {
+    values =
+      _mm256_add_epi16(values, _mm256_set1_epi16(128));
+    values = _mm256_add_epi16(
+      values, _mm256_srli_epi16(values, 8));
+    return _mm256_srli_epi16(values, 8);
+  }
+
+  // Blend four pixels unpacked to 16 bits.
+  template <int blend>
+  __attribute__((target("avx2"))) inline __m256i
+    blendUnpackedAVX2(__m256i src, __m256i dest)
+  {
+    // The lanes of the alpha.
+    const __m256i alphaLanes = _mm256_set_epi16(255, 0, 0,
+      0, 255, 0, 0, 0, 255, 0, 0, 0, 255, 0, 0, 0);
+    const __m256i full = _mm256_set1_epi16(255);
+    // The alpha of the source and its complement.
+    __m256i alpha = _mm256_shufflehi_epi16(
+      _mm256_shufflelo_epi16(src, _MM_SHUFFLE(3, 3, 3, 3)),
+      _MM_SHUFFLE(3, 3, 3, 3));
+    __m256i inverse = _mm256_sub_epi16(full, alpha);
+    switch (blend)
+    {
+    case BLEND_ALPHA:
+      return divide255AVX2(_mm256_add_epi16(
+        _mm256_mullo_epi16(
+          _mm256_or_si256(src, alphaLanes), alpha),
+        _mm256_mullo_epi16(dest, inverse)));
+    case BLEND_ADD:
+      return _mm256_min_epi16(
+        _mm256_add_epi16(dest,
+          divide255AVX2(_mm256_mullo_epi16(
+            _mm256_andnot_si256(alphaLanes, src), alpha))),
+        full);
+    case BLEND_PREMULTIPLIED:
+      return _mm256_min_epi16(
+        _mm256_add_epi16(src,
+          divide255AVX2(_mm256_mullo_epi16(dest, inverse))),
+        full);
+    default:
+      return src;
+    }
+  }
+
+  // Blend pixels eight by eight.
+  template <int blend>
+  __attribute__((target("avx2"))) int blendAVX2(
+    Uint32 *dest, const Uint32 *src, int count,
+    Uint32 modulation)
+  {
+    const __m256i zero = _mm256_setzero_si256();
+    // The modulation unpacked to 16 bits.
+    const __m256i factors = _mm256_unpacklo_epi8(
+      _mm256_set1_epi32(static_cast<int>(modulation)),
+      zero);
+    // The index of the next pixel.
+    int i = 0;
+    for (; i + 8 <= count; i += 8)
+    {
+      __m256i s = _mm256_loadu_si256(
+        reinterpret_cast<const __m256i *>(src + i));
+      __m256i d = _mm256_loadu_si256(
+        reinterpret_cast<const __m256i *>(dest + i));
+      __m256i low  = _mm256_unpacklo_epi8(s, zero);
+      __m256i high = _mm256_unpackhi_epi8(s, zero);
+      if (modulation != noModulation)
+      {
+        low =
+          divide255AVX2(_mm256_mullo_epi16(low, factors));
+        high =
+          divide255AVX2(_mm256_mullo_epi16(high, factors));
+      }
+      low  = blendUnpackedAVX2<blend>(
+        low, _mm256_unpacklo_epi8(d, zero));
+      high = blendUnpackedAVX2<blend>(
+        high, _mm256_unpackhi_epi8(d, zero));
+      _mm256_storeu_si256(
+        reinterpret_cast<__m256i *>(dest + i),
+        _mm256_packus_epi16(low, high));
+    }
+    return i;
+  }
+
+  // Sample a row eight pixels at time.
+  __attribute__((target("avx2"))) int sampleAVX2(
+    const Uint32 *row, int start, int step, int count,
+    int last, bool flip, Uint32 *samples)
+  {
+    // The positions of the next eight pixels.
+    __m256i position = _mm256_add_epi32(
+      _mm256_set1_epi32(start),
+      _mm256_mullo_epi32(
+        _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7),
+        _mm256_set1_epi32(step)));
+    const __m256i advance = _mm256_set1_epi32(step * 8);
+    const __m256i limit   = _mm256_set1_epi32(last);
+    // The index of the next pixel.
+    int i = 0;
+    for (; i + 8 <= count; i += 8)
+    {
+      __m256i x = _mm256_min_epi32(
+        _mm256_srli_epi32(position, 16), limit);
+      if (flip)
+        x = _mm256_sub_epi32(limit, x);
+      _mm256_storeu_si256(
+        reinterpret_cast<__m256i *>(samples + i),
+        _mm256_i32gather_epi32(
+          reinterpret_cast<const int *>(row), x, 4));
+      position = _mm256_add_epi32(position, advance);
+    }
+    return i;
+  }
+
+#endif
+#endif
+
+  // Query if the processor supports AVX2.
+  bool useAVX2()
+  {
+#ifdef DPGE_AVX2
+    static const bool hasAVX2 = SDL_HasAVX2();
+    return hasAVX2;
+#else
+    return false;
+#endif
+  }
+
+  // Blend pixels with the vector instructions available.
+  template <int blend>
+  int blendVector(Uint32 *dest, const Uint32 *src,
+    int count, Uint32 modulation)
+  {
+    // The pixels already blended.
+    int done = 0;
+#ifdef DPGE_AVX2
+    if (useAVX2())
+      done = blendAVX2<blend>(dest, src, count, modulation);
+#endif
+#ifdef DPGE_SSE2
+    done += blendSSE2<blend>(
+      dest + done, src + done, count - done, modulation);
+#endif
+    return done;
+  }
+
+  // Blend a row of pixels.
+  void blendRow(Uint32 *dest, const Uint32 *src, int count,
+    Uint32 modulation, int blend)
+  {
+    // The pixels already blended.
+    int done = 0;
+    switch (blend)
+    {
+    case BLEND_NONE:
+      if (modulation == noModulation)
+      {
+        memcpy(dest, src, count * sizeof(Uint32));
+        return;
+      }
+      done = blendVector<BLEND_NONE>(
+        dest, src, count, modulation);
+      break;
+    case BLEND_ALPHA:
+      done = blendVector<BLEND_ALPHA>(
+        dest, src, count, modulation);
+      break;
+    case BLEND_ADD:
+      done = blendVector<BLEND_ADD>(
+        dest, src, count, modulation);
+      break;
+    case BLEND_PREMULTIPLIED:
+      done = blendVector<BLEND_PREMULTIPLIED>(
+        dest, src, count, modulation);
+      break;
+    }
+    blendScalar(dest + done, src + done, count - done,
+      modulation, blend);
+  }
+
+  // Sample a row of a scaled copy.
+  const Uint32 *sampleRow(const Uint32 *row, Sint64 start,
+    Sint64 step, int count, int last, bool flip,
+    Uint32 *samples)
+  {
+    // The pixels already sampled.
+    int done = 0;
+    // Copies without scale use the pixels directly.
+    if (step == 0x10000 && !flip &&
+        (start >> 16) + count - 1 <= last)
+      return row + (start >> 16);
+#ifdef DPGE_AVX2
+    if (useAVX2() && start + count * step < 0x7FFFFFFF)
+      done = sampleAVX2(row, static_cast<int>(start),
+        static_cast<int>(step), count, last, flip, samples);
+#endif
+    sampleScalar(
+      row, start, step, done, count, last, flip, samples);
+    return samples;
+  }
+
+} // namespace
+
+// Destructor.
+TileRasterizer::~TileRasterizer()
+{
+  if (this->frame)
+    SDL_DestroyTexture(this->frame);
+}
+
+// Keep a copy of the pixels of a texture.
+bool TileRasterizer::addTexture(
+  const SDL_Texture *texture, SDL_Surface *surface)
+{
+  // The pixels in the format of the rasterizer.
+  SDL_Surface *converted =
+    convertSurface(surface, SDL_PIXELFORMAT_ARGB8888);
+  // The copy of the pixels.
+  unique_ptr<Image> image(new Image);
+  if (!converted)
+  {
+    SDL_LogError(SDL_LOG_CATEGORY_ERROR,
+      "Error copying the pixels of a texture: %s.\n",
+      SDL_GetError());
+    return false;
+  }
+  image->width  = converted->w;
+  image->height = converted->h;
+  image->pixels.resize(
+    static_cast<size_t>(converted->w) * converted->h);
+  for (int y = 0; y < converted->h; y++)
+    memcpy(image->pixels.data() + y * converted->w,
+      static_cast<Uint8 *>(converted->pixels) +
+        y * converted->pitch,
+      converted->w * sizeof(Uint32));
+  SDL_FreeSurface(converted);
+  this->removeTexture(texture);
+  this->images[texture] = move(image);
+  return true;
+}
+
+// Copy the pixels of the render target.
+bool TileRasterizer::readTarget(const SDL_Texture *texture)
+{
+  // The copy of the pixels.
+  unique_ptr<Image> image(new Image);
+  SDL_QueryTexture(const_cast<SDL_Texture *>(texture),
+    nullptr, nullptr, &image->width, &image->height);
+  image->pixels.resize(
+    static_cast<size_t>(image->width) * image->height);
+  if (SDL_RenderReadPixels(theGame.getRenderer(), nullptr,
+        SDL_PIXELFORMAT_ARGB8888, image->pixels.data(),
+        image->width * sizeof(Uint32)) < 0)
+  {
+    SDL_LogError(SDL_LOG_CATEGORY_ERROR,
+      "Error reading a render target: %s.\n",
+      SDL_GetError());
+    return false;
+  }
+  this->removeTexture(texture);
+  this->images[texture] = move(image);
+  return true;
+}
+
+// Update a part of the pixels of a texture.
+void TileRasterizer::updateTexture(
+  const SDL_Texture *texture, const Uint32 *pixels,
+  int textureWidth, int textureHeight, const SDL_Rect &area)
+{
+  // The copy of the pixels.
+  unique_ptr<Image> &image = this->images[texture];
+  // The pixels read by the recorded copies.
+  unique_ptr<Image> old;
+  // Indicator to know if a recorded copy reads the pixels.
+  bool recorded = false;
+  for (const Command &command : this->commands)
+    if (image && command.image == image.get())
+    {
+      recorded = true;
+      break;
+    }
+  if (!image || image->width != textureWidth ||
+      image->height != textureHeight)
+  {
+    if (recorded)
+      this->released.push_back(move(image));
+    image.reset(new Image);
+    image->width  = textureWidth;
+    image->height = textureHeight;
+    image->pixels.resize(
+      static_cast<size_t>(textureWidth) * textureHeight);
+  }
+  else if (recorded)
+  {
+    // The recorded copies keep the old pixels.
+    old.reset(new Image(*image));
+    swap(old, image);
+    this->released.push_back(move(old));
+  }
+  for (int y = area.y; y < area.y + area.h; y++)
+    memcpy(image->pixels.data() + y * textureWidth + area.x,
+      pixels + y * textureWidth + area.x,
+      area.w * sizeof(Uint32));
+}
+
+// Forget the pixels of a texture.
+void TileRasterizer::removeTexture(
+  const SDL_Texture *texture)
+{
+  // The pixels of the texture.
+  auto image = this->images.find(texture);
+  if (image == this->images.end())
+    return;
+  // The recorded copies may still use the pixels.
+  if (!this->commands.empty())
+    this->released.push_back(move(image->second));
+  this->images.erase(image);
+}
+
+// Record the copy of a texture.
+bool TileRasterizer::copy(SDL_Texture *texture,
+  const SDL_Rect *src, const SDL_FRect *dest, double angle,
+  const SDL_FPoint *center, SDL_RendererFlip flip)
+{
+  // The renderer.
+  SDL_Renderer *renderer = theGame.getRenderer();
+  // The copy to record.
+  Command command;
+  // The area of the renderer where the copy is drawn.
+  SDL_Rect viewport, clip;
+  // The scale of the renderer.
+  float scaleX = 1, scaleY = 1;
+  // The destination area in the viewport.
+  SDL_FRect area;
+  // The modulation of the texture.
+  Uint8 red = 255, green = 255, blue = 255, alpha = 255;
+  // The blend mode of the texture.
+  SDL_BlendMode blendMode = SDL_BLENDMODE_BLEND;
+  // The corners of the copy.
+  float left = 0, top = 0, right = 0, bottom = 0;
+  // The pixels of the texture.
+  auto image = this->images.find(texture);
+  if (image == this->images.end())
+    return false;
+  command.image = image->second.get();
+  command.src   = {
+    0, 0, command.image->width, command.image->height};
+  if (src &&
+      !SDL_IntersectRect(src, &command.src, &command.src))
+    return true;
+  // Move the copy to pixels of the window.
+  SDL_RenderGetViewport(renderer, &viewport);
+  SDL_RenderGetScale(renderer, &scaleX, &scaleY);
+  area = {0, 0, static_cast<float>(viewport.w),
+    static_cast<float>(viewport.h)};
+  if (dest)
+    area = *dest;
+  command.dest = {(viewport.x + area.x) * scaleX,
+    (viewport.y + area.y) * scaleY, area.w * scaleX,
+    area.h * scaleY};
+  if (command.dest.w <= 0 || command.dest.h <= 0)
+    return true;
+  command.center =
+    center ? SDL_FPoint{command.dest.x + center->x * scaleX,
+               command.dest.y + center->y * scaleY}
+           : SDL_FPoint{command.dest.x + command.dest.w / 2,
+               command.dest.y + command.dest.h / 2};
+  angle           = angle * M_PI / 180;
+  command.rotated = fmod(angle, 2 * M_PI) != 0;
+  command.sine    = static_cast<float>(sin(angle));
+  command.cosine  = static_cast<float>(cos(angle));
+  command.flipX   = flip & SDL_FLIP_HORIZONTAL;
+  command.flipY   = flip & SDL_FLIP_VERTICAL;
+  // The area covered by the pixels.
+  if (!command.rotated)
+  {
+    left   = command.dest.x - 0.5f;
+    top    = command.dest.y - 0.5f;
+    right  = command.dest.x + command.dest.w - 0.5f;
+    bottom = command.dest.y + command.dest.h - 0.5f;
+  }
+  else
+  {
+    left = top = INFINITY;
+    right = bottom = -INFINITY;
+    for (int corner = 0; corner < 4; corner++)
+    {
+      float x = command.dest.x - command.center.x +
+                (corner & 1 ? command.dest.w : 0);
+      float y = command.dest.y - command.center.y +
+                (corner & 2 ? command.dest.h : 0);
+      float turnedX = x * command.cosine - y * command.sine;
+      float turnedY = x * command.sine + y * command.cosine;
+      float rotatedX = command.center.x + turnedX;
+      float rotatedY = command.center.y + turnedY;
+      left   = min(left, floor(rotatedX));
+      top    = min(top, floor(rotatedY));
+      right  = max(right, ceil(rotatedX));
+      bottom = max(bottom, ceil(rotatedY));
+    }
+  }
+  command.bounds.x = static_cast<int>(ceil(left));
+  command.bounds.y = static_cast<int>(ceil(top));
+  command.bounds.w =
+    static_cast<int>(ceil(right)) - command.bounds.x;
+  command.bounds.h =
+    static_cast<int>(ceil(bottom)) - command.bounds.y;
+  // Clip the copy with the viewport and the clip area.
+  clip = viewport;
+  if (SDL_RenderIsClipEnabled(renderer))
+  {
+    SDL_RenderGetClipRect(renderer, &clip);
+    clip.x += viewport.x;
+    clip.y += viewport.y;
+    SDL_IntersectRect(&clip, &viewport, &clip);
+  }
+  left   = floor(clip.x * scaleX);
+  top    = floor(clip.y * scaleY);
+  right  = ceil((clip.x + clip.w) * scaleX);
+  bottom = ceil((clip.y + clip.h) * scaleY);
+  clip   = {static_cast<int>(left), static_cast<int>(top),
+      static_cast<int>(right - left),
+      static_cast<int>(bottom - top)};
+  if (!SDL_IntersectRect(
+        &command.bounds, &clip, &command.bounds))
+    return true;
+  SDL_GetTextureColorMod(texture, &red, &green, &blue);
+  SDL_GetTextureAlphaMod(texture, &alpha);
+  SDL_GetTextureBlendMode(texture, &blendMode);
+  command.modulation = static_cast<Uint32>(alpha) << 24 |
+                       red << 16 | green << 8 | blue;
+  command.blend      = getBlend(blendMode);
+  this->commands.push_back(command);
+  return true;
+}
+
+// Composite the recorded copies.
+bool TileRasterizer::present()
+{
+  // The renderer.
+  SDL_Renderer *renderer = theGame.getRenderer();
+  // The state of the renderer, restored at the end.
+  SDL_Rect viewport, clip;
+  float    scaleX = 1, scaleY = 1;
+  bool     clipEnabled = false;
+  // The size of the output.
+  int outputWidth = 0, outputHeight = 0;
+  // The rows of tiles.
+  int rows = 0;
+  // The area of a copy.
+  SDL_Rect bounds;
+  // The screen.
+  SDL_Rect screen = {0, 0, 0, 0};
+  // The locked pixels of the frame.
+  void *framePixels = nullptr;
+  int   pitch       = 0;
+  // The result of the composition.
+  bool success = true;
+  if (this->commands.empty())
+  {
+    this->released.clear();
+    return true;
+  }
+  SDL_GetRendererOutputSize(
+    renderer, &outputWidth, &outputHeight);
+  // Create the frame when the size of the output changes.
+  if (!this->frame || outputWidth != this->width ||
+      outputHeight != this->height)
+  {
+    if (this->frame)
+      SDL_DestroyTexture(this->frame);
+    this->frame = SDL_CreateTexture(renderer,
+      SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STREAMING,
+      outputWidth, outputHeight);
+    if (!this->frame)
+    {
+      SDL_LogError(SDL_LOG_CATEGORY_ERROR,
+        "Error creating the frame of the rasterizer: %s.\n",
+        SDL_GetError());
+      this->commands.clear();
+      this->released.clear();
+      return false;
+    }
+    SDL_SetTextureBlendMode(
+      this->frame, SDL_BLENDMODE_NONE);
+    this->width  = outputWidth;
+    this->height = outputHeight;
+  }
+  this->columns = (this->width + tileSize - 1) / tileSize;
+  rows          = (this->height + tileSize - 1) / tileSize;
+  screen        = {0, 0, this->width, this->height};
+  // Put every copy in the tiles it touches.
+  this->bins.resize(this->columns * rows);
+  for (auto &bin : this->bins)
+    bin.clear();
+  for (size_t i = 0; i < this->commands.size(); i++)
+  {
+    if (!SDL_IntersectRect(
+          &this->commands[i].bounds, &screen, &bounds))
+      continue;
+    for (int y = bounds.y / tileSize;
+         y <= (bounds.y + bounds.h - 1) / tileSize; y++)
+      for (int x = bounds.x / tileSize;
+           x <= (bounds.x + bounds.w - 1) / tileSize; x++)
+        this->bins[y * this->columns + x].push_back(i);
+  }
+  // Work in pixels of the output.
+  SDL_RenderGetViewport(renderer, &viewport);
+  SDL_RenderGetScale(renderer, &scaleX, &scaleY);
+  SDL_RenderGetClipRect(renderer, &clip);
+  clipEnabled = SDL_RenderIsClipEnabled(renderer);
+  SDL_RenderSetScale(renderer, 1, 1);
+  SDL_RenderSetViewport(renderer, nullptr);
+  SDL_RenderSetClipRect(renderer, nullptr);
+  if (SDL_LockTexture(
+        this->frame, nullptr, &framePixels, &pitch) < 0)
+  {
+    SDL_LogError(SDL_LOG_CATEGORY_ERROR,
+      "Error locking the frame of the rasterizer: %s.\n",
+      SDL_GetError());
+    success = false;
+  }
+  else
+  {
+    this->pixels = static_cast<Uint32 *>(framePixels);
+    this->stride = pitch / sizeof(Uint32);
+    // The copies are drawn over the scene of the renderer.
+    if (SDL_RenderReadPixels(renderer, nullptr,
+          SDL_PIXELFORMAT_ARGB8888, framePixels, pitch) < 0)
+      SDL_LogError(SDL_LOG_CATEGORY_ERROR,
+        "Error reading the scene of the renderer: %s.\n",
+        SDL_GetError());
+    theThreadPool.run(
+      this->columns * rows, compositeTile, this);
+    SDL_UnlockTexture(this->frame);
+    this->pixels = nullptr;
+    if (SDL_RenderCopy(
+          renderer, this->frame, nullptr, nullptr) < 0)
+    {
+      SDL_LogError(SDL_LOG_CATEGORY_ERROR,
+        "Error copying the frame of the rasterizer: %s.\n",
+        SDL_GetError());
+      success = false;
+    }
+  }
+  // Restore the state of the renderer.
+  SDL_RenderSetScale(renderer, scaleX, scaleY);
+  SDL_RenderSetViewport(renderer, &viewport);
+  SDL_RenderSetClipRect(
+    renderer, clipEnabled ? &clip : nullptr);
+  this->commands.clear();
+  this->released.clear();
+  return success;
+}
+
+// Composite a tile.
+void TileRasterizer::compositeTile(int index, void *data)
+{
+  // The rasterizer.
+  TileRasterizer *self =
+    static_cast<TileRasterizer *>(data);
+  // The area of the tile.
+  SDL_Rect tile = {index % self->columns * tileSize,
+    index / self->columns * tileSize, tileSize, tileSize};
+  // The part of a copy inside the tile.
+  SDL_Rect area;
+  tile.w = min(tile.w, self->width - tile.x);
+  tile.h = min(tile.h, self->height - tile.y);
+  for (Uint32 command : self->bins[index])
+    if (SDL_IntersectRect(
+          &self->commands[command].bounds, &tile, &area))
+      self->draw(self->commands[command], area);
+}
+
+// Draw a copy in a part of a tile.
+void TileRasterizer::draw(
+  const Command &command, const SDL_Rect &area)
+{
+  // The texture's pixels of the source area.
+  const Uint32 *texels =
+    command.image->pixels.data() +
+    command.src.y * command.image->width + command.src.x;
+  // The scale from the destination to the source.
+  float scaleX = command.src.w / command.dest.w;
+  float scaleY = command.src.h / command.dest.h;
+  // The position in the source of the first pixel, and
+  // the step between pixels, in fixed point.
+  Sint64 start = 0, step = 0;
+  // The sampled pixels of a row.
+  Uint32 samples[tileSize];
+  // The row and the column in the source.
+  int row = 0, column = 0;
+  if (!command.rotated)
+  {
+    step  = static_cast<Sint64>(scaleX * 0x10000);
+    start = static_cast<Sint64>(
+      (area.x + 0.5f - command.dest.x) * scaleX * 0x10000);
+    start = max<Sint64>(start, 0);
+    for (int y = area.y; y < area.y + area.h; y++)
+    {
+      row = static_cast<int>(
+        (y + 0.5f - command.dest.y) * scaleY);
+      row = min(max(row, 0), command.src.h - 1);
+      if (command.flipY)
+        row = command.src.h - 1 - row;
+      blendRow(this->pixels + y * this->stride + area.x,
+        sampleRow(texels + row * command.image->width,
+          start, step, area.w, command.src.w - 1,
+          command.flipX, samples),
+        area.w, command.modulation, command.blend);
+    }
+    return;
+  }
+  // Rotated copies map every pixel to the source.
+  for (int y = area.y; y < area.y + area.h; y++)
+    for (int x = area.x; x < area.x + area.w; x++)
+    {
+      float offsetX = x + 0.5f - command.center.x;
+      float offsetY = y + 0.5f - command.center.y;
+      float localX  = command.center.x - command.dest.x +
+                     offsetX * command.cosine +
+                     offsetY * command.sine;
+      float localY = command.center.y - command.dest.y -
+                     offsetX * command.sine +
+                     offsetY * command.cosine;
+      if (localX < 0 || localY < 0 ||
+          localX >= command.dest.w ||
+          localY >= command.dest.h)
+        continue;
+      column = min(static_cast<int>(localX * scaleX),
+        command.src.w - 1);
+      row    = min(static_cast<int>(localY * scaleY),
+        command.src.h - 1);
+      if (command.flipX)
+        column = command.src.w - 1 - column;
+      if (command.flipY)
+        row = command.src.h - 1 - row;
+      Uint32 &pixel = this->pixels[y * this->stride + x];
+      pixel = blendPixel(pixel,
+        texels[row * command.image->width + column],
+        command.modulation, command.blend);
+    }
+}
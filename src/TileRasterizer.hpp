@@ -0,0 +1,163 @@
+/// @file TileRasterizer.hpp
+/// @author Duilio Pérez
+/// @brief A renderer backend that composites on the CPU.
+#ifndef TILERASTERIZER_HPP
+#define TILERASTERIZER_HPP true
+#include <SDL2/SDL.h>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace DPGE
+{
+
+  /// @brief A backend that composites the texture copies
+  /// on the CPU, splitting the screen in tiles that are
+  /// drawn in parallel.
+  ///
+  /// It's used by the texture manager when there's no GPU,
+  /// because the software renderer of SDL2 uses a single
+  /// thread. It keeps a copy in memory of every texture,
+  /// records the copies during the frame, and composites
+  /// them over the scene drawn directly with the renderer,
+  /// like the clear color, when the frame is presented or
+  /// before the texture manager draws something else with
+  /// the renderer.
+  class TileRasterizer final
+  {
+  public:
+    /// @brief The size in pixels of the tiles.
+    static constexpr int tileSize = 64;
+    /// @brief Default constructor.
+    TileRasterizer() = default;
+    /// @brief Copy constructor deleted.
+    TileRasterizer(const TileRasterizer &) = delete;
+    /// @brief Destructor.
+    ~TileRasterizer();
+    /// @brief Keep a copy of the pixels of a texture.
+    /// @param texture The texture.
+    /// @param surface The pixels of the texture.
+    /// @return true in success, false otherwise.
+    bool addTexture(
+      const SDL_Texture *texture, SDL_Surface *surface);
+    /// @brief Copy the pixels of the current render target
+    /// as the pixels of a texture.
+    /// @param texture The texture set as render target.
+    /// @return true in success, false otherwise.
+    bool readTarget(const SDL_Texture *texture);
+    /// @brief Update a part of the pixels of a texture.
+    /// @param texture The texture.
+    /// @param pixels All the pixels of the texture in
+    /// ARGB8888.
+    /// @param textureWidth The width of the texture.
+    /// @param textureHeight The height of the texture.
+    /// @param area The area to update.
+    ///
+    /// The copies recorded before keep the old pixels.
+    void updateTexture(const SDL_Texture *texture,
+      const Uint32 *pixels, int textureWidth,
+      int textureHeight, const SDL_Rect &area);
+    /// @brief Forget the pixels of a texture.
+    /// @param texture The texture.
+    void removeTexture(const SDL_Texture *texture);
+    /// @brief Record the copy of a texture.
+    /// @param texture The texture to copy.
+    /// @param src The source area, nullptr for all the
+    /// texture.
+    /// @param dest The destination area, nullptr for all
+    /// the viewport.
+    /// @param angle The rotation angle in degrees.
+    /// @param center The rotation center, nullptr for the
+    /// center of the destination.
+    /// @param flip The flip direction.
+    /// @return true if it was recorded, false if there's no
+    /// copy of the pixels of the texture.
+    ///
+    /// The blend mode, the color and the alpha modulation
+    /// of the texture, the viewport, the scale and the clip
+    /// area of the renderer are taken at this point.
+    bool copy(SDL_Texture *texture, const SDL_Rect *src,
+      const SDL_FRect *dest, double angle,
+      const SDL_FPoint *center, SDL_RendererFlip flip);
+    /// @brief Composite the recorded copies in the
+    /// renderer.
+    /// @return true in success, false otherwise.
+    ///
+    /// It's called when the frame is presented, and before
+    /// the draws that can't be recorded, so they are drawn
+    /// over the previous copies.
+    bool present();
+    /// @brief Copy operator deleted.
+    const TileRasterizer &operator=(
+      const TileRasterizer &) = delete;
+
+  private:
+    /// @brief The pixels of a texture, in ARGB8888.
+    struct Image
+    {
+      /// @brief The pixels.
+      std::vector<Uint32> pixels;
+      /// @brief The width of the image.
+      int width = 0;
+      /// @brief The height of the image.
+      int height = 0;
+    };
+    /// @brief A recorded copy.
+    struct Command
+    {
+      /// @brief The pixels to copy.
+      const Image *image;
+      /// @brief The source area.
+      SDL_Rect src;
+      /// @brief The destination area in pixels of the
+      /// window.
+      SDL_FRect dest;
+      /// @brief The area covered by the copy.
+      SDL_Rect bounds;
+      /// @brief The rotation center in pixels of the
+      /// window.
+      SDL_FPoint center;
+      /// @brief The sine and cosine of the rotation.
+      float sine, cosine;
+      /// @brief The color and alpha modulation, in
+      /// ARGB8888.
+      Uint32 modulation;
+      /// @brief The blend mode, see TileRasterizer.cpp.
+      int blend;
+      /// @brief Indicators to know how the copy is drawn.
+      bool rotated, flipX, flipY;
+    };
+    /// @brief Composite a tile, called by the thread pool.
+    /// @param index The number of the tile.
+    /// @param data The rasterizer.
+    static void compositeTile(int index, void *data);
+    /// @brief Draw a copy in a part of a tile.
+    /// @param command The copy to draw.
+    /// @param area The area to draw.
+    void draw(const Command &command, const SDL_Rect &area);
+    /// @brief The pixels of the textures.
+    std::unordered_map<const SDL_Texture *,
+      std::unique_ptr<Image>>
+      images;
+    /// @brief Images forgotten during the frame, kept until
+    /// it's presented.
+    std::vector<std::unique_ptr<Image>> released;
+    /// @brief The recorded copies.
+    std::vector<Command> commands;
+    /// @brief The copies that touch every tile.
+    std::vector<std::vector<Uint32>> bins;
+    /// @brief The streaming texture of the frame.
+    SDL_Texture *frame = nullptr;
+    /// @brief The size of the frame.
+    int width = 0, height = 0;
+    /// @brief The tiles in a row of the frame.
+    int columns = 0;
+    /// @brief The pixels of the frame while compositing.
+    Uint32 *pixels = nullptr;
+    /// @brief The pixels in a row of the frame.
+    int stride = 0;
+  };
+
+} // namespace DPGE
+
+#endif
@@ -14,6 +14,20 @@ namespace DPGE
   public:
     /// @brief Render a widget.
     virtual void render() = 0;
+    /// @brief Set the area of the widget, used by the
+    /// layouts.
+    /// @param widgetArea The area of the widget.
+    virtual void setArea(const SDL_Rect &widgetArea)
+    {
+      (void)widgetArea;
+    }
+    /// @brief Get the version of the content of the widget.
+    /// @return A value that changes when the widget draws
+    /// something different, 0 if it isn't tracked.
+    virtual Uint64 getVersion()
+    {
+      return 0;
+    }
     /// @brief Virtual destructor.
     virtual ~Widget(){};
   };